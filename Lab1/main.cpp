@@ -2,7 +2,9 @@
 ///   IMPORTS SECTION   ///
 ///////////////////////////
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -10,9 +12,16 @@
 #include <random>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 
 ///////////////////////////
 ///   STRUCTS SECTION   ///
@@ -44,6 +53,42 @@ struct SystemState {
     std::vector<long long> initialTotals;
 };
 
+/**
+ * OpRecord: One logged move operation, as observed by the worker that issued it.
+ *
+ * The invocation timestamp is read immediately before calling the move strategy and
+ * the response timestamp immediately after it returns, so the real effect of the move
+ * happened somewhere inside [invokeTs, responseTs].
+ */
+struct OpRecord {
+    // Source and destination warehouse indices
+    int src;
+    int dst;
+
+    // Slice of the owning OpLog::deltas buffer holding this move's (product, quantity) pairs
+    int deltaOffset;
+    int deltaCount;
+
+    // Outcome returned by the move strategy
+    bool success;
+
+    // Timestamp counter readings around the call (see read_timestamp)
+    uint64_t invokeTs;
+    uint64_t responseTs;
+};
+
+/**
+ * OpLog: Per-thread operation history.
+ *
+ * Owned by exactly one worker during the run, so appends need no synchronization.
+ * Both buffers are reserved up front (numOps records, numOps * maxProductsPerMove deltas),
+ * which guarantees that logging never reallocates inside the timed region.
+ */
+struct OpLog {
+    std::vector<OpRecord> records;
+    std::vector<std::pair<int, long long>> deltas;
+};
+
 // Function pointer type for move operations
 using MoveFn = bool(*)(SystemState&, int, int, const std::vector<std::pair<int, long long>>&);
 
@@ -68,11 +113,35 @@ struct WorkerConfig {
 
     // Function pointer to the move strategy to use
     MoveFn moveFunction;
+
+    // Optional operation log owned by this worker (nullptr = logging disabled)
+    OpLog* log;
 };
 
 ///////////////////////////
 ///   HELPERS SECTION   ///
 ///////////////////////////
+/**
+ * Reads a cheap, monotonically increasing timestamp for operation logging.
+ *
+ * Uses the CPU timestamp counter on x86 (fenced so the read is not reordered around
+ * the logged call), and falls back to steady_clock nanoseconds elsewhere. Only the
+ * relative order of readings matters to the linearizability checker, so the unit is irrelevant.
+ *
+ * @return Current timestamp counter value
+ */
+static inline uint64_t read_timestamp() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
 /**
  * Initializes the warehouse inventory system with specified configuration.
  *
@@ -488,7 +557,24 @@ static void worker_thread(WorkerConfig cfg) {
         // Attempt the move operation using the configured strategy.
         // Returns false if source warehouse lacks sufficient inventory,
         // which is expected behavior - just skip and continue.
-        (void)cfg.moveFunction(*cfg.S, src, dst, deltas);
+        if (cfg.log == nullptr) {
+            (void)cfg.moveFunction(*cfg.S, src, dst, deltas);
+        } else {
+            // Logged variant: bracket the call with timestamps and append to the
+            // preallocated per-thread buffers (no locks, no reallocation).
+            OpRecord rec;
+            rec.src = src;
+            rec.dst = dst;
+            rec.deltaOffset = static_cast<int>(cfg.log->deltas.size());
+            rec.deltaCount = static_cast<int>(deltas.size());
+            cfg.log->deltas.insert(cfg.log->deltas.end(), deltas.begin(), deltas.end());
+
+            rec.invokeTs = read_timestamp();
+            rec.success = cfg.moveFunction(*cfg.S, src, dst, deltas);
+            rec.responseTs = read_timestamp();
+
+            cfg.log->records.push_back(rec);
+        }
 
         // Periodic invariant validation (if enabled).
         // Runs inventory check every k operations to detect consistency bugs early
@@ -502,36 +588,265 @@ static void worker_thread(WorkerConfig cfg) {
 }
 
 /**
- * Runs a benchmark with specified move strategy and configuration.
+ * ProjectedOp: A logged move restricted to a single warehouse.
  *
- * @param strategyName  Human-readable name of the strategy
- * @param moveFn        Function pointer to the move strategy
- * @param S             System state (will be reinitialized)
- * @param W             Number of warehouses
- * @param P             Number of products
- * @param perWhPerProd  Initial quantity per product per warehouse
- * @param numThreads    Number of worker threads
- * @param opsPerThread  Operations per thread
- * @param maxProductsPerMove  Maximum products per transaction
- * @param maxDelta      Maximum quantity per product move
- * @param checkEvery    Intermediate check interval (0 = disabled)
+ * A move touches two warehouses, so each warehouse sees it as one of two sequential
+ * operations on its own inventory:
+ * - WITHDRAW on the source: removes all deltas if every quantity is available,
+ *   otherwise fails and leaves the inventory untouched.
+ * - DEPOSIT on the destination: adds all deltas (only recorded for successful moves).
  */
-static void run_benchmark(
-        const char* strategyName,
+struct ProjectedOp {
+    uint64_t invokeTs;
+    uint64_t responseTs;
+    bool withdraw;
+    bool success;
+    const std::pair<int, long long>* deltas;
+    int deltaCount;
+};
+
+/**
+ * Mixes a 64-bit value (splitmix64 finalizer).
+ * Used to build incremental hashes of search states in the linearizability checker.
+ */
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Hash contribution of a single (product, quantity) entry of the warehouse model.
+ */
+static inline uint64_t qty_hash(int product, long long qty) {
+    return mix64((static_cast<uint64_t>(product) << 40) ^ static_cast<uint64_t>(qty));
+}
+
+/**
+ * Applies a projected operation to the sequential warehouse model.
+ *
+ * The operation is only applicable if the model reproduces the logged outcome:
+ * a successful withdraw needs every quantity available, a failed withdraw needs at
+ * least one quantity missing. Deposits always apply.
+ *
+ * @param op         Operation to apply
+ * @param qty        Model inventory (modified in place on success)
+ * @param stateHash  Incremental hash of qty (updated in place on success)
+ * @return true if the operation is consistent with the model state and was applied
+ */
+static bool apply_projected(const ProjectedOp& op, std::vector<long long>& qty, uint64_t& stateHash) {
+    if (op.withdraw) {
+        bool available = true;
+        for (int k = 0; k < op.deltaCount; ++k) {
+            if (qty[op.deltas[k].first] < op.deltas[k].second) {
+                available = false;
+                break;
+            }
+        }
+
+        // The model must agree with the outcome the strategy reported
+        if (available != op.success) return false;
+        if (!op.success) return true;
+    }
+
+    // Withdraw subtracts, deposit adds
+    long long sign = op.withdraw ? -1 : 1;
+    for (int k = 0; k < op.deltaCount; ++k) {
+        int p = op.deltas[k].first;
+        stateHash -= qty_hash(p, qty[p]);
+        qty[p] += sign * op.deltas[k].second;
+        stateHash += qty_hash(p, qty[p]);
+    }
+    return true;
+}
+
+/**
+ * Reverts an operation previously applied with apply_projected.
+ */
+static void undo_projected(const ProjectedOp& op, std::vector<long long>& qty, uint64_t& stateHash) {
+    if (op.withdraw && !op.success) return;
+
+    long long sign = op.withdraw ? 1 : -1;
+    for (int k = 0; k < op.deltaCount; ++k) {
+        int p = op.deltas[k].first;
+        stateHash -= qty_hash(p, qty[p]);
+        qty[p] += sign * op.deltas[k].second;
+        stateHash += qty_hash(p, qty[p]);
+    }
+}
+
+/**
+ * Checks that one warehouse's projected history is linearizable (Wing-Gong search
+ * with Lowe's memoization of visited states).
+ *
+ * Operations are sorted by invocation time. At each step the search may linearize any
+ * pending operation that is "minimal", i.e. invoked before the earliest response among
+ * all pending operations (nothing pending precedes it in real time). Depth-first search
+ * tries minimal operations in invocation order and backtracks on a model mismatch.
+ * Visited (linearized set, model state) pairs are remembered as 64-bit hash pairs so
+ * that each configuration is explored at most once.
+ *
+ * @param ops      Projected history of the warehouse (sorted in place by invocation)
+ * @param initial  Model inventory before the run
+ * @param final    Actual warehouse inventory after the run
+ * @return true if a valid linearization exists and it ends in the observed final state
+ */
+static bool check_warehouse_history(std::vector<ProjectedOp>& ops,
+                                    const std::vector<long long>& initial,
+                                    const std::vector<long long>& final) {
+    std::sort(ops.begin(), ops.end(), [](const ProjectedOp& a, const ProjectedOp& b) {
+        return a.invokeTs < b.invokeTs;
+    });
+
+    const size_t n = ops.size();
+
+    // Sequential model state and its incremental hash
+    std::vector<long long> qty = initial;
+    uint64_t stateHash = 0;
+    for (size_t p = 0; p < qty.size(); ++p) stateHash += qty_hash(static_cast<int>(p), qty[p]);
+
+    // Linearized set, with an xor-hash over per-operation random keys
+    std::vector<char> linearized(n, 0);
+    uint64_t setHash = 0;
+
+    // Visited configurations (set hash, state hash)
+    struct PairHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& k) const {
+            return static_cast<size_t>(k.first ^ mix64(k.second));
+        }
+    };
+    std::unordered_set<std::pair<uint64_t, uint64_t>, PairHash> visited;
+
+    // DFS stack of linearized operation indices
+    std::vector<size_t> stack;
+    stack.reserve(n);
+
+    size_t lo = 0;      // First operation not yet linearized
+    size_t cursor = 0;  // Next candidate to try at the current depth
+
+    while (true) {
+        while (lo < n && linearized[lo]) ++lo;
+        if (lo == n) break;
+
+        // Earliest response among pending operations. Operations are sorted by
+        // invocation, so the scan can stop once invocations pass the running minimum.
+        uint64_t minResponse = UINT64_MAX;
+        size_t scanEnd = lo;
+        while (scanEnd < n && ops[scanEnd].invokeTs <= minResponse) {
+            if (!linearized[scanEnd]) minResponse = std::min(minResponse, ops[scanEnd].responseTs);
+            ++scanEnd;
+        }
+
+        // Try the next minimal operation that keeps the model consistent
+        bool advanced = false;
+        for (size_t i = std::max(lo, cursor); i < scanEnd; ++i) {
+            if (linearized[i] || ops[i].invokeTs > minResponse) continue;
+            if (!apply_projected(ops[i], qty, stateHash)) continue;
+
+            uint64_t nextSet = setHash ^ mix64(i);
+            if (!visited.insert({nextSet, stateHash}).second) {
+                // Configuration already explored from another order
+                undo_projected(ops[i], qty, stateHash);
+                continue;
+            }
+
+            linearized[i] = 1;
+            setHash = nextSet;
+            stack.push_back(i);
+            cursor = 0;
+            advanced = true;
+            break;
+        }
+        if (advanced) continue;
+
+        // Dead end: backtrack and try the next candidate at the previous depth
+        if (stack.empty()) return false;
+        size_t last = stack.back();
+        stack.pop_back();
+        undo_projected(ops[last], qty, stateHash);
+        linearized[last] = 0;
+        setHash ^= mix64(last);
+        lo = std::min(lo, last);
+        cursor = last + 1;
+    }
+
+    // Every linearization of the same operations ends in the same state; it must match reality
+    return qty == final;
+}
+
+/**
+ * Post-hoc linearizability check of a full benchmark run.
+ *
+ * Projects every logged move onto the warehouses it touched and checks each warehouse
+ * history independently against the sequential warehouse model (P-compositionality:
+ * warehouses are independent objects). Warehouses are distributed dynamically over
+ * the available hardware threads.
+ *
+ * Note: moves span two warehouses, so per-warehouse linearizability is the property
+ * verified here; it does not require both halves of a move to share one linearization point.
+ *
+ * @param logs     Per-thread operation logs from the run
+ * @param initial  Per-warehouse model inventory before the run
+ * @param S        System state after the run (source of the observed final inventory)
+ * @return Number of warehouses whose history is not linearizable (0 = PASS)
+ */
+static int check_linearizability(const std::vector<OpLog>& logs,
+                                 const std::vector<std::vector<long long>>& initial,
+                                 const SystemState& S) {
+    const int W = S.numWarehouses;
+
+    // Project all logged moves onto per-warehouse histories
+    std::vector<std::vector<ProjectedOp>> histories(W);
+    for (const OpLog& log : logs) {
+        for (const OpRecord& rec : log.records) {
+            const std::pair<int, long long>* d = log.deltas.data() + rec.deltaOffset;
+            histories[rec.src].push_back({rec.invokeTs, rec.responseTs, true, rec.success, d, rec.deltaCount});
+            if (rec.success) {
+                histories[rec.dst].push_back({rec.invokeTs, rec.responseTs, false, true, d, rec.deltaCount});
+            }
+        }
+    }
+
+    // Observed final inventory of each warehouse
+    std::vector<std::vector<long long>> finals(W, std::vector<long long>(S.numProducts, 0));
+    for (int w = 0; w < W; ++w) {
+        for (const auto& pr : S.warehouses[w]->products) finals[w][pr.first] = pr.second;
+    }
+
+    // Check warehouses in parallel, pulling work from a shared counter
+    std::atomic<int> nextWarehouse(0);
+    std::atomic<int> failures(0);
+    unsigned numCheckers = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned>(W)));
+
+    std::vector<std::thread> checkers;
+    checkers.reserve(numCheckers);
+    for (unsigned t = 0; t < numCheckers; ++t) {
+        checkers.emplace_back([&]() {
+            for (int w = nextWarehouse++; w < W; w = nextWarehouse++) {
+                if (!check_warehouse_history(histories[w], initial[w], finals[w])) ++failures;
+            }
+        });
+    }
+    for (auto& th : checkers) th.join();
+
+    return failures.load();
+}
+
+/**
+ * Runs one batch of workers against S and waits for them to finish.
+ *
+ * @param logs  One operation log per worker, or nullptr to run without logging
+ * @return Wall-clock time of the batch in milliseconds
+ */
+static long long run_workers(
         MoveFn moveFn,
         SystemState& S,
-        int W, int P, long long perWhPerProd,
         int numThreads, int opsPerThread,
         int maxProductsPerMove, int maxDelta,
-        int checkEvery
+        int checkEvery,
+        std::vector<OpLog>* logs
 ) {
-    std::cout << "\n========================================\n";
-    std::cout << "Testing Strategy: " << strategyName << "\n";
-    std::cout << "========================================\n";
-
-    // Reinitialize system for clean test
-    init_system(S, W, P, perWhPerProd);
-
     std::vector<std::thread> threads;
     threads.reserve(numThreads);
 
@@ -546,7 +861,8 @@ static void run_benchmark(
                 .maxDelta = maxDelta,
                 .rngSeed = static_cast<unsigned int>(std::random_device{}() ^ (i * 0x9e3779b9U)),
                 .checkEvery = checkEvery,
-                .moveFunction = moveFn
+                .moveFunction = moveFn,
+                .log = logs != nullptr ? &(*logs)[i] : nullptr
         };
         threads.emplace_back(worker_thread, cfg);
     }
@@ -554,9 +870,49 @@ static void run_benchmark(
     for (auto& th : threads) th.join();
 
     auto t1 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+}
+
+/**
+ * Runs a benchmark with specified move strategy and configuration.
+ *
+ * Throughput is measured on an unlogged run. With checkLinearizability the strategy
+ * is then run a second time with every operation logged (timestamps and delta copies
+ * inside the critical sections), and only that run's history is checked.
+ *
+ * @param strategyName  Human-readable name of the strategy
+ * @param moveFn        Function pointer to the move strategy
+ * @param S             System state (will be reinitialized)
+ * @param W             Number of warehouses
+ * @param P             Number of products
+ * @param perWhPerProd  Initial quantity per product per warehouse
+ * @param numThreads    Number of worker threads
+ * @param opsPerThread  Operations per thread
+ * @param maxProductsPerMove  Maximum products per transaction
+ * @param maxDelta      Maximum quantity per product move
+ * @param checkEvery    Intermediate check interval (0 = disabled)
+ * @param checkLinearizability  Re-run with every operation logged and verify the history
+ */
+static void run_benchmark(
+        const char* strategyName,
+        MoveFn moveFn,
+        SystemState& S,
+        int W, int P, long long perWhPerProd,
+        int numThreads, int opsPerThread,
+        int maxProductsPerMove, int maxDelta,
+        int checkEvery,
+        bool checkLinearizability
+) {
+    std::cout << "\n========================================\n";
+    std::cout << "Testing Strategy: " << strategyName << "\n";
+    std::cout << "========================================\n";
+
+    // Timed run: reinitialize system for clean test, no logging
+    init_system(S, W, P, perWhPerProd);
+    long long ms = run_workers(moveFn, S, numThreads, opsPerThread, maxProductsPerMove, maxDelta,
+                               checkEvery, nullptr);
 
     bool ok = inventory_check(S);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 
     std::cout << "Result: " << (ok ? "PASS" : "FAIL") << " - Inventory invariant "
               << (ok ? "preserved" : "BROKEN") << "\n";
@@ -564,6 +920,39 @@ static void run_benchmark(
     std::cout << "Total operations: " << (numThreads * opsPerThread) << "\n";
     std::cout << "Throughput: " << std::fixed << std::setprecision(2)
               << (numThreads * opsPerThread * 1000.0 / ms) << " ops/sec\n";
+
+    if (!checkLinearizability) return;
+
+    // Logged run on a fresh system; its timing is reported separately
+    init_system(S, W, P, perWhPerProd);
+
+    // Operation logs: one per worker, fully preallocated before the run starts
+    std::vector<OpLog> logs(numThreads);
+    for (OpLog& log : logs) {
+        log.records.reserve(opsPerThread);
+        log.deltas.reserve(static_cast<size_t>(opsPerThread) * maxProductsPerMove);
+    }
+
+    // Snapshot starting inventory for the sequential model
+    std::vector<std::vector<long long>> initialInventory(W, std::vector<long long>(P, 0));
+    for (int w = 0; w < W; ++w) {
+        for (const auto& pr : S.warehouses[w]->products) initialInventory[w][pr.first] = pr.second;
+    }
+
+    long long loggedMs = run_workers(moveFn, S, numThreads, opsPerThread, maxProductsPerMove, maxDelta,
+                                     checkEvery, &logs);
+    bool loggedOk = inventory_check(S);
+
+    auto c0 = std::chrono::high_resolution_clock::now();
+    int badWarehouses = check_linearizability(logs, initialInventory, S);
+    auto c1 = std::chrono::high_resolution_clock::now();
+    auto checkMs = std::chrono::duration_cast<std::chrono::milliseconds>(c1 - c0).count();
+
+    std::cout << "Logged run: " << loggedMs << " ms (not included in throughput), inventory invariant "
+              << (loggedOk ? "preserved" : "BROKEN") << "\n";
+    std::cout << "Linearizability: " << (badWarehouses == 0 ? "PASS" : "FAIL") << " - "
+              << badWarehouses << " of " << W << " warehouse histories rejected"
+              << " (checked in " << checkMs << " ms)\n";
 }
 
 
@@ -604,6 +993,10 @@ int main() {
     int W = 64, P = 1024, perWhPerProd = 500, numThreads = 16, opsPerThread = 100000;
     int maxProductsPerMove = 2, maxDelta = 2, intermediateCheckEvery = 0;
 
+    // Post-hoc verification: re-run each strategy with every operation logged and check
+    // linearizability (the throughput figures come from the unlogged run)
+    bool checkLinearizability = true;
+
     std::cout << "\n========================================\n";
     std::cout << "TEST CONFIGURATION\n";
     std::cout << "========================================\n";
@@ -614,6 +1007,7 @@ int main() {
     std::cout << "Operations per thread: " << opsPerThread << "\n";
     std::cout << "Max products per move: " << maxProductsPerMove << "\n";
     std::cout << "Max quantity per product: " << maxDelta << "\n";
+    std::cout << "Linearizability check: " << (checkLinearizability ? "enabled" : "disabled") << "\n";
 
     SystemState S{};
 
@@ -622,21 +1016,24 @@ int main() {
             "Hybrid Hand-Over-Hand",
             move_products_hybrid,
             S, W, P, perWhPerProd, numThreads, opsPerThread,
-            maxProductsPerMove, maxDelta, intermediateCheckEvery
+            maxProductsPerMove, maxDelta, intermediateCheckEvery,
+            checkLinearizability
     );
 
     run_benchmark(
             "Two-Point Locking",
             move_products_two_point,
             S, W, P, perWhPerProd, numThreads, opsPerThread,
-            maxProductsPerMove, maxDelta, intermediateCheckEvery
+            maxProductsPerMove, maxDelta, intermediateCheckEvery,
+            checkLinearizability
     );
 
     run_benchmark(
         "Hand-Over-Hand (Deadlock Prone)",
         move_products_hand_over,
         S, W, P, perWhPerProd, numThreads, opsPerThread,
-        maxProductsPerMove, maxDelta, intermediateCheckEvery
+        maxProductsPerMove, maxDelta, intermediateCheckEvery,
+            checkLinearizability
     );
 
     std::cout << "\n========================================\n";
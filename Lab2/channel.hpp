@@ -0,0 +1,589 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Typed Bounded Channel — generalization of the Lab 2 SharedData pattern
+ *
+ * - Channel<T, Policy> is a fixed-capacity FIFO between producer and consumer threads.
+ * - The topology (SPSC / MPSC / MPMC) is chosen at compile time by the policy:
+ *     SPSC: ring buffer with cached remote indices, batch operations publish once
+ *     MPSC: Vyukov array queue, CAS-free single consumer
+ *     MPMC: Vyukov array queue, CAS on both ends
+ * - The wait strategy is chosen at compile time as well:
+ *     BLOCKING: sleep immediately (std::atomic::wait)
+ *     SPINNING: never sleep (busy-poll, then yield)
+ *     HYBRID:   poll SPIN_ITERATIONS times, then sleep
+ * - close() replaces the `done` flag: pop() drains what is left and then returns false,
+ *   push() on a closed channel returns false.
+ * - Elements are constructed in place and moved out, so move-only types are supported.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Destructive interference size: keeps indices written by different threads on separate cache lines
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Number of polling iterations before a waiting side falls back to sleeping (HYBRID)
+constexpr int SPIN_ITERATIONS = 256;
+
+/////////////////////
+///   ENUM TYPES  ///
+/////////////////////
+enum class ChannelKind {
+    SPSC = 1, // Single producer, single consumer
+    MPSC = 2, // Multiple producers, single consumer
+    MPMC = 3  // Multiple producers, multiple consumers
+};
+
+enum class WaitMode {
+    BLOCKING = 1, // Sleep as soon as the channel is full/empty
+    SPINNING = 2, // Poll forever (cpu_relax, then yield)
+    HYBRID = 3    // Poll briefly, then sleep
+};
+
+/**
+ * Compile-time channel configuration.
+ */
+template <ChannelKind K, WaitMode W>
+struct ChannelPolicy {
+    static constexpr ChannelKind kind = K;
+    static constexpr WaitMode wait = W;
+};
+
+using SpscBlocking = ChannelPolicy<ChannelKind::SPSC, WaitMode::BLOCKING>;
+using SpscSpinning = ChannelPolicy<ChannelKind::SPSC, WaitMode::SPINNING>;
+using SpscHybrid = ChannelPolicy<ChannelKind::SPSC, WaitMode::HYBRID>;
+using MpscBlocking = ChannelPolicy<ChannelKind::MPSC, WaitMode::BLOCKING>;
+using MpscSpinning = ChannelPolicy<ChannelKind::MPSC, WaitMode::SPINNING>;
+using MpscHybrid = ChannelPolicy<ChannelKind::MPSC, WaitMode::HYBRID>;
+using MpmcBlocking = ChannelPolicy<ChannelKind::MPMC, WaitMode::BLOCKING>;
+using MpmcSpinning = ChannelPolicy<ChannelKind::MPMC, WaitMode::SPINNING>;
+using MpmcHybrid = ChannelPolicy<ChannelKind::MPMC, WaitMode::HYBRID>;
+
+/////////////////////
+///    HELPERS    ///
+/////////////////////
+/**
+ * Spin-wait hint: tells the CPU we are busy-polling (PAUSE on x86).
+ */
+static inline void cpu_relax() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * True if another thread can run while we poll (more than one hardware thread).
+ * Queried once: hardware_concurrency() may be a system call.
+ */
+static inline bool spinning_pays_off() {
+    static const bool multi_core = std::thread::hardware_concurrency() > 1;
+    return multi_core;
+}
+
+/**
+ * WaitPoint: Where one side of a channel sleeps until the other side makes progress.
+ *
+ * Sleepers announce themselves before re-checking their condition, and wakers only
+ * notify when someone announced (Dekker-style: both sides fence between their store
+ * and their load), so the fast path never enters the kernel.
+ *
+ * SingleWaiter: at most one thread ever waits here. The waker then clears the
+ * announcement itself, so one sleep costs at most one notify even if the sleeper
+ * is slow to be rescheduled. Otherwise sleepers are counted.
+ */
+template <WaitMode W, bool SingleWaiter>
+class WaitPoint {
+public:
+    /**
+     * Waits until ready() returns true.
+     * @param ready  Condition re-evaluated after every wake-up (must be cheap)
+     */
+    template <typename Ready>
+    void wait_until(Ready&& ready) {
+        // Spinning phase (SPINNING and HYBRID); pointless on a single hardware thread
+        if constexpr (W != WaitMode::BLOCKING) {
+            const int limit = (W == WaitMode::SPINNING || spinning_pays_off()) ? SPIN_ITERATIONS : 0;
+            for (int spin = 0; spin < limit; ++spin) {
+                if (ready()) return;
+                cpu_relax();
+            }
+            if constexpr (W == WaitMode::SPINNING) {
+                while (!ready()) std::this_thread::yield();
+                return;
+            }
+        }
+
+        // Sleeping phase (BLOCKING and HYBRID)
+        while (!ready()) {
+            const uint32_t observed = seq_.load(std::memory_order_acquire);
+            announce();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) {
+                seq_.wait(observed, std::memory_order_acquire);
+            }
+            retire();
+        }
+    }
+
+    /** Wakes one sleeper, if any announced itself. */
+    void notify_one() {
+        if constexpr (W == WaitMode::SPINNING) return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (claim()) {
+            seq_.fetch_add(1, std::memory_order_release);
+            seq_.notify_one();
+        }
+    }
+
+    /** Wakes every sleeper unconditionally (used by close()). */
+    void notify_all() {
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        seq_.notify_all();
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> sleepers_{0};
+
+    void announce() {
+        if (SingleWaiter) sleepers_.store(1, std::memory_order_relaxed);
+        else sleepers_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void retire() {
+        if (SingleWaiter) sleepers_.store(0, std::memory_order_relaxed);
+        else sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool claim() {
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return false;
+        if (SingleWaiter) return sleepers_.exchange(0, std::memory_order_relaxed) != 0;
+        return true;
+    }
+};
+
+/////////////////////
+///    CHANNEL    ///
+/////////////////////
+/**
+ * Channel: Bounded, typed, closable FIFO.
+ *
+ * @tparam T       Element type (only needs to be move-constructible and move-assignable)
+ * @tparam Policy  ChannelPolicy<kind, wait mode>
+ */
+template <typename T, typename Policy = MpmcHybrid>
+class Channel {
+    static constexpr ChannelKind kind = Policy::kind;
+    static constexpr bool multi_producer = kind != ChannelKind::SPSC;
+    static constexpr bool multi_consumer = kind == ChannelKind::MPMC;
+
+public:
+    /**
+     * Constructor: allocates the channel.
+     * @param min_capacity Requested capacity, rounded up to the next power of two
+     */
+    explicit Channel(size_t min_capacity) {
+        size_t cap = kind == ChannelKind::SPSC ? 1 : 2;
+        while (cap < min_capacity) cap <<= 1;
+        capacity_ = cap;
+        mask_ = cap - 1;
+
+        if constexpr (kind == ChannelKind::SPSC) {
+            slots_.reset(new Slot[cap]);
+        } else {
+            cells_.reset(new Cell[cap]);
+            for (size_t i = 0; i < cap; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    /**
+     * Destructor: destroys elements that were pushed but never popped.
+     */
+    ~Channel() {
+        if constexpr (kind == ChannelKind::SPSC) {
+            size_t tail = tail_.value.load(std::memory_order_relaxed);
+            for (size_t i = head_.value.load(std::memory_order_relaxed); i != tail; ++i) {
+                slots_[i & mask_].get()->~T();
+            }
+        } else {
+            size_t end = enqueue_pos_.value.load(std::memory_order_relaxed);
+            for (size_t i = dequeue_pos_.value.load(std::memory_order_relaxed); i != end; ++i) {
+                Cell& cell = cells_[i & mask_];
+                if (cell.sequence.load(std::memory_order_relaxed) == i + 1) cell.slot.get()->~T();
+            }
+        }
+    }
+
+    /** Effective (power-of-two) capacity. */
+    size_t capacity() const { return capacity_; }
+
+    /** True once close() has been called. */
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    /**
+     * Non-blocking push. The argument is only moved from if the push succeeds.
+     * @return false if the channel is full or closed
+     */
+    template <typename U>
+    bool try_push(U&& value) {
+        if (closed()) return false;
+        if (!enqueue(std::forward<U>(value))) return false;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * Blocking push: waits while the channel is full.
+     * @return false if the channel was closed before the element could be enqueued
+     */
+    template <typename U>
+    bool push(U&& value) {
+        while (true) {
+            if (try_push(std::forward<U>(value))) return true;
+            if (closed()) return false;
+            not_full_.wait_until([&]() { return closed() || has_space(); });
+        }
+    }
+
+    /**
+     * Non-blocking pop.
+     * @return false if the channel is currently empty
+     */
+    bool try_pop(T& out) {
+        if (!dequeue([&](T&& value) { out = std::move(value); })) return false;
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * Blocking pop: waits while the channel is empty and still open.
+     * @return false once the channel is closed and drained
+     */
+    bool pop(T& out) {
+        while (true) {
+            if (try_pop(out)) return true;
+            if (closed()) {
+                // Everything pushed before close() is visible now: one last attempt
+                return try_pop(out);
+            }
+            not_empty_.wait_until([&]() { return closed() || has_data(); });
+        }
+    }
+
+    /**
+     * Blocking batch push: moves count elements from first, in order.
+     * SPSC publishes each contiguous run of free slots with a single index store.
+     * @return Number of elements pushed (less than count only if the channel was closed)
+     */
+    template <typename InputIt>
+    size_t push_batch(InputIt first, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count) {
+            if (closed()) break;
+
+            size_t n = 0;
+            if constexpr (kind == ChannelKind::SPSC) {
+                const size_t tail = tail_.value.load(std::memory_order_relaxed);
+                if (capacity_ - (tail - tail_.cached) < count - pushed) {
+                    tail_.cached = head_.value.load(std::memory_order_acquire);
+                }
+                n = std::min(count - pushed, capacity_ - (tail - tail_.cached));
+                for (size_t i = 0; i < n; ++i, ++first) {
+                    new (slots_[(tail + i) & mask_].raw) T(std::move(*first));
+                }
+                if (n > 0) tail_.value.store(tail + n, std::memory_order_release);
+            } else {
+                while (pushed + n < count && enqueue(std::move(*first))) {
+                    ++first;
+                    ++n;
+                }
+            }
+
+            if (n > 0) {
+                pushed += n;
+                not_empty_.notify_one();
+            } else {
+                not_full_.wait_until([&]() { return closed() || has_space(); });
+            }
+        }
+        return pushed;
+    }
+
+    /**
+     * Blocking batch pop: waits for at least one element, then moves up to max_count
+     * available elements to out.
+     * @return Number of elements popped; 0 once the channel is closed and drained
+     */
+    template <typename OutputIt>
+    size_t pop_batch(OutputIt out, size_t max_count) {
+        while (true) {
+            size_t n = 0;
+            if constexpr (kind == ChannelKind::SPSC) {
+                const size_t head = head_.value.load(std::memory_order_relaxed);
+                if (head == head_.cached) {
+                    head_.cached = tail_.value.load(std::memory_order_acquire);
+                }
+                n = std::min(max_count, head_.cached - head);
+                for (size_t i = 0; i < n; ++i, ++out) {
+                    T* elem = slots_[(head + i) & mask_].get();
+                    *out = std::move(*elem);
+                    elem->~T();
+                }
+                if (n > 0) head_.value.store(head + n, std::memory_order_release);
+            } else {
+                auto sink = [&](T&& value) {
+                    *out = std::move(value);
+                    ++out;
+                };
+                while (n < max_count && dequeue(sink)) {
+                    ++n;
+                }
+            }
+
+            if (n > 0) {
+                not_full_.notify_one();
+                return n;
+            }
+            if (closed() && !has_data()) return 0;
+            not_empty_.wait_until([&]() { return closed() || has_data(); });
+        }
+    }
+
+    /**
+     * SPSC only: hands up to max_count available elements to fn in place, without
+     * moving them out. fn(const T* data, size_t len) is called once, or twice when the
+     * readable region wraps around; the slots are released with a single index store.
+     * @return Number of elements consumed; 0 once the channel is closed and drained
+     */
+    template <typename Fn>
+    size_t consume(Fn&& fn, size_t max_count) {
+        static_assert(kind == ChannelKind::SPSC, "consume() requires an SPSC channel");
+
+        while (true) {
+            const size_t head = head_.value.load(std::memory_order_relaxed);
+            if (head == head_.cached) {
+                head_.cached = tail_.value.load(std::memory_order_acquire);
+            }
+
+            const size_t count = std::min(max_count, head_.cached - head);
+            if (count > 0) {
+                const size_t idx = head & mask_;
+                const size_t first = std::min(count, capacity_ - idx);
+                fn(slots_[idx].get(), first);
+                if (count > first) {
+                    fn(slots_[0].get(), count - first);
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    slots_[(head + i) & mask_].get()->~T();
+                }
+
+                head_.value.store(head + count, std::memory_order_release);
+                not_full_.notify_one();
+                return count;
+            }
+
+            if (closed() && !has_data()) return 0;
+            not_empty_.wait_until([&]() { return closed() || has_data(); });
+        }
+    }
+
+    /**
+     * Approximate number of buffered elements (exact when called by the only producer
+     * or the only consumer of an SPSC channel).
+     */
+    size_t size_approx() const {
+        if constexpr (kind == ChannelKind::SPSC) {
+            return tail_.value.load(std::memory_order_acquire) - head_.value.load(std::memory_order_acquire);
+        } else {
+            size_t enq = enqueue_pos_.value.load(std::memory_order_acquire);
+            size_t deq = dequeue_pos_.value.load(std::memory_order_acquire);
+            return enq > deq ? enq - deq : 0;
+        }
+    }
+
+    /**
+     * Marks end of stream and wakes every sleeper. Call once, after all producers finished.
+     */
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    // Uninitialized storage for one element (constructed on push, destroyed on pop)
+    struct Slot {
+        alignas(T) unsigned char raw[sizeof(T)];
+        T* get() { return std::launder(reinterpret_cast<T*>(raw)); }
+    };
+
+    // Vyukov cell: sequence == pos -> free for the enqueuer at pos,
+    //              sequence == pos + 1 -> holds the element for the dequeuer at pos
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Slot slot;
+    };
+
+    // Index owned by one side, plus that side's cached copy of the other side's index (SPSC)
+    struct alignas(CACHE_LINE_SIZE) Index {
+        std::atomic<size_t> value{0};
+        size_t cached = 0;
+    };
+
+    // Storage (only one of the two is allocated, depending on the kind)
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<Cell[]> cells_;
+    size_t capacity_;
+    size_t mask_;
+
+    // SPSC indices: head_ written by the consumer, tail_ by the producer
+    Index head_;
+    Index tail_;
+
+    // Vyukov positions
+    Index enqueue_pos_;
+    Index dequeue_pos_;
+
+    // Sleep/wake points: consumers wait for data, producers wait for space
+    alignas(CACHE_LINE_SIZE) WaitPoint<Policy::wait, !multi_consumer> not_empty_;
+    alignas(CACHE_LINE_SIZE) WaitPoint<Policy::wait, !multi_producer> not_full_;
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> closed_{false};
+
+    /** True if a pop could currently succeed (conservative for Vyukov variants). */
+    bool has_data() const {
+        if constexpr (kind == ChannelKind::SPSC) {
+            return tail_.value.load(std::memory_order_acquire) != head_.value.load(std::memory_order_relaxed);
+        } else {
+            size_t pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+            return cells_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+        }
+    }
+
+    /** True if a push could currently succeed (conservative for Vyukov variants). */
+    bool has_space() const {
+        if constexpr (kind == ChannelKind::SPSC) {
+            return tail_.value.load(std::memory_order_relaxed) - head_.value.load(std::memory_order_acquire) < capacity_;
+        } else {
+            size_t pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+            return cells_[pos & mask_].sequence.load(std::memory_order_acquire) == pos;
+        }
+    }
+
+    /** Lock-free enqueue of one element; does not wake anybody. */
+    template <typename U>
+    bool enqueue(U&& value) {
+        if constexpr (kind == ChannelKind::SPSC) {
+            const size_t tail = tail_.value.load(std::memory_order_relaxed);
+            if (tail - tail_.cached == capacity_) {
+                tail_.cached = head_.value.load(std::memory_order_acquire);
+                if (tail - tail_.cached == capacity_) return false;
+            }
+            new (slots_[tail & mask_].raw) T(std::forward<U>(value));
+            tail_.value.store(tail + 1, std::memory_order_release);
+            return true;
+        } else {
+            size_t pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[pos & mask_];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+                if (diff == 0) {
+                    // Cell free for this lap: claim the position
+                    if (enqueue_pos_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        new (cell.slot.raw) T(std::forward<U>(value));
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    // Cell still holds last lap's element: full
+                    return false;
+                } else {
+                    // Another producer claimed this position: reload and retry
+                    pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    /**
+     * Lock-free dequeue of one element, handed to sink(T&&); does not wake anybody.
+     */
+    template <typename Sink>
+    bool dequeue(Sink&& sink) {
+        if constexpr (kind == ChannelKind::SPSC) {
+            const size_t head = head_.value.load(std::memory_order_relaxed);
+            if (head == head_.cached) {
+                head_.cached = tail_.value.load(std::memory_order_acquire);
+                if (head == head_.cached) return false;
+            }
+            T* elem = slots_[head & mask_].get();
+            sink(std::move(*elem));
+            elem->~T();
+            head_.value.store(head + 1, std::memory_order_release);
+            return true;
+        } else {
+            size_t pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[pos & mask_];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+                if (diff == 0) {
+                    // Single consumer owns dequeue_pos_ and needs no CAS
+                    bool claimed;
+                    if constexpr (multi_consumer) {
+                        claimed = dequeue_pos_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed);
+                    } else {
+                        dequeue_pos_.value.store(pos + 1, std::memory_order_relaxed);
+                        claimed = true;
+                    }
+
+                    if (claimed) {
+                        T* elem = cell.slot.get();
+                        sink(std::move(*elem));
+                        elem->~T();
+                        // Hand the cell back to producers for the next lap
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    // Nothing published at this position yet: empty
+                    return false;
+                } else {
+                    pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+};
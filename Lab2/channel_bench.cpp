@@ -0,0 +1,233 @@
+///////////////////////////
+///   IMPORTS SECTION   ///
+///////////////////////////
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "channel.hpp"
+
+
+///////////////////////////
+///  CONSTANTS SECTION  ///
+///////////////////////////
+// Elements transferred per variant
+constexpr size_t ITEMS_PER_RUN = 1 << 20;
+
+// Channel capacity used by every variant
+constexpr size_t BENCH_CAPACITY = 1024;
+
+// Hand-off latency is recorded for one element out of every LATENCY_SAMPLE_STRIDE
+constexpr size_t LATENCY_SAMPLE_STRIDE = 16;
+
+
+///////////////////////////
+///   STRUCTS SECTION   ///
+///////////////////////////
+/**
+ * Stamped: Benchmark element carrying the producer's push timestamp.
+ */
+struct Stamped {
+    int64_t push_ns;
+    uint64_t seq;
+};
+
+/**
+ * BenchResult: Throughput and hand-off latency of one channel variant.
+ */
+struct BenchResult {
+    double mops_per_s;
+    double p50_latency_us;
+    double p99_latency_us;
+};
+
+
+///////////////////////////
+///   HELPERS SECTION   ///
+///////////////////////////
+/**
+ * Steady-clock timestamp in nanoseconds.
+ */
+static inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Runs one variant: `producers` threads push ITEMS_PER_RUN stamped elements in total,
+ * `consumers` threads pop them and record sampled push->pop latencies.
+ *
+ * @tparam Policy  ChannelPolicy under test
+ */
+template <typename Policy>
+static BenchResult bench_variant(int producers, int consumers) {
+    Channel<Stamped, Policy> channel(BENCH_CAPACITY);
+    std::vector<std::vector<double>> latencies(consumers);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; ++c) {
+        consumer_threads.emplace_back([&, c]() {
+            std::vector<double>& lat = latencies[c];
+            lat.reserve(ITEMS_PER_RUN / LATENCY_SAMPLE_STRIDE / consumers + 1);
+
+            Stamped item;
+            while (channel.pop(item)) {
+                if (item.seq % LATENCY_SAMPLE_STRIDE == 0) {
+                    lat.push_back((now_ns() - item.push_ns) / 1000.0);
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> producer_threads;
+    const size_t per_producer = ITEMS_PER_RUN / producers;
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.emplace_back([&, p]() {
+            for (size_t i = 0; i < per_producer; ++i) {
+                channel.push(Stamped{now_ns(), p * per_producer + i});
+            }
+        });
+    }
+
+    for (auto& t : producer_threads) t.join();
+    channel.close();
+    for (auto& t : consumer_threads) t.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> seconds = end - start;
+
+    // Merge per-consumer samples and extract percentiles
+    std::vector<double> all;
+    for (const auto& lat : latencies) all.insert(all.end(), lat.begin(), lat.end());
+
+    BenchResult res{};
+    res.mops_per_s = per_producer * producers / seconds.count() / 1e6;
+    if (!all.empty()) {
+        size_t p50 = (all.size() - 1) / 2;
+        size_t p99 = static_cast<size_t>(0.99 * (all.size() - 1));
+        std::nth_element(all.begin(), all.begin() + p50, all.end());
+        res.p50_latency_us = all[p50];
+        std::nth_element(all.begin(), all.begin() + p99, all.end());
+        res.p99_latency_us = all[p99];
+    }
+    return res;
+}
+
+/**
+ * Prints one result row.
+ */
+static void report(const std::string& name, int producers, int consumers, const BenchResult& r) {
+    std::cout << std::left << std::setw(16) << name
+              << std::right << std::setw(4) << producers << "P/" << consumers << "C"
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << r.mops_per_s << " Mops/s"
+              << std::setw(12) << r.p50_latency_us << " us p50"
+              << std::setw(12) << r.p99_latency_us << " us p99" << std::endl;
+}
+
+/**
+ * Sanity checks for the parts of the API the throughput runs do not exercise:
+ * move-only elements, batch push/pop and close semantics.
+ *
+ * @return true if every check passed
+ */
+static bool check_api() {
+    bool ok = true;
+
+    // Move-only elements through an MPMC channel, including leftovers destroyed by ~Channel
+    {
+        Channel<std::unique_ptr<int>, MpmcHybrid> channel(8);
+        long long sum = 0;
+        std::thread consumer([&]() {
+            std::unique_ptr<int> item;
+            while (channel.pop(item)) sum += *item;
+        });
+        for (int i = 1; i <= 1000; ++i) channel.push(std::make_unique<int>(i));
+        channel.close();
+        consumer.join();
+        ok = ok && sum == 500500;
+
+        Channel<std::unique_ptr<int>, MpscBlocking> leftovers(4);
+        leftovers.try_push(std::make_unique<int>(1));
+        leftovers.try_push(std::make_unique<int>(2));
+    }
+
+    // Batch operations preserve order (SPSC) and count (MPMC)
+    {
+        Channel<int, SpscHybrid> spsc(16);
+        std::vector<int> in(1000), out;
+        for (int i = 0; i < 1000; ++i) in[i] = i;
+        std::thread producer([&]() {
+            spsc.push_batch(in.begin(), in.size());
+            spsc.close();
+        });
+        std::vector<int> buffer(64);
+        size_t n;
+        while ((n = spsc.pop_batch(buffer.begin(), buffer.size())) > 0) {
+            out.insert(out.end(), buffer.begin(), buffer.begin() + n);
+        }
+        producer.join();
+        ok = ok && out == in;
+
+        Channel<int, MpmcSpinning> mpmc(16);
+        std::thread producer2([&]() {
+            mpmc.push_batch(in.begin(), in.size());
+            mpmc.close();
+        });
+        out.clear();
+        while (mpmc.pop_batch(std::back_inserter(out), 64) > 0) {
+        }
+        producer2.join();
+        ok = ok && out.size() == in.size();
+    }
+
+    // Closed channels reject pushes; try_pop on an empty channel fails
+    {
+        Channel<int, MpscHybrid> channel(4);
+        int value = 0;
+        ok = ok && !channel.try_pop(value);
+        channel.close();
+        ok = ok && !channel.push(1) && !channel.try_push(2) && !channel.pop(value);
+    }
+
+    return ok;
+}
+
+
+/////////////////////////
+///   MAIN SECTION    ///
+/////////////////////////
+/**
+ * Channel microbenchmark suite: ops/sec and hand-off latency for every
+ * (topology, wait policy) combination.
+ */
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "CHANNEL MICROBENCHMARK" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Hardware concurrency: " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << "Items per run: " << ITEMS_PER_RUN << ", capacity: " << BENCH_CAPACITY << std::endl;
+    std::cout << "API checks: " << (check_api() ? "PASS" : "FAIL") << "\n" << std::endl;
+
+    report("SPSC blocking", 1, 1, bench_variant<SpscBlocking>(1, 1));
+    report("SPSC spinning", 1, 1, bench_variant<SpscSpinning>(1, 1));
+    report("SPSC hybrid", 1, 1, bench_variant<SpscHybrid>(1, 1));
+
+    report("MPSC blocking", 4, 1, bench_variant<MpscBlocking>(4, 1));
+    report("MPSC spinning", 4, 1, bench_variant<MpscSpinning>(4, 1));
+    report("MPSC hybrid", 4, 1, bench_variant<MpscHybrid>(4, 1));
+
+    report("MPMC blocking", 4, 4, bench_variant<MpmcBlocking>(4, 4));
+    report("MPMC spinning", 4, 4, bench_variant<MpmcSpinning>(4, 4));
+    report("MPMC hybrid", 4, 4, bench_variant<MpmcHybrid>(4, 4));
+
+    return 0;
+}
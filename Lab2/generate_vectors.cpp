@@ -0,0 +1,74 @@
+///////////////////////////
+///   IMPORTS SECTION   ///
+///////////////////////////
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+///////////////////////////
+///  CONSTANTS SECTION  ///
+///////////////////////////
+// Elements generated and written per block (memory use is independent of n)
+constexpr size_t WRITE_BLOCK = 1 << 16;
+
+
+///////////////////////////
+///   HELPERS SECTION   ///
+///////////////////////////
+/**
+ * Writes n uniform random doubles in [0, 10) to `path` as raw binary (native endianness).
+ * @return false if the file could not be written
+ */
+static bool write_vector(const std::string& path, size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 10.0);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<double> block(WRITE_BLOCK);
+
+    for (size_t i = 0; i < n && out; i += block.size()) {
+        size_t len = std::min(block.size(), n - i);
+        for (size_t j = 0; j < len; ++j) block[j] = dist(gen);
+        out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(len * sizeof(double)));
+    }
+
+    return static_cast<bool>(out);
+}
+
+
+/////////////////////////
+///   MAIN SECTION    ///
+/////////////////////////
+/**
+ * Input generator for the scalar product experiments.
+ *
+ * Usage: generate_vectors <n> [v1.bin] [v2.bin] [seed]
+ *
+ * Writes the two vectors in blocks, so multi-GB inputs can be generated on machines
+ * with little RAM. The experiments and pipeline_demo memory-map these files.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <n> [v1.bin] [v2.bin] [seed]" << std::endl;
+        return 1;
+    }
+
+    const size_t n = std::strtoull(argv[1], nullptr, 10);
+    const std::string path1 = argc > 2 ? argv[2] : "v1.bin";
+    const std::string path2 = argc > 3 ? argv[3] : "v2.bin";
+    const unsigned seed = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : std::random_device{}();
+
+    if (!write_vector(path1, n, seed) || !write_vector(path2, n, seed + 1)) {
+        std::cerr << "Failed to write " << path1 << " / " << path2 << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << n << " doubles to " << path1 << " and " << path2
+              << " (" << 2.0 * n * sizeof(double) / (1 << 30) << " GiB)" << std::endl;
+    return 0;
+}
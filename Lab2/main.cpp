@@ -1,19 +1,104 @@
 ///////////////////////////
 ///   IMPORTS SECTION   ///
 ///////////////////////////
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <condition_variable>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include <random>
 #include <deque>
 #include <chrono>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "channel.hpp"
+#include "mapped_file.hpp"
+#include "reduction.hpp"
+#include "simd_kernels.hpp"
+
+
+///////////////////////////
+///  CONSTANTS SECTION  ///
+///////////////////////////
+// Hand-off latency is sampled for one element out of every LATENCY_SAMPLE_STRIDE
+constexpr size_t LATENCY_SAMPLE_STRIDE = 64;
+
+// Number of products carried by one MPMC queue slot
+constexpr size_t PRODUCT_CHUNK_SIZE = 64;
+
+// Elements (per vector) scanned by the stream bandwidth reference, and timed passes over them
+constexpr size_t STREAM_ELEMENTS = size_t(1) << 24;
+constexpr int STREAM_REPEATS = 3;
+
+// Span handed to an accumulator per call in the reduction benchmark (a consumer-sized block)
+constexpr size_t REDUCTION_SPAN = 4096;
 
 
 ///////////////////////////
 ///   STRUCTS SECTION   ///
 ///////////////////////////
+/**
+ * WakeStats: Per-thread counters of the mutex / condition-variable protocol.
+ *
+ * Each thread fills a local copy and stores it in SharedData after its loop, so counting
+ * costs a few register increments. The clock is read only around actual waits (which
+ * already cost a sleep and a wake-up) and at thread start and end.
+ */
+struct WakeStats {
+    // Products pushed (producer) or popped (consumer)
+    uint64_t items = 0;
+
+    // Calls to cv.wait
+    uint64_t waits = 0;
+
+    // Wake-ups that found the wait condition still true (spurious or lost race)
+    uint64_t spurious_wakeups = 0;
+
+    // Calls to notify_one
+    uint64_t notifies = 0;
+
+    // Time spent inside cv.wait, and total thread run time (compute = total - blocked)
+    int64_t blocked_ns = 0;
+    int64_t total_ns = 0;
+
+    WakeStats& operator+=(const WakeStats& other) {
+        items += other.items;
+        waits += other.waits;
+        spurious_wakeups += other.spurious_wakeups;
+        notifies += other.notifies;
+        blocked_ns += other.blocked_ns;
+        total_ns += other.total_ns;
+        return *this;
+    }
+};
+
+/**
+ * LatencyProbe: Sampled producer->consumer hand-off latency.
+ *
+ * The producer stamps every LATENCY_SAMPLE_STRIDE-th element (batched: when it starts
+ * computing its block, mutex/deque: when it is enqueued); the consumer measures the
+ * elapsed time when that element is taken. Stamps are plain writes made visible by the
+ * hand-off (ring release/acquire, or the mutex).
+ */
+struct LatencyProbe {
+    // Producer-side stamps (steady_clock nanoseconds), one per sampled element
+    std::vector<int64_t> stamps;
+
+    // Consumer-side latencies in microseconds
+    std::vector<double> samples_us;
+
+    explicit LatencyProbe(size_t n) : stamps(n / LATENCY_SAMPLE_STRIDE + 1, 0) {
+        samples_us.reserve(stamps.size());
+    }
+};
+
 /**
  * SharedData: Communication channel between producer and consumer threads.
  *
@@ -40,13 +125,97 @@ struct SharedData {
     // Flag indicating all products have been computed
     bool done;
 
+    // Wake-up counters, written by each thread once it finishes
+    WakeStats producer_stats;
+    WakeStats consumer_stats;
+
+    // Optional enqueue->dequeue latency sampling (nullptr = disabled)
+    LatencyProbe* probe;
+
     /**
      * Constructor: initializes shared state with specified deque size.
      * @param deque_size Maximum number of products that can be buffered
+     * @param latency_probe Optional latency probe sized for the vector length
      */
-    SharedData(size_t deque_size): max_deque_size(deque_size), done(false) {}
+    SharedData(size_t deque_size, LatencyProbe* latency_probe = nullptr)
+        : max_deque_size(deque_size), done(false), probe(latency_probe) {}
 };
 
+/**
+ * BatchConfig: Block size policy for the batched producer.
+ *
+ * Fixed mode publishes blocks of exactly `batch` products. Adaptive mode starts at
+ * `min_batch` and resizes after every block based on ring occupancy:
+ * - occupancy < 1/4 capacity: consumer is starving, halve K (lower latency)
+ * - occupancy > 3/4 capacity: consumer is behind, double K (fewer hand-offs)
+ */
+struct BatchConfig {
+    size_t batch;
+    bool adaptive;
+    size_t min_batch;
+    size_t max_batch;
+};
+
+/**
+ * ExperimentResult: Metrics from one mutex / condition-variable experiment.
+ */
+struct ExperimentResult {
+    double time_ms;
+    double result;
+    WakeStats producer;
+    WakeStats consumer;
+    double mean_latency_us;
+    double p99_latency_us;
+};
+
+/**
+ * BatchResult: Metrics from one batched experiment.
+ */
+struct BatchResult {
+    double time_ms;
+    double gb_per_s;
+    double mean_latency_us;
+    double p99_latency_us;
+    double result;
+};
+
+/**
+ * ProductChunk: Unit of transfer through the MPMC queue.
+ * Carries up to PRODUCT_CHUNK_SIZE consecutive products from one producer's range.
+ */
+struct ProductChunk {
+    size_t count;
+    double values[PRODUCT_CHUNK_SIZE];
+};
+
+
+///////////////////////////
+///   HELPERS SECTION   ///
+///////////////////////////
+/**
+ * Steady-clock timestamp in nanoseconds (latency probes).
+ */
+static inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Mean and 99th percentile of latency samples (reorders `samples`); zeros if empty.
+ */
+static void summarize_latency(std::vector<double>& samples, double& mean_us, double& p99_us) {
+    mean_us = 0.0;
+    p99_us = 0.0;
+    if (samples.empty()) return;
+
+    double sum = 0.0;
+    for (double l : samples) sum += l;
+    mean_us = sum / samples.size();
+
+    size_t p99 = static_cast<size_t>(0.99 * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+    p99_us = samples[p99];
+}
 
 ///////////////////////////
 ///   THREAD FUNCTIONS  ///
@@ -60,9 +229,14 @@ struct SharedData {
  * 3. Push product to deque
  * 4. Signal consumer via condition variable
  * 5. After all products, set done flag and signal
+ *
+ * Wake-up counters go to data.producer_stats; with data.probe set, every
+ * LATENCY_SAMPLE_STRIDE-th product is stamped when it is enqueued.
  */
-void producer(const std::vector<double>& v1, const std::vector<double>& v2, SharedData& data) {
+void producer(std::span<const double> v1, std::span<const double> v2, SharedData& data) {
     size_t n = v1.size();
+    WakeStats stats;
+    int64_t thread_start = now_ns();
 
     for (size_t i = 0; i < n; i++) {
         // Compute product locally without holding any locks
@@ -72,12 +246,22 @@ void producer(const std::vector<double>& v1, const std::vector<double>& v2, Shar
             std::unique_lock<std::mutex> lck(data.mtx);
 
             // Wait until deque has space (not full)
-            while (data.product_deque.size() >= data.max_deque_size) {
-                data.cv_producer.wait(lck);
+            if (data.product_deque.size() >= data.max_deque_size) {
+                int64_t t0 = now_ns();
+                while (true) {
+                    data.cv_producer.wait(lck);
+                    stats.waits++;
+                    if (data.product_deque.size() < data.max_deque_size) break;
+                    stats.spurious_wakeups++;
+                }
+                stats.blocked_ns += now_ns() - t0;
             }
 
             // Add product to deque
             data.product_deque.push_back(local_product);
+            if (data.probe != nullptr && i % LATENCY_SAMPLE_STRIDE == 0) {
+                data.probe->stamps[i / LATENCY_SAMPLE_STRIDE] = now_ns();
+            }
 
 //            std::cout << "Producer: v1[" << i << "] * v2[" << i
 //                      << "] = " << local_product
@@ -86,6 +270,7 @@ void producer(const std::vector<double>& v1, const std::vector<double>& v2, Shar
 
         // Notify consumer that new data is available
         data.cv_consumer.notify_one();
+        stats.notifies++;
     }
 
     // Signal completion
@@ -94,6 +279,11 @@ void producer(const std::vector<double>& v1, const std::vector<double>& v2, Shar
         data.done = true;
     }
     data.cv_consumer.notify_one();
+    stats.notifies++;
+
+    stats.items = n;
+    stats.total_ns = now_ns() - thread_start;
+    data.producer_stats = stats;
 }
 
 /**
@@ -105,10 +295,15 @@ void producer(const std::vector<double>& v1, const std::vector<double>& v2, Shar
  * 3. Signal producer that space is available
  * 4. Add product to sum outside critical section
  * 5. Repeat until deque empty and producer done
+ *
+ * Wake-up counters go to data.consumer_stats; with data.probe set, the latency of
+ * every stamped product is recorded when it is dequeued.
  */
 void consumer(double& result, SharedData& data) {
     result = 0.0;
     int count = 0;
+    WakeStats stats;
+    int64_t thread_start = now_ns();
 
     while (true) {
         double local_product;
@@ -118,8 +313,15 @@ void consumer(double& result, SharedData& data) {
             std::unique_lock<std::mutex> lck(data.mtx);
 
             // Wait until deque has data OR producer is done
-            while (data.product_deque.empty() && !data.done) {
-                data.cv_consumer.wait(lck);
+            if (data.product_deque.empty() && !data.done) {
+                int64_t t0 = now_ns();
+                while (true) {
+                    data.cv_consumer.wait(lck);
+                    stats.waits++;
+                    if (!data.product_deque.empty() || data.done) break;
+                    stats.spurious_wakeups++;
+                }
+                stats.blocked_ns += now_ns() - t0;
             }
 
             // Check if we should terminate
@@ -133,6 +335,12 @@ void consumer(double& result, SharedData& data) {
                 data.product_deque.pop_front();
                 got_product = true;
 
+                // FIFO: the count-th product dequeued is the count-th enqueued
+                if (data.probe != nullptr && count % LATENCY_SAMPLE_STRIDE == 0) {
+                    data.probe->samples_us.push_back(
+                            (now_ns() - data.probe->stamps[count / LATENCY_SAMPLE_STRIDE]) / 1000.0);
+                }
+
 //                std::cout << "Consumer: consumed product #" << count
 //                          << " = " << local_product
 //                          << " (deque size: " << data.product_deque.size() << ")" << std::endl;
@@ -142,37 +350,204 @@ void consumer(double& result, SharedData& data) {
         // Notify producer that space is available
         if (got_product) {
             data.cv_producer.notify_one();
+            stats.notifies++;
             result += local_product;
             count++;
         }
     }
 
+    stats.items = count;
+    stats.total_ns = now_ns() - thread_start;
+    data.consumer_stats = stats;
+
 //    std::cout << "Consumer: finished, scalar product = " << result << std::endl;
 }
 
+/**
+ * Lock-free producer: computes products and pushes them into the SPSC ring.
+ *
+ * Same role as producer(), but each element costs two plain atomic stores and
+ * a fence instead of a mutex round-trip and a notify_one.
+ */
+void producer_spsc(std::span<const double> v1, std::span<const double> v2, Channel<double, SpscHybrid>& ring) {
+    size_t n = v1.size();
+
+    for (size_t i = 0; i < n; i++) {
+        ring.push(v1[i] * v2[i]);
+    }
+
+    // Signal completion
+    ring.close();
+}
+
+/**
+ * Lock-free consumer: drains the SPSC ring and accumulates the sum.
+ * Terminates once the ring is closed and empty.
+ */
+void consumer_spsc(double& result, Channel<double, SpscHybrid>& ring) {
+    result = 0.0;
+
+    double local_product;
+    while (ring.pop(local_product)) {
+        result += local_product;
+    }
+}
+
+/**
+ * Batched producer: computes blocks of K products and publishes each block at once.
+ *
+ * Synchronization cost is paid once per block instead of once per product. In adaptive
+ * mode K follows the ring occupancy (see BatchConfig).
+ *
+ * @param probe  Optional latency probe (nullptr = disabled)
+ */
+void producer_batched(std::span<const double> v1, std::span<const double> v2,
+                      Channel<double, SpscHybrid>& ring, BatchConfig cfg, LatencyProbe* probe) {
+    const size_t n = v1.size();
+    const size_t cap = ring.capacity();
+
+    // Never build blocks larger than the ring can hold
+    const size_t max_batch = std::max<size_t>(1, std::min(cfg.max_batch, cap));
+    const size_t min_batch = std::max<size_t>(1, std::min(cfg.min_batch, max_batch));
+    size_t k = cfg.adaptive ? min_batch : std::max<size_t>(1, std::min(cfg.batch, max_batch));
+
+    std::vector<double> block(max_batch);
+
+    for (size_t i = 0, len = 0; i < n; i += len) {
+        len = std::min(k, n - i);
+
+        // Stamp sampled elements of this block before computing it
+        if (probe != nullptr) {
+            int64_t t = now_ns();
+            for (size_t s = (i + LATENCY_SAMPLE_STRIDE - 1) / LATENCY_SAMPLE_STRIDE * LATENCY_SAMPLE_STRIDE;
+                 s < i + len; s += LATENCY_SAMPLE_STRIDE) {
+                probe->stamps[s / LATENCY_SAMPLE_STRIDE] = t;
+            }
+        }
+
+        multiply_block(&v1[i], &v2[i], block.data(), len);
+        ring.push_batch(block.data(), len);
+
+        if (cfg.adaptive) {
+            size_t occ = ring.size_approx();
+            if (occ < cap / 4) {
+                k = std::max(min_batch, k / 2);
+            } else if (occ > 3 * cap / 4) {
+                k = std::min(max_batch, k * 2);
+            }
+        }
+    }
+
+    ring.close();
+}
+
+/**
+ * Batched consumer: sums whole spans of the ring with the selected reduction.
+ *
+ * @tparam Accumulator  Reduction mode (see reduction.hpp)
+ * @param probe  Optional latency probe (nullptr = disabled)
+ */
+template <typename Accumulator>
+void consumer_batched(double& result, Channel<double, SpscHybrid>& ring, LatencyProbe* probe) {
+    Accumulator acc;
+    size_t consumed = 0;
+
+    auto sum_span = [&](const double* data, size_t len) {
+        acc.add(data, len);
+
+        if (probe != nullptr) {
+            int64_t t = now_ns();
+            for (size_t s = (consumed + LATENCY_SAMPLE_STRIDE - 1) / LATENCY_SAMPLE_STRIDE * LATENCY_SAMPLE_STRIDE;
+                 s < consumed + len; s += LATENCY_SAMPLE_STRIDE) {
+                probe->samples_us.push_back((t - probe->stamps[s / LATENCY_SAMPLE_STRIDE]) / 1000.0);
+            }
+        }
+        consumed += len;
+    };
+
+    while (ring.consume(sum_span, ring.capacity()) > 0) {
+    }
+    result = acc.value();
+}
+
+/**
+ * MPMC producer: computes products for its disjoint index range [begin, end)
+ * and enqueues them in chunks of PRODUCT_CHUNK_SIZE.
+ */
+void producer_mpmc(std::span<const double> v1, std::span<const double> v2,
+                   size_t begin, size_t end, Channel<ProductChunk, MpmcHybrid>& queue) {
+    ProductChunk chunk;
+    for (size_t i = begin; i < end; i += chunk.count) {
+        chunk.count = std::min(PRODUCT_CHUNK_SIZE, end - i);
+        multiply_block(&v1[i], &v2[i], chunk.values, chunk.count);
+        queue.push(chunk);
+    }
+}
+
+/**
+ * MPMC consumer: dequeues chunks until the queue is closed and drained,
+ * accumulating into a local accumulator that is published once at the end
+ * (no false sharing between consumers while running).
+ *
+ * @tparam Accumulator  Reduction mode (see reduction.hpp)
+ */
+template <typename Accumulator>
+void consumer_mpmc(Accumulator& partial, Channel<ProductChunk, MpmcHybrid>& queue) {
+    Accumulator local;
+    ProductChunk chunk;
+    while (queue.pop(chunk)) {
+        local.add(chunk.values, chunk.count);
+    }
+    partial = std::move(local);
+}
+
 
 /////////////////////////
 ///   MAIN SECTION    ///
 /////////////////////////
 /**
- * Runs a single experiment with specified deque size.
- * Returns execution time in milliseconds.
+ * Views the first n doubles of a mapped input file.
  */
-double run_experiment(int n, size_t deque_size, bool verbose) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(0.0, 10.0);
+std::span<const double> as_vector(const MappedFile& file, size_t n) {
+    return {static_cast<const double*>(file.data()), std::min(n, file.size() / sizeof(double))};
+}
 
-    std::vector<double> v1(n);
-    std::vector<double> v2(n);
+/**
+ * Clamps a requested prefix length to the elements present in both input files, so
+ * both spans of an experiment always have the same size.
+ * Prints a warning when the request is cut.
+ */
+static size_t prefix_length(const char* experiment, size_t requested, size_t available) {
+    if (requested <= available) return requested;
+    std::cerr << "Warning: " << experiment << " requested " << requested << " elements, inputs have "
+              << available << "; using " << available << std::endl;
+    return available;
+}
 
-    for (int i = 0; i < n; i++) {
-        v1[i] = dist(gen);
-        v2[i] = dist(gen);
-    }
+/**
+ * Prints one thread's wake-up counters: waits, spurious wake-ups, notify_one calls,
+ * and blocked vs compute share of its run time.
+ */
+static void print_wake_stats(const char* role, const WakeStats& s) {
+    double total = s.total_ns > 0 ? static_cast<double>(s.total_ns) : 1.0;
+    std::cout << "  " << role << ": waits " << s.waits
+              << " (spurious " << s.spurious_wakeups << "), notify_one " << s.notifies
+              << ", blocked " << 100.0 * s.blocked_ns / total << "% / compute "
+              << 100.0 * (s.total_ns - s.blocked_ns) / total << "%"
+              << ", waits per item " << (s.items > 0 ? static_cast<double>(s.waits) / s.items : 0.0) << std::endl;
+}
 
+/**
+ * Runs a single experiment with specified deque size.
+ * Returns execution time, result, per-thread wake-up counters and, with
+ * sample_latency, the enqueue->dequeue latency (mean, p99).
+ */
+ExperimentResult run_experiment(std::span<const double> v1, std::span<const double> v2, size_t deque_size,
+                                bool verbose, bool sample_latency = false) {
     double scalar_product = 0.0;
-    SharedData shared_data(deque_size);
+    std::unique_ptr<LatencyProbe> probe;
+    if (sample_latency) probe = std::make_unique<LatencyProbe>(v1.size());
+    SharedData shared_data(deque_size, probe.get());
 
     if (verbose) {
         std::cout << "\n========================================" << std::endl;
@@ -182,14 +557,60 @@ double run_experiment(int n, size_t deque_size, bool verbose) {
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    std::thread producer_thread(producer, std::ref(v1), std::ref(v2), std::ref(shared_data));
+    std::thread producer_thread(producer, v1, v2, std::ref(shared_data));
     std::thread consumer_thread(consumer, std::ref(scalar_product), std::ref(shared_data));
 
     producer_thread.join();
     consumer_thread.join();
 
     auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    ExperimentResult res{};
+    res.time_ms = duration.count();
+    res.result = scalar_product;
+    res.producer = shared_data.producer_stats;
+    res.consumer = shared_data.consumer_stats;
+    if (probe) summarize_latency(probe->samples_us, res.mean_latency_us, res.p99_latency_us);
+
+    if (verbose) {
+        std::cout << "\nResult: " << scalar_product << std::endl;
+        std::cout << "Time: " << duration.count() << " ms" << std::endl;
+        print_wake_stats("producer", res.producer);
+        print_wake_stats("consumer", res.consumer);
+        if (probe) {
+            std::cout << "  latency: mean " << res.mean_latency_us << " us, p99 " << res.p99_latency_us << " us" << std::endl;
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Runs a single experiment through the lock-free SPSC ring.
+ * The ring capacity is deque_size rounded up to a power of two.
+ * Returns execution time in milliseconds.
+ */
+double run_experiment_spsc(std::span<const double> v1, std::span<const double> v2, size_t deque_size, bool verbose) {
+    double scalar_product = 0.0;
+    Channel<double, SpscHybrid> ring(deque_size);
+
+    if (verbose) {
+        std::cout << "\n========================================" << std::endl;
+        std::cout << "EXPERIMENT (SPSC): Ring Capacity = " << ring.capacity() << std::endl;
+        std::cout << "========================================" << std::endl;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer_thread(producer_spsc, v1, v2, std::ref(ring));
+    std::thread consumer_thread(consumer_spsc, std::ref(scalar_product), std::ref(ring));
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
 
     if (verbose) {
         std::cout << "\nResult: " << scalar_product << std::endl;
@@ -199,14 +620,228 @@ double run_experiment(int n, size_t deque_size, bool verbose) {
     return duration.count();
 }
 
-int main() {
-    const int n = 10000;  // Vector size
+/**
+ * Runs one batched experiment on pre-generated vectors.
+ *
+ * Reports wall time, effective input bandwidth (16 bytes read per element) and the
+ * sampled hand-off latency distribution.
+ *
+ * @param mode  Consumer reduction mode
+ */
+BatchResult run_experiment_batched(std::span<const double> v1, std::span<const double> v2,
+                                   size_t deque_size, BatchConfig cfg, ReductionMode mode = ReductionMode::NAIVE) {
+    double scalar_product = 0.0;
+    Channel<double, SpscHybrid> ring(deque_size);
+    LatencyProbe probe(v1.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer_thread(producer_batched, v1, v2, std::ref(ring), cfg, &probe);
+    std::thread consumer_thread = with_accumulator(mode, [&](auto prototype) {
+        return std::thread(consumer_batched<decltype(prototype)>, std::ref(scalar_product), std::ref(ring), &probe);
+    });
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    BatchResult res{};
+    res.time_ms = duration.count();
+    res.gb_per_s = (2.0 * sizeof(double) * v1.size()) / (res.time_ms * 1e6);
+    res.result = scalar_product;
+
+    summarize_latency(probe.samples_us, res.mean_latency_us, res.p99_latency_us);
+
+    return res;
+}
+
+/**
+ * Single-threaded reference: multiply and sum the same vectors with the SIMD kernels,
+ * no channel involved. Its GB/s is the bandwidth ceiling the pipelines are compared to.
+ *
+ * One untimed pass faults the (mapped) pages in first, then the best of
+ * STREAM_REPEATS passes is reported, so the figure is memory bandwidth, not disk.
+ */
+double measure_stream_bandwidth(std::span<const double> v1, std::span<const double> v2) {
+    const size_t n = v1.size();
+    const size_t block = 4096;
+    std::vector<double> tmp(block);
+    volatile double sink = 0.0;
+    double best_ms = 0.0;
+
+    for (int rep = 0; rep <= STREAM_REPEATS; ++rep) {
+        auto start = std::chrono::high_resolution_clock::now();
+        double total = 0.0;
+        for (size_t i = 0; i < n; i += block) {
+            size_t len = std::min(block, n - i);
+            multiply_block(&v1[i], &v2[i], tmp.data(), len);
+            total += sum_block(tmp.data(), len);
+        }
+        sink = total;
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double, std::milli> duration = end - start;
+        if (rep == 1 || (rep > 1 && duration.count() < best_ms)) best_ms = duration.count();
+    }
+    (void)sink;
+
+    return (2.0 * sizeof(double) * n) / (best_ms * 1e6);
+}
+
+/**
+ * Sums `values` in REDUCTION_SPAN blocks with one reduction mode, single-threaded.
+ * Reports the best of STREAM_REPEATS passes in GB/s; `sum` receives the result.
+ */
+double benchmark_reduction(const std::vector<double>& values, ReductionMode mode, double& sum) {
+    double best_ms = 0.0;
+
+    for (int rep = 0; rep < STREAM_REPEATS; ++rep) {
+        auto start = std::chrono::high_resolution_clock::now();
+        sum = with_accumulator(mode, [&](auto acc) {
+            for (size_t i = 0; i < values.size(); i += REDUCTION_SPAN) {
+                acc.add(&values[i], std::min(REDUCTION_SPAN, values.size() - i));
+            }
+            return acc.value();
+        });
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double, std::milli> duration = end - start;
+        if (rep == 0 || duration.count() < best_ms) best_ms = duration.count();
+    }
+
+    return (sizeof(double) * values.size()) / (best_ms * 1e6);
+}
+
+/**
+ * Builds a badly conditioned sum: n/2 random values spread over 2^-40 .. 2^40, their
+ * negations in shuffled order, and a single 1.0. The exact sum is 1.0, while sum|x| is
+ * around n * 2^39, so rounding errors of a plain running sum swamp the answer.
+ */
+std::vector<double> make_ill_conditioned(size_t n) {
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<double> mantissa(1.0, 2.0);
+    std::uniform_int_distribution<int> exponent(-40, 40);
+
+    const size_t half = n / 2;
+    std::vector<double> values(2 * half + 1);
+    for (size_t i = 0; i < half; ++i) {
+        values[i] = std::ldexp(mantissa(gen), exponent(gen)) * (gen() & 1 ? 1.0 : -1.0);
+    }
+    for (size_t i = 0; i < half; ++i) values[half + i] = -values[i];
+    std::shuffle(values.begin() + half, values.begin() + 2 * half, gen);
+    values[2 * half] = 1.0;
+
+    return values;
+}
+
+/**
+ * Runs the N-producer / M-consumer pipeline on pre-generated vectors.
+ *
+ * Producers get contiguous, disjoint index ranges; consumers keep private partial
+ * accumulators that are merged after the join. The queue is closed once all producers finish.
+ *
+ * @tparam Accumulator   Consumer reduction mode (see reduction.hpp)
+ * @param num_producers  Number of producer threads (N)
+ * @param num_consumers  Number of consumer threads (M)
+ * @param queue_chunks   Queue capacity in chunks
+ * @param result         Receives the scalar product
+ * @return Execution time in milliseconds
+ */
+template <typename Accumulator>
+double run_experiment_mpmc(std::span<const double> v1, std::span<const double> v2,
+                           int num_producers, int num_consumers, size_t queue_chunks, double& result) {
+    const size_t n = v1.size();
+    Channel<ProductChunk, MpmcHybrid> queue(queue_chunks);
+    std::vector<Accumulator> partials(num_consumers);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> consumers;
+    consumers.reserve(num_consumers);
+    for (int c = 0; c < num_consumers; ++c) {
+        consumers.emplace_back(consumer_mpmc<Accumulator>, std::ref(partials[c]), std::ref(queue));
+    }
+
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    size_t per_producer = n / num_producers;
+    size_t remainder = n % num_producers;
+    size_t begin = 0;
+    for (int p = 0; p < num_producers; ++p) {
+        size_t end = begin + per_producer + (static_cast<size_t>(p) < remainder ? 1 : 0);
+        producers.emplace_back(producer_mpmc, v1, v2, begin, end, std::ref(queue));
+        begin = end;
+    }
+
+    for (auto& t : producers) t.join();
+    queue.close();
+    for (auto& t : consumers) t.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    for (int c = 1; c < num_consumers; ++c) partials[0].merge(partials[c]);
+    result = partials[0].value();
+
+    return duration.count();
+}
+
+/**
+ * Runs the N-producer / M-consumer pipeline with the reduction mode chosen at run time.
+ */
+double run_experiment_mpmc(std::span<const double> v1, std::span<const double> v2,
+                           int num_producers, int num_consumers, size_t queue_chunks, double& result,
+                           ReductionMode mode = ReductionMode::NAIVE) {
+    return with_accumulator(mode, [&](auto prototype) {
+        return run_experiment_mpmc<decltype(prototype)>(v1, v2, num_producers, num_consumers, queue_chunks, result);
+    });
+}
+
+/**
+ * Usage: Parallel_Distributed_Programming [v1.bin v2.bin] [--huge-pages]
+ *
+ * The input vectors are raw doubles produced by the generate_vectors tool (default
+ * file names v1.bin / v2.bin). Each experiment uses a prefix of the mapped files;
+ * the last one streams the whole files, which may be larger than RAM.
+ */
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    bool huge_pages = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--huge-pages") == 0) huge_pages = true;
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) files = {"v1.bin", "v2.bin"};
+
+    std::unique_ptr<MappedFile> f1;
+    std::unique_ptr<MappedFile> f2;
+    try {
+        f1 = std::make_unique<MappedFile>(files[0], MapOptions{true, huge_pages});
+        f2 = std::make_unique<MappedFile>(files[1], MapOptions{true, huge_pages});
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nCreate the inputs first, e.g.: generate_vectors 100000000 v1.bin v2.bin" << std::endl;
+        return 1;
+    }
+    const size_t available = std::min(f1->size(), f2->size()) / sizeof(double);
+
+    const size_t n_stream = prefix_length("stream bandwidth", STREAM_ELEMENTS, available);
+    const double stream_gb_s = measure_stream_bandwidth(as_vector(*f1, n_stream), as_vector(*f2, n_stream));
+    auto percent_of_stream = [&](double gb_s) { return 100.0 * gb_s / stream_gb_s; };
+
+    const size_t n = prefix_length("deque size analysis", 10000, available);  // Vector size
+    std::span<const double> v1 = as_vector(*f1, n);
+    std::span<const double> v2 = as_vector(*f2, n);
     std::vector<size_t> deque_sizes = {1, 2, 5, 10, 50, 100, 500, 1000};
 
     std::cout << "========================================" << std::endl;
     std::cout << "SCALAR PRODUCT - DEQUE SIZE ANALYSIS" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "Vector size: " << n << " elements" << std::endl;
+    std::cout << "Input: " << files[0] << ", " << files[1] << " (" << available << " elements, mapped"
+              << (huge_pages ? ", huge pages requested" : "") << ")" << std::endl;
+    std::cout << "Stream bandwidth (single thread): " << stream_gb_s << " GB/s" << std::endl;
+    std::cout << "Vector size: " << v1.size() << " elements" << std::endl;
     std::cout << "Testing deque sizes: ";
     for (size_t sz : deque_sizes) {
         std::cout << sz << " ";
@@ -218,24 +853,186 @@ int main() {
     std::cout << "\nRUNNING PERFORMANCE EXPERIMENTS...\n" << std::endl;
 
     for (size_t deque_size : deque_sizes) {
-        // Run multiple times and average (for more reliable results)
+        // Run multiple times and average (for more reliable results); the wake-up
+        // counters are summed over the runs and printed per run
         const int runs = 3;
         double total_time = 0.0;
+        double total_mean_latency = 0.0;
+        double total_p99_latency = 0.0;
+        WakeStats producer_stats;
+        WakeStats consumer_stats;
 
         for (int i = 0; i < runs; i++) {
-            double time = run_experiment(n, deque_size, false);
-            total_time += time;
+            ExperimentResult r = run_experiment(v1, v2, deque_size, false, true);
+            total_time += r.time_ms;
+            total_mean_latency += r.mean_latency_us;
+            total_p99_latency += r.p99_latency_us;
+            producer_stats += r.producer;
+            consumer_stats += r.consumer;
+        }
+
+        for (WakeStats* s : {&producer_stats, &consumer_stats}) {
+            s->items /= runs;
+            s->waits /= runs;
+            s->spurious_wakeups /= runs;
+            s->notifies /= runs;
         }
 
         double avg_time = total_time / runs;
+        double gb_s = (2.0 * sizeof(double) * v1.size()) / (avg_time * 1e6);
         std::cout << "Deque size " << deque_size << ": "
-                  << avg_time << " ms (avg of " << runs << " runs)" << std::endl;
+                  << avg_time << " ms (avg of " << runs << " runs), "
+                  << gb_s << " GB/s (" << percent_of_stream(gb_s) << "% of stream)" << std::endl;
+        print_wake_stats("producer", producer_stats);
+        print_wake_stats("consumer", consumer_stats);
+        std::cout << "  latency (1 in " << LATENCY_SAMPLE_STRIDE << " products): mean "
+                  << total_mean_latency / runs << " us, p99 " << total_p99_latency / runs << " us" << std::endl;
+    }
+
+    // Same sweep through the lock-free ring (capacity rounded up to a power of two)
+    std::cout << "\nRUNNING SPSC RING BUFFER EXPERIMENTS...\n" << std::endl;
+
+    for (size_t deque_size : deque_sizes) {
+        const int runs = 3;
+        double total_time = 0.0;
+
+        for (int i = 0; i < runs; i++) {
+            total_time += run_experiment_spsc(v1, v2, deque_size, false);
+        }
+
+        double avg_time = total_time / runs;
+        double gb_s = (2.0 * sizeof(double) * v1.size()) / (avg_time * 1e6);
+        std::cout << "Ring size " << deque_size << " (capacity " << Channel<double, SpscHybrid>(deque_size).capacity() << "): "
+                  << avg_time << " ms (avg of " << runs << " runs), "
+                  << gb_s << " GB/s (" << percent_of_stream(gb_s) << "% of stream)" << std::endl;
+    }
+
+    // Batched transfer: latency vs throughput as a function of block size K and buffer size
+    const size_t n_large = prefix_length("batched transfer", 1 << 22, available);
+    std::vector<size_t> batch_sizes = {1, 16, 256, 4096};
+    std::vector<size_t> buffer_sizes = {64, 1024, 16384};
+
+    v1 = as_vector(*f1, n_large);
+    v2 = as_vector(*f2, n_large);
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "BATCHED TRANSFER (" << v1.size() << " elements)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "buffer,K,time_ms,GB/s,pct_of_stream,mean_latency_us,p99_latency_us" << std::endl;
+
+    for (size_t buffer : buffer_sizes) {
+        for (size_t k : batch_sizes) {
+            BatchResult r = run_experiment_batched(v1, v2, buffer, BatchConfig{k, false, 1, k});
+            std::cout << buffer << "," << k << "," << r.time_ms << "," << r.gb_per_s << ","
+                      << percent_of_stream(r.gb_per_s) << ","
+                      << r.mean_latency_us << "," << r.p99_latency_us << std::endl;
+        }
+
+        BatchResult r = run_experiment_batched(v1, v2, buffer, BatchConfig{0, true, 16, buffer / 2});
+        std::cout << buffer << ",adaptive," << r.time_ms << "," << r.gb_per_s << ","
+                  << percent_of_stream(r.gb_per_s) << ","
+                  << r.mean_latency_us << "," << r.p99_latency_us << std::endl;
     }
 
+    // Multi-producer / multi-consumer scaling against the SPSC path
+    const size_t n_mpmc = prefix_length("MPMC pipeline", 100000000, available);
+    const size_t mpmc_queue_chunks = 1024;
+    std::vector<std::pair<int, int>> thread_splits = {{1, 1}, {2, 2}, {4, 4}, {8, 8}, {16, 16}};
+
+    v1 = as_vector(*f1, n_mpmc);
+    v2 = as_vector(*f2, n_mpmc);
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "MPMC PIPELINE (" << v1.size() << " elements)" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    BatchResult spsc = run_experiment_batched(v1, v2, mpmc_queue_chunks * PRODUCT_CHUNK_SIZE,
+                                              BatchConfig{PRODUCT_CHUNK_SIZE, false, 1, PRODUCT_CHUNK_SIZE});
+    std::cout << "SPSC 1+1 (batched): " << spsc.time_ms << " ms, " << spsc.gb_per_s << " GB/s" << std::endl;
+    std::cout << "\nproducers,consumers,time_ms,GB/s,pct_of_stream,speedup_vs_spsc,rel_error" << std::endl;
+
+    for (const auto& split : thread_splits) {
+        double result = 0.0;
+        double time = run_experiment_mpmc(v1, v2, split.first, split.second, mpmc_queue_chunks, result);
+        double gb_s = (2.0 * sizeof(double) * v1.size()) / (time * 1e6);
+        std::cout << split.first << "," << split.second << "," << time << ","
+                  << gb_s << "," << percent_of_stream(gb_s) << ","
+                  << spsc.time_ms / time << ","
+                  << std::abs(result - spsc.result) / spsc.result << std::endl;
+    }
+
+    // Reduction modes: kernel throughput and error, then cost and reproducibility in the pipelines
+    const size_t n_reduce = prefix_length("reduction modes", STREAM_ELEMENTS, available);
+    v1 = as_vector(*f1, n_reduce);
+    v2 = as_vector(*f2, n_reduce);
+
+    std::vector<double> products(v1.size());
+    multiply_block(v1.data(), v2.data(), products.data(), v1.size());
+    std::vector<std::pair<std::string, std::vector<double>>> datasets;
+    datasets.emplace_back("products", std::move(products));
+    datasets.emplace_back("ill-conditioned", make_ill_conditioned(v1.size()));
+
+    const std::vector<ReductionMode> modes = {ReductionMode::NAIVE, ReductionMode::NEUMAIER,
+                                              ReductionMode::PAIRWISE, ReductionMode::EXACT};
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "REDUCTION MODES (" << v1.size() << " elements)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "dataset,mode,GB/s,cost_vs_naive,rel_error_vs_exact" << std::endl;
+
+    for (const auto& [name, values] : datasets) {
+        double exact = 0.0;
+        benchmark_reduction(values, ReductionMode::EXACT, exact);
+        double naive_gb_s = 0.0;
+
+        for (ReductionMode mode : modes) {
+            double sum = 0.0;
+            double gb_s = benchmark_reduction(values, mode, sum);
+            if (mode == ReductionMode::NAIVE) naive_gb_s = gb_s;
+            std::cout << name << "," << reduction_name(mode) << "," << gb_s << ","
+                      << naive_gb_s / gb_s << "," << std::abs(sum - exact) / std::abs(exact) << std::endl;
+        }
+    }
+
+    // Same modes inside the consumers; EXACT must not depend on how work was split
+    std::vector<std::pair<int, int>> reduce_splits = {{1, 1}, {2, 3}, {4, 4}};
+    std::cout << "\nmode,spsc_ms,mpmc_4x4_ms,bit_identical_across_splits" << std::endl;
+
+    for (ReductionMode mode : modes) {
+        BatchResult spsc_run = run_experiment_batched(v1, v2, mpmc_queue_chunks * PRODUCT_CHUNK_SIZE,
+                                                      BatchConfig{PRODUCT_CHUNK_SIZE, false, 1, PRODUCT_CHUNK_SIZE}, mode);
+        bool identical = true;
+        double mpmc_ms = 0.0;
+
+        for (const auto& split : reduce_splits) {
+            double result = 0.0;
+            mpmc_ms = run_experiment_mpmc(v1, v2, split.first, split.second, mpmc_queue_chunks, result, mode);
+            identical = identical && result == spsc_run.result;
+        }
+
+        std::cout << reduction_name(mode) << "," << spsc_run.time_ms << "," << mpmc_ms << ","
+                  << (identical ? "yes" : "no") << std::endl;
+    }
+
+    // Whole-file pass: streams every mapped element once (multi-GB inputs)
+    v1 = as_vector(*f1, available);
+    v2 = as_vector(*f2, available);
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "FULL FILE STREAM (" << v1.size() << " elements, "
+              << 2.0 * sizeof(double) * v1.size() / (1 << 30) << " GiB)" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    BatchResult full = run_experiment_batched(v1, v2, mpmc_queue_chunks * PRODUCT_CHUNK_SIZE,
+                                              BatchConfig{0, true, PRODUCT_CHUNK_SIZE, 4096});
+    std::cout << "Result: " << full.result << std::endl;
+    std::cout << "Time: " << full.time_ms << " ms, " << full.gb_per_s << " GB/s ("
+              << percent_of_stream(full.gb_per_s) << "% of stream)" << std::endl;
+
 //    std::cout << "\n========================================" << std::endl;
 //    std::cout << "DETAILED RUN (Deque Size = 10)" << std::endl;
 //    std::cout << "========================================" << std::endl;
-//    run_experiment(100, 10, true);  // Smaller vector for detailed output
+//    run_experiment(as_vector(*f1, 100), as_vector(*f2, 100), 10, true);  // Smaller vector for detailed output
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX  // Keep std::min / std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Read-only memory-mapped file.
+ *
+ * - The whole file is mapped once; pages are faulted in on first access, so files
+ *   larger than RAM can be streamed (clean file pages are simply evicted by the OS).
+ * - POSIX mmap on Linux/macOS, CreateFileMapping/MapViewOfFile on Windows.
+ * - MapOptions::sequential advises MADV_SEQUENTIAL: aggressive read-ahead, and pages
+ *   behind the reader are dropped first under memory pressure.
+ * - MapOptions::huge_pages advises MADV_HUGEPAGE (transparent huge pages). This is a
+ *   hint only: for file mappings the kernel honours it only where the filesystem
+ *   supports it (e.g. tmpfs, or CONFIG_READ_ONLY_THP_FOR_FS), otherwise 4 KiB pages stay.
+ * - Throws std::runtime_error if the file cannot be opened or mapped.
+ */
+
+/**
+ * MapOptions: Access hints applied right after mapping.
+ */
+struct MapOptions {
+    bool sequential = false;
+    bool huge_pages = false;
+};
+
+/////////////////////
+///  MAPPED FILE  ///
+/////////////////////
+class MappedFile {
+public:
+    /**
+     * Maps the whole file read-only.
+     * @param path     File to map
+     * @param options  Access hints (see MapOptions)
+     */
+    explicit MappedFile(const std::string& path, MapOptions options = {}) {
+#if defined(_WIN32)
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + path);
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<size_t>(size.QuadPart);
+
+        (void)options;  // FILE_FLAG_SEQUENTIAL_SCAN is always set; no huge pages for file views
+
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data_ = mapping_ != nullptr ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (data_ == nullptr) {
+                if (mapping_ != nullptr) CloseHandle(mapping_);
+                CloseHandle(file_);
+                throw std::runtime_error("Cannot map " + path);
+            }
+        }
+#else
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("Cannot open " + path);
+
+        struct stat st {};
+        fstat(fd_, &st);
+        size_ = static_cast<size_t>(st.st_size);
+
+        if (size_ > 0) {
+            data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (data_ == MAP_FAILED) {
+                data_ = nullptr;
+                close(fd_);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            if (options.sequential) madvise(data_, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            if (options.huge_pages) madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Unmaps the file and closes the handles.
+     */
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_ != nullptr) munmap(data_, size_);
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    /** Start of the mapping (nullptr for an empty file). */
+    const void* data() const { return data_; }
+
+    /** File size in bytes. */
+    size_t size() const { return size_; }
+
+    /**
+     * Hints that [offset, offset + length) will be needed soon (starts read-ahead).
+     * No-op where the platform has no equivalent.
+     */
+    void will_need(size_t offset, size_t length) const {
+#if !defined(_WIN32)
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t begin = offset / page * page;
+        madvise(static_cast<char*>(data_) + begin, offset + length - begin, MADV_WILLNEED);
+#else
+        (void)offset;
+        (void)length;
+#endif
+    }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
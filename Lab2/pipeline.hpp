@@ -0,0 +1,293 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "channel.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Multi-stage streaming pipeline — generalization of the Lab 2 producer/consumer pair
+ *
+ * - A pipeline is a chain: one source, any number of transform stages, one sink.
+ * - Each stage runs on its own group of worker threads.
+ * - Consecutive stages are connected by bounded MPMC channels. A full channel blocks
+ *   the upstream workers (back-pressure), so memory use is bounded by the channel
+ *   capacities no matter how fast the source is.
+ * - When the last worker of a stage finishes, it closes the stage's output channel,
+ *   which lets the downstream stage drain and finish in turn.
+ * - Every worker accounts its time as busy (user code), waiting for input or waiting
+ *   for output; the report names the stage with the highest busy fraction as the bottleneck.
+ */
+
+/////////////////////
+///     STATS     ///
+/////////////////////
+/**
+ * Per-stage counters, accumulated by each worker locally and merged when it exits.
+ */
+struct StageStats {
+    std::string name;
+    int workers = 0;
+    size_t out_capacity = 0;
+
+    std::atomic<uint64_t> items{0};
+    std::atomic<int64_t> busy_ns{0};
+    std::atomic<int64_t> wait_in_ns{0};
+    std::atomic<int64_t> wait_out_ns{0};
+    std::atomic<uint64_t> occupancy_sum{0};
+    std::atomic<uint64_t> occupancy_samples{0};
+};
+
+/**
+ * Worker-local counters (no sharing while running).
+ */
+struct LocalStageStats {
+    uint64_t items = 0;
+    int64_t busy_ns = 0;
+    int64_t wait_in_ns = 0;
+    int64_t wait_out_ns = 0;
+    uint64_t occupancy_sum = 0;
+    uint64_t occupancy_samples = 0;
+
+    /** Adds this worker's counters to the shared stage totals. */
+    void flush(StageStats& stats) const {
+        stats.items += items;
+        stats.busy_ns += busy_ns;
+        stats.wait_in_ns += wait_in_ns;
+        stats.wait_out_ns += wait_out_ns;
+        stats.occupancy_sum += occupancy_sum;
+        stats.occupancy_samples += occupancy_samples;
+    }
+};
+
+/**
+ * Monotonic timestamp in nanoseconds.
+ */
+static inline int64_t pipeline_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/////////////////////
+///    EMITTER    ///
+/////////////////////
+/**
+ * Emitter: What a stage's user function calls to pass an item downstream.
+ * Blocks while the output channel is full (back-pressure) and accounts that time.
+ */
+template <typename T>
+class Emitter {
+public:
+    Emitter(Channel<T, MpmcHybrid>& out, LocalStageStats& local) : out_(out), local_(local) {}
+
+    /** Pushes one item downstream. */
+    void operator()(T&& item) {
+        local_.occupancy_sum += out_.size_approx();
+        local_.occupancy_samples++;
+
+        int64_t t0 = pipeline_now_ns();
+        out_.push(std::move(item));
+        local_.wait_out_ns += pipeline_now_ns() - t0;
+    }
+
+private:
+    Channel<T, MpmcHybrid>& out_;
+    LocalStageStats& local_;
+};
+
+/**
+ * StageHandle: Typed reference to a stage's output, used to attach the next stage.
+ */
+template <typename T>
+struct StageHandle {
+    std::shared_ptr<Channel<T, MpmcHybrid>> out;
+};
+
+/////////////////////
+///   PIPELINE    ///
+/////////////////////
+class Pipeline {
+public:
+    /**
+     * @param channel_capacity  Capacity of every inter-stage channel (items)
+     */
+    explicit Pipeline(size_t channel_capacity) : capacity_(channel_capacity) {}
+
+    /**
+     * Adds the source stage.
+     * @param fn  void(int worker, int workers, Emitter<Out>&) — emits the input stream;
+     *            each worker is told its index so it can take a disjoint share
+     */
+    template <typename Out, typename Fn>
+    StageHandle<Out> source(const std::string& name, int workers, Fn fn) {
+        auto out = std::make_shared<Channel<Out, MpmcHybrid>>(capacity_);
+        StageStats& stats = add_stats(name, workers, out->capacity());
+        auto remaining = std::make_shared<std::atomic<int>>(workers);
+
+        for (int w = 0; w < workers; ++w) {
+            bodies_.push_back([=, &stats]() {
+                LocalStageStats local;
+                Emitter<Out> emit(*out, local);
+
+                int64_t t0 = pipeline_now_ns();
+                uint64_t before = local.occupancy_samples;
+                fn(w, workers, emit);
+                local.items = local.occupancy_samples - before;
+                local.busy_ns = pipeline_now_ns() - t0 - local.wait_out_ns;
+
+                local.flush(stats);
+                if (--*remaining == 0) out->close();
+            });
+        }
+        return StageHandle<Out>{out};
+    }
+
+    /**
+     * Adds a transform stage after `in`.
+     * @param fn  void(In&&, Emitter<Out>&) — may emit zero or more items per input
+     */
+    template <typename Out, typename In, typename Fn>
+    StageHandle<Out> stage(const StageHandle<In>& in, const std::string& name, int workers, Fn fn) {
+        auto input = in.out;
+        auto out = std::make_shared<Channel<Out, MpmcHybrid>>(capacity_);
+        StageStats& stats = add_stats(name, workers, out->capacity());
+        auto remaining = std::make_shared<std::atomic<int>>(workers);
+
+        for (int w = 0; w < workers; ++w) {
+            bodies_.push_back([=, &stats]() {
+                LocalStageStats local;
+                Emitter<Out> emit(*out, local);
+                run_loop(*input, local, [&](In&& item) { fn(std::move(item), emit); });
+
+                local.flush(stats);
+                if (--*remaining == 0) out->close();
+            });
+        }
+        return StageHandle<Out>{out};
+    }
+
+    /**
+     * Adds the sink stage after `in`.
+     * @param fn  void(In&&) — consumes one item (must be thread-safe if workers > 1)
+     */
+    template <typename In, typename Fn>
+    void sink(const StageHandle<In>& in, const std::string& name, int workers, Fn fn) {
+        auto input = in.out;
+        StageStats& stats = add_stats(name, workers, 0);
+
+        for (int w = 0; w < workers; ++w) {
+            bodies_.push_back([=, &stats]() {
+                LocalStageStats local;
+                run_loop(*input, local, [&](In&& item) { fn(std::move(item)); });
+                local.flush(stats);
+            });
+        }
+    }
+
+    /**
+     * Starts every worker of every stage and waits until the stream is drained.
+     */
+    void run() {
+        int64_t t0 = pipeline_now_ns();
+
+        std::vector<std::thread> threads;
+        threads.reserve(bodies_.size());
+        for (auto& body : bodies_) threads.emplace_back(body);
+        for (auto& t : threads) t.join();
+
+        elapsed_ns_ = pipeline_now_ns() - t0;
+    }
+
+    /** Wall time of the last run() in milliseconds. */
+    double elapsed_ms() const { return elapsed_ns_ / 1e6; }
+
+    /**
+     * Prints per-stage throughput, time breakdown and output occupancy, and names
+     * the bottleneck (highest busy fraction).
+     */
+    void report(std::ostream& os) const {
+        os << std::left << std::setw(16) << "stage" << std::right
+           << std::setw(8) << "workers" << std::setw(12) << "items" << std::setw(14) << "items/s"
+           << std::setw(9) << "busy%" << std::setw(9) << "wait_in%" << std::setw(10) << "wait_out%"
+           << std::setw(12) << "occupancy%" << "\n";
+
+        size_t bottleneck = 0;
+        double max_busy = -1.0;
+        for (size_t i = 0; i < stats_.size(); ++i) {
+            const StageStats& s = *stats_[i];
+            double worker_ns = static_cast<double>(elapsed_ns_) * s.workers;
+            double busy = 100.0 * s.busy_ns / worker_ns;
+            double occupancy = s.occupancy_samples == 0 || s.out_capacity == 0 ? 0.0
+                    : 100.0 * s.occupancy_sum / s.occupancy_samples / s.out_capacity;
+
+            os << std::left << std::setw(16) << s.name << std::right << std::fixed << std::setprecision(1)
+               << std::setw(8) << s.workers << std::setw(12) << s.items.load()
+               << std::setw(14) << s.items / (elapsed_ns_ / 1e9)
+               << std::setw(9) << busy
+               << std::setw(9) << 100.0 * s.wait_in_ns / worker_ns
+               << std::setw(10) << 100.0 * s.wait_out_ns / worker_ns
+               << std::setw(12) << occupancy << "\n";
+
+            if (busy > max_busy) {
+                max_busy = busy;
+                bottleneck = i;
+            }
+        }
+
+        if (!stats_.empty()) {
+            os << "Bottleneck stage: " << stats_[bottleneck]->name << "\n";
+        }
+    }
+
+private:
+    size_t capacity_;
+    int64_t elapsed_ns_ = 0;
+    std::vector<std::unique_ptr<StageStats>> stats_;
+    std::vector<std::function<void()>> bodies_;
+
+    StageStats& add_stats(const std::string& name, int workers, size_t out_capacity) {
+        stats_.push_back(std::make_unique<StageStats>());
+        StageStats& s = *stats_.back();
+        s.name = name;
+        s.workers = workers;
+        s.out_capacity = out_capacity;
+        return s;
+    }
+
+    /**
+     * Pops items until the input is closed and drained, splitting time into
+     * waiting for input, waiting for output (accounted by the Emitter) and busy.
+     */
+    template <typename In, typename Body>
+    static void run_loop(Channel<In, MpmcHybrid>& input, LocalStageStats& local, Body&& body) {
+        In item;
+        while (true) {
+            int64_t t0 = pipeline_now_ns();
+            bool got = input.pop(item);
+            int64_t t1 = pipeline_now_ns();
+            local.wait_in_ns += t1 - t0;
+            if (!got) break;
+
+            int64_t wait_out_before = local.wait_out_ns;
+            body(std::move(item));
+            local.busy_ns += pipeline_now_ns() - t1 - (local.wait_out_ns - wait_out_before);
+            local.items++;
+        }
+    }
+};
@@ -0,0 +1,157 @@
+///////////////////////////
+///   IMPORTS SECTION   ///
+///////////////////////////
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "pipeline.hpp"
+#include "simd_kernels.hpp"
+
+
+///////////////////////////
+///  CONSTANTS SECTION  ///
+///////////////////////////
+// Elements per chunk flowing between stages (512 KiB of each input vector)
+constexpr size_t STREAM_CHUNK = 1 << 16;
+
+// Capacity of every inter-stage channel (chunks)
+constexpr size_t STREAM_CAPACITY = 16;
+
+
+///////////////////////////
+///   STRUCTS SECTION   ///
+///////////////////////////
+/**
+ * VectorChunk: Zero-copy view of one chunk of both mapped input vectors.
+ */
+struct VectorChunk {
+    const double* a = nullptr;
+    const double* b = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * ProductBlock: Element-wise products of one chunk.
+ */
+struct ProductBlock {
+    std::vector<double> values;
+};
+
+
+///////////////////////////
+///   HELPERS SECTION   ///
+///////////////////////////
+/**
+ * Straight single-threaded dot product over the mapped files, used by --verify.
+ */
+static double reference_product(const double* a, const double* b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+
+/////////////////////////
+///   MAIN SECTION    ///
+/////////////////////////
+/**
+ * Streaming scalar product of two vectors stored as raw doubles on disk:
+ *
+ *   read (mmap + read-ahead) -> multiply -> partial-reduce -> final-reduce
+ *
+ * The files are memory-mapped, so they may be larger than RAM: back-pressure keeps at
+ * most STREAM_CAPACITY chunks in flight per channel and consumed pages can be evicted.
+ *
+ * Usage: pipeline_demo [v1.bin v2.bin] [--verify]
+ *        The inputs come from the generate_vectors tool (default names v1.bin / v2.bin).
+ */
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    bool verify = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--verify") == 0) verify = true;
+        else files.push_back(argv[i]);
+    }
+
+    if (files.size() != 2) files = {"v1.bin", "v2.bin"};
+
+    std::unique_ptr<MappedFile> f1;
+    std::unique_ptr<MappedFile> f2;
+    try {
+        f1 = std::make_unique<MappedFile>(files[0], MapOptions{true, false});
+        f2 = std::make_unique<MappedFile>(files[1], MapOptions{true, false});
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nCreate the inputs first, e.g.: generate_vectors 100000000 v1.bin v2.bin" << std::endl;
+        return 1;
+    }
+    const size_t n = std::min(f1->size(), f2->size()) / sizeof(double);
+    const double* a = static_cast<const double*>(f1->data());
+    const double* b = static_cast<const double*>(f2->data());
+
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int multiply_workers = std::max(1, cores / 2);
+    const int reduce_workers = std::max(1, cores / 4);
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "STREAMING PIPELINE - SCALAR PRODUCT" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Elements: " << n << " (" << 2.0 * n * sizeof(double) / (1 << 30) << " GiB mapped)" << std::endl;
+    std::cout << "Chunk: " << STREAM_CHUNK << " elements, channel capacity: " << STREAM_CAPACITY << " chunks\n" << std::endl;
+
+    Pipeline pipeline(STREAM_CAPACITY);
+
+    // Stage 1: hand out chunk views; read-ahead is requested one chunk in advance
+    auto chunks = pipeline.source<VectorChunk>("read", 1, [&](int, int, Emitter<VectorChunk>& emit) {
+        for (size_t i = 0; i < n; i += STREAM_CHUNK) {
+            size_t len = std::min(STREAM_CHUNK, n - i);
+            size_t next = i + STREAM_CHUNK;
+            if (next < n) {
+                size_t ahead = std::min(STREAM_CHUNK, n - next) * sizeof(double);
+                f1->will_need(next * sizeof(double), ahead);
+                f2->will_need(next * sizeof(double), ahead);
+            }
+            emit(VectorChunk{a + i, b + i, len});
+        }
+    });
+
+    // Stage 2: element-wise products (this is where the pages are actually faulted in)
+    auto products = pipeline.stage<ProductBlock>(chunks, "multiply", multiply_workers,
+            [](VectorChunk&& chunk, Emitter<ProductBlock>& emit) {
+        ProductBlock block;
+        block.values.resize(chunk.count);
+        multiply_block(chunk.a, chunk.b, block.values.data(), chunk.count);
+        emit(std::move(block));
+    });
+
+    // Stage 3: reduce each block to one partial sum
+    auto partials = pipeline.stage<double>(products, "partial-reduce", reduce_workers,
+            [](ProductBlock&& block, Emitter<double>& emit) {
+        emit(sum_block(block.values.data(), block.values.size()));
+    });
+
+    // Stage 4: accumulate the partial sums
+    double result = 0.0;
+    pipeline.sink(partials, "final-reduce", 1, [&](double&& partial) { result += partial; });
+
+    pipeline.run();
+
+    std::cout << "Result: " << result << std::endl;
+    std::cout << "Time: " << pipeline.elapsed_ms() << " ms ("
+              << 2.0 * n * sizeof(double) / (pipeline.elapsed_ms() / 1e3) / 1e9 << " GB/s)\n" << std::endl;
+    pipeline.report(std::cout);
+
+    if (verify) {
+        double expected = reference_product(a, b, n);
+        double rel = std::abs(result - expected) / std::abs(expected);
+        std::cout << "\nVerification: " << (rel < 1e-9 ? "PASS" : "FAIL") << " (relative error " << rel << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,598 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "simd_kernels.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Reduction modes for the scalar product consumers.
+ *
+ * Every mode is an accumulator with the same interface, so consumers are templated on it:
+ * - add(x, n)     accumulate a block of values
+ * - merge(other)  fold in another accumulator (e.g. another consumer's partial)
+ * - value()       final sum, rounded to double
+ *
+ * | Mode     | Error bound            | Order independent |
+ * |----------|------------------------|-------------------|
+ * | NAIVE    | O(n * eps * sum|x|)    | no                |
+ * | NEUMAIER | O(eps * sum|x|)        | no (last bits)    |
+ * | PAIRWISE | O(log n * eps * sum|x|)| no (last bits)    |
+ * | EXACT    | correctly rounded      | yes, bit-identical|
+ *
+ * EXACT keeps the sum as an integer multiple of 2^-1074 (the smallest subnormal), so
+ * every addition is exact and associative: the result does not depend on chunking,
+ * thread count or the order consumers are merged in.
+ */
+
+enum class ReductionMode {
+    NAIVE,
+    NEUMAIER,
+    PAIRWISE,
+    EXACT
+};
+
+static inline const char* reduction_name(ReductionMode mode) {
+    switch (mode) {
+        case ReductionMode::NAIVE: return "naive";
+        case ReductionMode::NEUMAIER: return "neumaier";
+        case ReductionMode::PAIRWISE: return "pairwise";
+        case ReductionMode::EXACT: return "exact";
+    }
+    return "?";
+}
+
+/////////////////////
+///     NAIVE     ///
+/////////////////////
+/**
+ * NaiveAccumulator: Plain running sum (the original consumer behaviour).
+ */
+class NaiveAccumulator {
+public:
+    void add(const double* x, size_t n) { sum_ += sum_block(x, n); }
+    void merge(NaiveAccumulator& other) { sum_ += other.sum_; }
+    double value() { return sum_; }
+
+private:
+    double sum_ = 0.0;
+};
+
+/////////////////////
+///   NEUMAIER    ///
+/////////////////////
+/**
+ * NeumaierAccumulator: Kahan-Babuska-Neumaier compensated summation.
+ *
+ * Unlike plain Kahan it also compensates when the incoming value is larger than the
+ * running sum. The AVX path keeps 8 independent (sum, compensation) lanes.
+ */
+class NeumaierAccumulator {
+public:
+    void add(const double* x, size_t n) {
+        size_t i = 0;
+#if defined(__AVX__)
+        const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        __m256d s0 = _mm256_load_pd(sum_), s1 = _mm256_load_pd(sum_ + 4);
+        __m256d c0 = _mm256_load_pd(comp_), c1 = _mm256_load_pd(comp_ + 4);
+
+        auto step = [&](__m256d& s, __m256d& c, __m256d v) {
+            __m256d t = _mm256_add_pd(s, v);
+            __m256d s_bigger = _mm256_cmp_pd(_mm256_and_pd(s, abs_mask), _mm256_and_pd(v, abs_mask), _CMP_GE_OQ);
+            __m256d big = _mm256_blendv_pd(v, s, s_bigger);
+            __m256d small = _mm256_blendv_pd(s, v, s_bigger);
+            c = _mm256_add_pd(c, _mm256_add_pd(_mm256_sub_pd(big, t), small));
+            s = t;
+        };
+
+        for (; i + 8 <= n; i += 8) {
+            step(s0, c0, _mm256_loadu_pd(x + i));
+            step(s1, c1, _mm256_loadu_pd(x + i + 4));
+        }
+
+        _mm256_store_pd(sum_, s0);
+        _mm256_store_pd(sum_ + 4, s1);
+        _mm256_store_pd(comp_, c0);
+        _mm256_store_pd(comp_ + 4, c1);
+#endif
+        for (; i < n; ++i) {
+            add_scalar(sum_[i % LANES], comp_[i % LANES], x[i]);
+        }
+    }
+
+    void merge(NeumaierAccumulator& other) {
+        for (size_t l = 0; l < LANES; ++l) {
+            add_scalar(sum_[l], comp_[l], other.sum_[l]);
+            comp_[l] += other.comp_[l];
+        }
+    }
+
+    double value() {
+        double s = 0.0, c = 0.0;
+        for (size_t l = 0; l < LANES; ++l) {
+            add_scalar(s, c, sum_[l]);
+            c += comp_[l];
+        }
+        return s + c;
+    }
+
+private:
+    static constexpr size_t LANES = 8;
+    alignas(32) double sum_[LANES] = {};
+    alignas(32) double comp_[LANES] = {};
+
+    static void add_scalar(double& s, double& c, double v) {
+        double t = s + v;
+        c += std::abs(s) >= std::abs(v) ? (s - t) + v : (v - t) + s;
+        s = t;
+    }
+};
+
+/////////////////////
+///   PAIRWISE    ///
+/////////////////////
+/**
+ * PairwiseAccumulator: Streaming pairwise (cascade) summation.
+ *
+ * Input is cut into PAIRWISE_BLOCK-element leaves summed with sum_block; leaf sums
+ * are combined like a binary counter, so two partials are only added when they cover
+ * the same number of leaves - the tree of a recursive pairwise sum, built online.
+ */
+class PairwiseAccumulator {
+public:
+    static constexpr size_t PAIRWISE_BLOCK = 128;
+
+    PairwiseAccumulator() : leaf_(PAIRWISE_BLOCK) {}
+
+    void add(const double* x, size_t n) {
+        // Top up a partially filled leaf first
+        if (fill_ > 0) {
+            size_t take = std::min(n, PAIRWISE_BLOCK - fill_);
+            std::memcpy(leaf_.data() + fill_, x, take * sizeof(double));
+            fill_ += take;
+            x += take;
+            n -= take;
+            if (fill_ == PAIRWISE_BLOCK) {
+                push(sum_block(leaf_.data(), leaf_.size()), 0);
+                fill_ = 0;
+            }
+        }
+
+        // Whole leaves straight from the input
+        for (; n >= PAIRWISE_BLOCK; x += PAIRWISE_BLOCK, n -= PAIRWISE_BLOCK) {
+            push(sum_block(x, leaf_.size()), 0);
+        }
+
+        std::memcpy(leaf_.data() + fill_, x, n * sizeof(double));
+        fill_ += n;
+    }
+
+    void merge(PairwiseAccumulator& other) {
+        for (size_t level = 0; level < other.levels_.size(); ++level) {
+            if (other.occupied_[level]) push(other.levels_[level], level);
+        }
+        add(other.leaf_.data(), other.fill_);
+    }
+
+    double value() {
+        double total = sum_block(leaf_.data(), fill_);
+        for (size_t level = 0; level < levels_.size(); ++level) {
+            if (occupied_[level]) total += levels_[level];
+        }
+        return total;
+    }
+
+private:
+    std::vector<double> leaf_;
+    size_t fill_ = 0;
+    std::vector<double> levels_;
+    std::vector<bool> occupied_;
+
+    /** Inserts a partial covering 2^level leaves, carrying into higher levels. */
+    void push(double partial, size_t level) {
+        while (true) {
+            if (level == levels_.size()) {
+                levels_.push_back(0.0);
+                occupied_.push_back(false);
+            }
+            if (!occupied_[level]) {
+                levels_[level] = partial;
+                occupied_[level] = true;
+                return;
+            }
+            partial += levels_[level];
+            occupied_[level] = false;
+            ++level;
+        }
+    }
+};
+
+/////////////////////
+///     EXACT     ///
+/////////////////////
+/**
+ * ExactAccumulator: Error-free superaccumulator.
+ *
+ * The running sum is an integer multiple of 2^-1074, stored as 32-bit digits in int64
+ * limbs - wide enough for any finite double sum. Values get there in two ways:
+ *
+ * 1. Vector path (AVX2): blocks of up to EXTRACT_BLOCK values are split error-free into
+ *    2..MAX_BINS fixed-point bins (ExtractScalar, Rump, Ogita, Oishi 2008). A bin is a
+ *    double S kept in [2^k, 2^(k+1)); for |x| <= 2^(k - BIN_HEADROOM), t = S + x,
+ *    q = t - S and x - q are all exact and q is a multiple of ulp(S), so S = t absorbs
+ *    the top bits of x and the remainder feeds the next bin, BIN_BITS lower. Only adds
+ *    and subtracts, 4 lanes wide, no data-dependent memory access; the number of bins
+ *    follows the exponent range of the block.
+ * 2. Slot path: bin totals, remainders left after the last bin, and whole blocks the
+ *    bins cannot take (Inf/NaN, magnitudes near overflow or underflow) are split into
+ *    exponent and signed 53-bit mantissa; the mantissa is added to an int64 slot per
+ *    exponent, and the slots are shifted into the limbs before any can overflow.
+ *
+ * Every step is exact, so where blocks start does not matter. value() rounds to the
+ * nearest double (ties to even); Inf/NaN inputs are summed separately and dominate the
+ * result, as they would in floating point.
+ */
+class ExactAccumulator {
+public:
+    ExactAccumulator() : table_(EXPONENTS, 0), limbs_(LIMBS, 0) {}
+
+    void add(const double* x, size_t n) {
+#if defined(__AVX2__)
+        // Software-pipelined: the range scan of block i + 1 (integer units, memory stream)
+        // runs inside the extraction loop of block i (FP units), which also prefetches
+        // the block after it
+        size_t full = n / EXTRACT_BLOCK * EXTRACT_BLOCK;
+        if (full > 0) {
+            BlockRange range = scan(x, EXTRACT_BLOCK);
+            for (size_t i = 0; i < full; i += EXTRACT_BLOCK) {
+                const double* next = i + EXTRACT_BLOCK < full ? x + i + EXTRACT_BLOCK : x + i;
+                range = add_block(x + i, EXTRACT_BLOCK, range, next);
+            }
+        }
+        if (full < n) {
+            size_t rest = n - full;
+            add_block(x + full, rest, scan(x + full, rest / EXTRACT_STEP * EXTRACT_STEP), x + full);
+        }
+#else
+        for (size_t i = 0; i < n; ++i) add_value(x[i]);
+#endif
+    }
+
+    void merge(ExactAccumulator& other) {
+        flush();
+        other.flush();
+        for (size_t i = 0; i < LIMBS; ++i) limbs_[i] += other.limbs_[i];
+        limb_adds_ += other.limb_adds_ + 1;
+        if (limb_adds_ >= NORMALIZE_INTERVAL) {
+            normalize(limbs_);
+            limb_adds_ = 0;
+        }
+        special_ += other.special_;
+        has_special_ = has_special_ || other.has_special_;
+    }
+
+    double value() {
+        flush();
+        if (has_special_) return special_;
+
+        std::vector<int64_t> digits = limbs_;
+        normalize(digits);
+
+        // Sign-magnitude: negate a negative total, then re-normalize digits into [0, 2^32)
+        bool negative = digits[LIMBS - 1] < 0;
+        if (negative) {
+            for (int64_t& d : digits) d = -d;
+            normalize(digits);
+        }
+
+        int top = LIMBS - 1;
+        while (top >= 0 && digits[top] == 0) --top;
+        if (top < 0) return 0.0;
+
+        double magnitude = round_to_double(digits, top);
+        return negative ? -magnitude : magnitude;
+    }
+
+private:
+    // Vector path: values per block and per loop step (4 AVX vectors), at most MAX_BINS
+    // bins of BIN_BITS each. Each bin accumulator absorbs EXTRACT_BLOCK / EXTRACT_STEP = 2^6
+    // values of at most 2^-BIN_HEADROOM of its magnitude: drift <= 2^-2, stays in its binade
+    static constexpr size_t EXTRACT_BLOCK = 1024;
+    static constexpr size_t EXTRACT_STEP = 16;
+    static constexpr int MAX_BINS = 4;
+    static constexpr int BIN_HEADROOM = 8;
+    static constexpr int BIN_BITS = 53 - BIN_HEADROOM;
+
+    static constexpr size_t EXPONENTS = 2048;
+    static constexpr size_t LIMB_BITS = 32;
+    // 2^-1074 .. 2^1024 is 2098 bits, plus 64 bits of headroom for the element count
+    static constexpr size_t LIMBS = (2098 + 64) / LIMB_BITS + 2;
+    // Mantissas are < 2^53, so a slot survives 1024 additions: |slot| < 2^63
+    static constexpr size_t SLOT_ADDS = 1024;
+    // Limb updates are < 2^32 in magnitude: carry-propagate well before 2^63
+    static constexpr uint64_t NORMALIZE_INTERVAL = uint64_t(1) << 30;
+    static constexpr uint64_t MANTISSA_MASK = (uint64_t(1) << 52) - 1;
+
+    std::vector<int64_t> table_;
+    std::vector<int64_t> limbs_;
+    size_t pending_ = 0;
+    int exp_min_ = EXPONENTS;
+    int exp_max_ = -1;
+    uint64_t limb_adds_ = 0;
+    double special_ = 0.0;
+    bool has_special_ = false;
+
+    /** Adds one value exactly through the slot table. */
+    void add_value(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        int e = static_cast<int>((bits >> 52) & 0x7FF);
+        if (e == 0x7FF) {
+            special_ += v;
+            has_special_ = true;
+            return;
+        }
+        if (bits << 1 == 0) return;
+
+        if (pending_ == SLOT_ADDS) flush();
+        int64_t m = static_cast<int64_t>((bits & MANTISSA_MASK) | (e != 0 ? uint64_t(1) << 52 : 0));
+        table_[e] += (bits >> 63) ? -m : m;
+        exp_min_ = std::min(exp_min_, e);
+        exp_max_ = std::max(exp_max_, e);
+        ++pending_;
+    }
+
+#if defined(__AVX2__)
+    /**
+     * Exponent range of a block from integer ops only (the FP units are the bottleneck of
+     * the extraction): the upper 32 bits of |x| order like |x|, so their max gives the top
+     * exponent (and Inf/NaN), and the unsigned min of |x| - 1 the lowest exponent of a
+     * nonzero value (zeros wrap around to the maximum).
+     */
+    struct BlockRange {
+        uint32_t max_high;
+        uint32_t min_high;
+    };
+
+    static inline void scan_step(const double* x, __m256i& max_bits, __m256i& min_bits) {
+        const __m256i abs_mask = _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL);
+        __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)), abs_mask);
+        max_bits = _mm256_max_epi32(max_bits, a);
+        min_bits = _mm256_min_epu32(min_bits, _mm256_sub_epi64(a, _mm256_set1_epi64x(1)));
+    }
+
+    /**
+     * Prefetch hint for the value `distance` elements past p. It usually lies past the
+     * end of the caller's span (the stream continues in the next add() call); a prefetch
+     * never faults, and the address is formed as an integer, not as a pointer.
+     */
+    static inline void prefetch(const double* p, size_t distance) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(p) + distance * sizeof(double);
+        _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+    }
+
+    static BlockRange to_range(__m256i max_bits, __m256i min_bits) {
+        alignas(32) uint32_t words[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words), max_bits);
+        uint32_t max_high = std::max(std::max(words[1], words[3]), std::max(words[5], words[7]));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words), min_bits);
+        uint32_t min_high = std::min(std::min(words[1], words[3]), std::min(words[5], words[7]));
+        return BlockRange{max_high, min_high};
+    }
+
+    /** Range of the first n values (n a multiple of 4). */
+    static BlockRange scan(const double* x, size_t n) {
+        __m256i max_bits = _mm256_setzero_si256();
+        __m256i min_bits = _mm256_set1_epi32(-1);
+        for (size_t i = 0; i < n; i += 4) scan_step(x + i, max_bits, min_bits);
+        return to_range(max_bits, min_bits);
+    }
+
+    /**
+     * Adds n <= EXTRACT_BLOCK values, through the bins when `range` (of the first
+     * n / EXTRACT_STEP * EXTRACT_STEP values) allows it, and returns the range of as
+     * many values of `next`.
+     */
+    BlockRange add_block(const double* x, size_t n, BlockRange range, const double* next) {
+        const size_t vec_n = n / EXTRACT_STEP * EXTRACT_STEP;
+        __m256i max_bits = _mm256_setzero_si256();
+        __m256i min_bits = _mm256_set1_epi32(-1);
+        size_t i = 0;
+
+        const int max_field = static_cast<int>(range.max_high >> 20);
+        if (range.max_high != 0 && max_field < 2047) {
+            const int max_exp = max_field - 1022;                                // max |x| < 2^max_exp
+            const int min_exp = std::max(static_cast<int>(range.min_high >> 20), 1) - 1022;  // last bit >= 2^(min_exp - 53)
+            const int top = max_exp + BIN_HEADROOM;                              // first bin S in [2^top, 2^(top+1))
+
+            // Bins until the last one's ulp reaches the smallest value's last bit; fewer if
+            // that needs more than MAX_BINS or leaves the normal range, and then whatever
+            // the bins cannot hold is checked for and added through the slots
+            const int needed = 1 + (top - min_exp + 1 + BIN_BITS - 1) / BIN_BITS;
+            int bins = std::min(needed, MAX_BINS);
+            while (bins > 2 && top - (bins - 1) * BIN_BITS - 52 < -1022) --bins;
+
+            if (top <= 1022 && top - (bins - 1) * BIN_BITS - 52 >= -1022) {
+                switch (bins + (bins == needed ? 0 : 8)) {
+                    case 2: extract<2, false>(x, vec_n, top, next, max_bits, min_bits); break;
+                    case 3: extract<3, false>(x, vec_n, top, next, max_bits, min_bits); break;
+                    case 4: extract<4, false>(x, vec_n, top, next, max_bits, min_bits); break;
+                    case 10: extract<2, true>(x, vec_n, top, next, max_bits, min_bits); break;
+                    case 11: extract<3, true>(x, vec_n, top, next, max_bits, min_bits); break;
+                    default: extract<MAX_BINS, true>(x, vec_n, top, next, max_bits, min_bits); break;
+                }
+                i = vec_n;
+            }
+        }
+
+        if (i == 0) {
+            for (size_t j = 0; j < vec_n; j += 4) scan_step(next + j, max_bits, min_bits);
+        }
+        for (; i < n; ++i) add_value(x[i]);
+        return to_range(max_bits, min_bits);
+    }
+
+    /**
+     * Pass 2: peels B bins off each of the n values (n a multiple of EXTRACT_STEP), and
+     * scans the next n values meanwhile. The block after `next` is prefetched, so the
+     * scan's loads hit the cache instead of stalling the FP work behind memory misses.
+     * Bin k starts at S = 1.5 * 2^(top - k * BIN_BITS); at most EXTRACT_BLOCK / EXTRACT_STEP
+     * q's of magnitude <= 2^-BIN_HEADROOM * 2^(top - k * BIN_BITS) are absorbed per S, so S
+     * never leaves its binade. With RESIDUAL, bits below the last bin are possible and
+     * are passed on to the slots.
+     */
+    template <int B, bool RESIDUAL>
+    void extract(const double* x, size_t n, int top, const double* next, __m256i& max_bits, __m256i& min_bits) {
+        constexpr int U = EXTRACT_STEP / 4;
+        __m256d sigma[B];
+        __m256d acc[B][U];
+        for (int k = 0; k < B; ++k) {
+            sigma[k] = _mm256_set1_pd(1.5 * std::ldexp(1.0, top - k * BIN_BITS));
+            for (int u = 0; u < U; ++u) acc[k][u] = sigma[k];
+        }
+
+        for (size_t i = 0; i < n; i += EXTRACT_STEP) {
+            __m256d p[U];
+            for (int u = 0; u < U; ++u) p[u] = _mm256_loadu_pd(x + i + 4 * u);
+            for (int k = 0; k < B; ++k) {
+                for (int u = 0; u < U; ++u) {
+                    __m256d t = _mm256_add_pd(acc[k][u], p[u]);
+                    if (RESIDUAL || k + 1 < B) p[u] = _mm256_sub_pd(p[u], _mm256_sub_pd(t, acc[k][u]));
+                    acc[k][u] = t;
+                }
+            }
+            for (int u = 0; u < U; ++u) scan_step(next + i + 4 * u, max_bits, min_bits);
+            for (size_t line = 0; line < EXTRACT_STEP; line += 64 / sizeof(double)) {
+                prefetch(next + i + line, EXTRACT_BLOCK);
+            }
+
+            if constexpr (RESIDUAL) {
+                __m256d left = p[0];
+                for (int u = 1; u < U; ++u) left = _mm256_or_pd(left, p[u]);
+                if (_mm256_movemask_pd(_mm256_cmp_pd(left, _mm256_setzero_pd(), _CMP_NEQ_OQ)) != 0) {
+                    alignas(32) double rest[EXTRACT_STEP];
+                    for (int u = 0; u < U; ++u) _mm256_store_pd(rest + 4 * u, p[u]);
+                    for (double r : rest) add_value(r);
+                }
+            }
+        }
+
+        // S - sigma is exact (Sterbenz); U of them sum exactly (|sum| <= 2^top_k, ulp-aligned)
+        alignas(32) double lanes[4];
+        for (int k = 0; k < B; ++k) {
+            __m256d bin = _mm256_sub_pd(acc[k][0], sigma[k]);
+            for (int u = 1; u < U; ++u) bin = _mm256_add_pd(bin, _mm256_sub_pd(acc[k][u], sigma[k]));
+            _mm256_store_pd(lanes, bin);
+            for (double v : lanes) add_value(v);
+        }
+    }
+#endif
+
+    /** Moves every used slot into the limbs and clears the table. */
+    void flush() {
+        for (int e = exp_min_; e <= exp_max_; ++e) {
+            int64_t& slot = table_[e];
+            if (slot != 0) {
+                // value = slot * 2^(max(e, 1) - 1075) = slot * 2^shift * 2^-1074
+                add_shifted(slot, static_cast<size_t>(std::max(e, 1) - 1));
+                slot = 0;
+            }
+        }
+        pending_ = 0;
+        exp_min_ = EXPONENTS;
+        exp_max_ = -1;
+    }
+
+    /** limbs += v * 2^shift, split into updates below 2^32 in magnitude. */
+    void add_shifted(int64_t v, size_t shift) {
+        const size_t k = shift / LIMB_BITS;
+        const int r = static_cast<int>(shift % LIMB_BITS);
+        const int64_t low_mask = 0xFFFFFFFFLL;
+
+        // v = hi * 2^32 + lo with lo in [0, 2^32)
+        int64_t lo = v & low_mask;
+        int64_t hi = v >> 32;
+
+        uint64_t lo_shifted = static_cast<uint64_t>(lo) << r;             // < 2^63
+        limbs_[k] += static_cast<int64_t>(lo_shifted & low_mask);
+        limbs_[k + 1] += static_cast<int64_t>(lo_shifted >> 32);
+
+        int64_t hi_shifted = hi * (int64_t(1) << r);                      // |.| < 2^62
+        limbs_[k + 1] += hi_shifted & low_mask;
+        limbs_[k + 2] += hi_shifted >> 32;
+
+        if (++limb_adds_ >= NORMALIZE_INTERVAL) {
+            normalize(limbs_);
+            limb_adds_ = 0;
+        }
+    }
+
+    /** Carry-propagates so every limb but the top one lies in [0, 2^32). */
+    static void normalize(std::vector<int64_t>& digits) {
+        for (size_t i = 0; i + 1 < digits.size(); ++i) {
+            int64_t carry = digits[i] >> 32;
+            digits[i] -= carry * (int64_t(1) << 32);
+            digits[i + 1] += carry;
+        }
+    }
+
+    /** Rounds the non-negative normalized integer digits * 2^-1074 to nearest, ties to even. */
+    static double round_to_double(const std::vector<int64_t>& digits, int top) {
+        auto digit = [&](int i) -> uint64_t { return i >= 0 ? static_cast<uint64_t>(digits[i]) : 0; };
+
+        int width = 0;
+        while (width < 64 && (digit(top) >> width) != 0) ++width;
+        const int total_bits = top * static_cast<int>(LIMB_BITS) + width;
+
+        // Small enough to convert exactly
+        if (total_bits <= 64) {
+            uint64_t value = digit(0) | (digit(1) << 32);
+            return std::ldexp(static_cast<double>(value), -1074);
+        }
+
+        // Top 64 bits [p, p + 64) plus a sticky bit for everything below
+        const int p = total_bits - 64;
+        const int q = p / static_cast<int>(LIMB_BITS);
+        const int off = p % static_cast<int>(LIMB_BITS);
+        uint64_t window = off == 0
+                ? digit(q) | (digit(q + 1) << 32)
+                : (digit(q) >> off) | (digit(q + 1) << (32 - off)) | (digit(q + 2) << (64 - off));
+
+        bool sticky = off != 0 && (digit(q) & ((uint64_t(1) << off) - 1)) != 0;
+        for (int i = 0; i < q && !sticky; ++i) sticky = digits[i] != 0;
+
+        uint64_t mantissa = window >> 11;
+        uint64_t rest = window & 0x7FF;
+        const uint64_t half = 0x400;
+        if (rest > half || (rest == half && (sticky || (mantissa & 1)))) ++mantissa;
+
+        return std::ldexp(static_cast<double>(mantissa), p + 11 - 1074);
+    }
+};
+
+/////////////////////
+///   DISPATCH    ///
+/////////////////////
+/**
+ * Calls fn(Accumulator{}) with the accumulator type selected by `mode`, so callers can
+ * instantiate their templated consumers from a runtime choice.
+ */
+template <typename Fn>
+static auto with_accumulator(ReductionMode mode, Fn&& fn) {
+    switch (mode) {
+        case ReductionMode::NEUMAIER: return fn(NeumaierAccumulator{});
+        case ReductionMode::PAIRWISE: return fn(PairwiseAccumulator{});
+        case ReductionMode::EXACT: return fn(ExactAccumulator{});
+        case ReductionMode::NAIVE:
+        default: return fn(NaiveAccumulator{});
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * SIMD kernels shared by the scalar product pipelines.
+ *
+ * - The vector width is chosen at compile time (AVX, SSE2, scalar fallback);
+ *   build with -march=native to get the AVX path.
+ * - All loads/stores are unaligned, so callers may pass arbitrary sub-ranges.
+ */
+
+/////////////////////
+///    KERNELS    ///
+/////////////////////
+/**
+ * Element-wise product of two blocks: out[i] = a[i] * b[i].
+ * Uses AVX (4 doubles per step) or SSE2 (2 doubles) when available, scalar tail/fallback.
+ */
+static inline void multiply_block(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+/**
+ * Vectorised sum of a block.
+ * Keeps several independent vector accumulators to hide floating-point add latency.
+ */
+static inline double sum_block(const double* x, size_t n) {
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__AVX__)
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(x + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(x + i + 4));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(x + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(x + i + 2));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; ++i) {
+        total += x[i];
+    }
+    return total;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Batched small-matrix GEMM: C[b] = A[b] x B[b] for many n x n matrices (n ~ 2..32).
+ *
+ * Layout (interleaved structure of arrays): the batch is cut into packs of `lanes`
+ * matrices, and element (i, j) of the matrices of one pack is stored as `lanes`
+ * consecutive values, one per matrix:
+ *
+ *   pack p = b / lanes, lane l = b % lanes
+ *   data[p * n*n*lanes + (i*n + j) * lanes + l] = M[b](i, j)
+ *
+ * `lanes` is the vector width of the selected kernel (batched_gemm_lanes), so one
+ * vector load fetches element (i, j) of `lanes` matrices and the product is a plain
+ * n x n x n triple loop of vertical vector multiply-adds, with no shuffles,
+ * broadcasts or horizontal sums. A small matrix gives the packed engine nothing to
+ * block: its MR x NR tile is larger than the whole product. Here every multiply-add
+ * instead does useful work in every lane.
+ *
+ * Kernels: instantiated per instruction set (the Avx512Ops / Avx2Ops of
+ * packed_gemm.hpp, scalar loops otherwise) for the compile-time sizes 2, 3, 4, 5, 6,
+ * 8, 12, 16, 24 and 32 (batched_fixed_size). Every loop bound is then a constant,
+ * so the compiler unrolls the j and k loops and keeps the accumulators in registers.
+ * A row of C is computed in blocks of JB columns, with JB the largest divisor of n
+ * within the register budget. Other sizes use the same kernel with a run-time n.
+ *
+ * Parallelism: the packs are split into contiguous ranges, several per pool worker.
+ * Matrices are independent, so there is no synchronisation beyond the pool's join.
+ * The last pack is padded with zero matrices.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Pack ranges per pool worker (several, so faster workers absorb slow ones)
+constexpr int BATCHED_TASKS_PER_WORKER = 4;
+
+// Interleave width of the scalar kernels (vectorisable by the compiler on any target)
+constexpr int BATCHED_SCALAR_LANES = 8;
+
+/////////////////////
+///    TYPES      ///
+/////////////////////
+/**
+ * MatrixBatch: `count` n x n matrices in the interleaved layout with `lanes` lanes.
+ */
+template <typename T>
+struct MatrixBatch {
+    int n = 0;
+    int count = 0;
+    int lanes = 1;
+    AlignedBuffer<T> data;
+
+    int64_t packs() const { return (static_cast<int64_t>(count) + lanes - 1) / lanes; }
+    size_t pack_size() const { return static_cast<size_t>(n) * n * lanes; }
+
+    T& at(int b, int i, int j) {
+        return data[(b / lanes) * pack_size() + (static_cast<size_t>(i) * n + j) * lanes + b % lanes];
+    }
+    const T& at(int b, int i, int j) const {
+        return data[(b / lanes) * pack_size() + (static_cast<size_t>(i) * n + j) * lanes + b % lanes];
+    }
+};
+
+/**
+ * Zero-initialised batch of `count` n x n matrices with `lanes` lanes per pack.
+ */
+template <typename T>
+static MatrixBatch<T> make_matrix_batch(int count, int n, int lanes) {
+    MatrixBatch<T> batch;
+    batch.n = n;
+    batch.count = count;
+    batch.lanes = lanes;
+    const size_t size = static_cast<size_t>(batch.packs()) * batch.pack_size();
+    batch.data = make_aligned_buffer<T>(size);
+    std::fill(batch.data.get(), batch.data.get() + size, T(0));
+    return batch;
+}
+
+/**
+ * BatchedKernel: Product of `packs` consecutive packs of n x n matrices.
+ */
+template <typename T, typename Acc>
+struct BatchedKernel {
+    std::string name;
+    int n;
+    int lanes;
+    void (*compute)(int n, int64_t packs, const T* a, const T* b, Acc* c);
+};
+
+/////////////////////
+///    KERNELS    ///
+/////////////////////
+/**
+ * Largest divisor of n that is at most `limit` (the register block of a C row).
+ */
+static constexpr int batched_row_block(int n, int limit) {
+    for (int jb = std::min(n, limit); jb > 1; --jb) {
+        if (n % jb == 0) return jb;
+    }
+    return 1;
+}
+
+/**
+ * Portable kernel: the same loop nest over arrays of BATCHED_SCALAR_LANES values.
+ * N > 0: compile-time size, N = 0: run-time n.
+ */
+template <typename T, typename Acc, int N>
+static void batched_kernel_scalar(int n_rt, int64_t packs, const T* a, const T* b, Acc* c) {
+    constexpr int L = BATCHED_SCALAR_LANES;
+    const int n = N > 0 ? N : n_rt;
+    const size_t pack = static_cast<size_t>(n) * n * L;
+
+    for (int64_t p = 0; p < packs; ++p, a += pack, b += pack, c += pack) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                Acc acc[L] = {};
+                for (int k = 0; k < n; ++k) {
+                    const T* av = a + (i * n + k) * L;
+                    const T* bv = b + (k * n + j) * L;
+                    for (int l = 0; l < L; ++l) acc[l] += static_cast<Acc>(av[l]) * static_cast<Acc>(bv[l]);
+                }
+                std::copy_n(acc, L, c + (i * n + j) * L);
+            }
+        }
+    }
+}
+
+#if PACKED_GEMM_X86
+/**
+ * Defines batched_kernel_<ISA><Ops, N>, compiled for TARGET, on the Ops of
+ * packed_gemm.hpp (LANES values per vector, load_b loads and widens LANES elements).
+ * JB_MAX is the register budget for a block of C row accumulators.
+ */
+#define BATCHED_DEFINE_SIMD_KERNEL(ISA, TARGET, JB_MAX)                                           \
+    template <typename Ops, int N>                                                                \
+    __attribute__((target(TARGET)))                                                               \
+    static void batched_kernel_##ISA(int n_rt, int64_t packs, const typename Ops::T* a,           \
+                                     const typename Ops::T* b, typename Ops::Acc* c) {            \
+        constexpr int L = Ops::LANES;                                                             \
+        constexpr int JB = N > 0 ? batched_row_block(N, JB_MAX) : JB_MAX;                         \
+        const int n = N > 0 ? N : n_rt;                                                           \
+        const size_t pack = static_cast<size_t>(n) * n * L;                                       \
+                                                                                                  \
+        for (int64_t p = 0; p < packs; ++p, a += pack, b += pack, c += pack) {                    \
+            for (int i = 0; i < n; ++i) {                                                         \
+                for (int j0 = 0; j0 < n; j0 += JB) {                                              \
+                    const int jb = N > 0 ? JB : std::min(JB, n - j0);                             \
+                    typename Ops::Vec acc[JB];                                                    \
+                    for (int j = 0; j < JB; ++j) acc[j] = Ops::zero();                            \
+                                                                                                  \
+                    _Pragma("GCC unroll 8")                                                       \
+                    for (int k = 0; k < n; ++k) {                                                 \
+                        typename Ops::Vec av = Ops::load_b(a + (i * n + k) * L);                  \
+                        const typename Ops::T* bv = b + (k * n + j0) * L;                         \
+                        _Pragma("GCC unroll 32")                                                  \
+                        for (int j = 0; j < JB; ++j) {                                            \
+                            if (j < jb) acc[j] = Ops::madd(acc[j], av, Ops::load_b(bv + j * L));  \
+                        }                                                                         \
+                    }                                                                             \
+                                                                                                  \
+                    for (int j = 0; j < jb; ++j) Ops::store(c + (i * n + j0 + j) * L, acc[j]);    \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+    }
+
+BATCHED_DEFINE_SIMD_KERNEL(avx2, GEMM_AVX2_TARGET, 8)
+// Same GCC false positive as the AVX-512 kernels in packed_gemm.hpp (the widening
+// loads of Avx512Ops<int32_t, int64_t>)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+BATCHED_DEFINE_SIMD_KERNEL(avx512, GEMM_AVX512_TARGET, 16)
+#pragma GCC diagnostic pop
+
+#undef BATCHED_DEFINE_SIMD_KERNEL
+#endif
+
+/**
+ * True for the sizes with a compile-time kernel instance.
+ */
+static constexpr bool batched_fixed_size(int n) {
+    for (int size : {2, 3, 4, 5, 6, 8, 12, 16, 24, 32}) {
+        if (n == size) return true;
+    }
+    return false;
+}
+
+/**
+ * Kernel instance for size n: the compile-time instance for the sizes of
+ * batched_fixed_size, the run-time-n instance (N = 0) otherwise.
+ */
+template <typename Fn, typename Kernels>
+static Fn batched_instance(int n) {
+    switch (n) {
+        case 2: return Kernels::template get<2>();
+        case 3: return Kernels::template get<3>();
+        case 4: return Kernels::template get<4>();
+        case 5: return Kernels::template get<5>();
+        case 6: return Kernels::template get<6>();
+        case 8: return Kernels::template get<8>();
+        case 12: return Kernels::template get<12>();
+        case 16: return Kernels::template get<16>();
+        case 24: return Kernels::template get<24>();
+        case 32: return Kernels::template get<32>();
+        default: return Kernels::template get<0>();
+    }
+}
+
+/**
+ * Kernel families for batched_instance: get<N>() is the family's instance for N.
+ */
+template <typename T, typename Acc>
+struct BatchedScalarKernels {
+    template <int N>
+    static auto get() { return batched_kernel_scalar<T, Acc, N>; }
+};
+
+#if PACKED_GEMM_X86
+template <typename Ops>
+struct BatchedAvx2Kernels {
+    template <int N>
+    static auto get() { return batched_kernel_avx2<Ops, N>; }
+};
+
+template <typename Ops>
+struct BatchedAvx512Kernels {
+    template <int N>
+    static auto get() { return batched_kernel_avx512<Ops, N>; }
+};
+#endif
+
+/**
+ * Kernel for this CPU, type pair and size: AVX-512 if available, else AVX2 + FMA,
+ * else scalar; named "<ISA> <n>x<n> x<lanes> (<fixed|run-time n>)".
+ */
+template <typename T, typename Acc>
+static BatchedKernel<T, Acc> select_batched_kernel(int n) {
+    using Fn = void (*)(int, int64_t, const T*, const T*, Acc*);
+    auto make = [&](const char* isa, int lanes, Fn fn) {
+        std::string name = std::string(isa) + " " + std::to_string(n) + "x" + std::to_string(n) + " x" +
+                           std::to_string(lanes) + (batched_fixed_size(n) ? " (fixed)" : " (run-time n)");
+        return BatchedKernel<T, Acc>{name, n, lanes, fn};
+    };
+
+#if PACKED_GEMM_X86
+    if constexpr (Avx512Ops<T, Acc>::available) {
+        if (gemm_cpu_has_avx512()) {
+            return make("AVX-512", Avx512Ops<T, Acc>::LANES,
+                        batched_instance<Fn, BatchedAvx512Kernels<Avx512Ops<T, Acc>>>(n));
+        }
+    }
+    if constexpr (Avx2Ops<T, Acc>::available) {
+        if (gemm_cpu_has_avx2()) {
+            return make("AVX2", Avx2Ops<T, Acc>::LANES, batched_instance<Fn, BatchedAvx2Kernels<Avx2Ops<T, Acc>>>(n));
+        }
+    }
+#endif
+    return make("scalar", BATCHED_SCALAR_LANES, batched_instance<Fn, BatchedScalarKernels<T, Acc>>(n));
+}
+
+/**
+ * Interleave width batches must be created with for batched_gemm<T, Acc> on this CPU.
+ */
+template <typename T, typename Acc>
+static int batched_gemm_lanes() {
+    return select_batched_kernel<T, Acc>(0).lanes;
+}
+
+/////////////////////
+///    DRIVER     ///
+/////////////////////
+/**
+ * C[b] = A[b] x B[b] for every matrix of the batch, packs split across `pool`.
+ *
+ * @param pool  Workers (ranges of whole packs per task)
+ * @param A, B  Operand batches (same n and count, lanes = batched_gemm_lanes<T, Acc>())
+ * @param C     Result batch (same shape; overwritten)
+ * @throws std::invalid_argument if the batch shapes or interleave widths differ
+ */
+template <typename T, typename Acc>
+static void batched_gemm(ThreadPool& pool, const MatrixBatch<T>& A, const MatrixBatch<T>& B, MatrixBatch<Acc>& C) {
+    const BatchedKernel<T, Acc> kern = select_batched_kernel<T, Acc>(A.n);
+    if (B.n != A.n || C.n != A.n || B.count != A.count || C.count != A.count) {
+        throw std::invalid_argument("batched_gemm: batch shapes differ");
+    }
+    if (A.lanes != kern.lanes || B.lanes != kern.lanes || C.lanes != kern.lanes) {
+        throw std::invalid_argument("batched_gemm: interleave width must be " + std::to_string(kern.lanes));
+    }
+
+    const int64_t packs = A.packs();
+    if (packs == 0) return;
+    const int tasks = static_cast<int>(std::min<int64_t>(packs, int64_t(pool.size()) * BATCHED_TASKS_PER_WORKER));
+    const size_t pack = A.pack_size();
+
+    pool.parallel_for(tasks, [&](int task, int) {
+        const int64_t p0 = packs * task / tasks;
+        const int64_t p1 = packs * (task + 1) / tasks;
+        kern.compute(A.n, p1 - p0, A.data.get() + p0 * pack, B.data.get() + p0 * pack, C.data.get() + p0 * pack);
+    });
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Benchmark harness: repeated, statistically summarised timings.
+ *
+ * - bench_run(options, fn) calls fn `warmup` times untimed (first-touch page faults,
+ *   pool wake-up, instruction cache), then `repetitions` times timed, and returns the
+ *   median, minimum, mean and sample standard deviation in milliseconds
+ * - Only fn is inside the timed region; with flush_cache = true every timed run is
+ *   preceded, outside the timer, by a pass over a BENCH_FLUSH_BYTES buffer, so the run
+ *   starts with cold caches instead of the operands left by the previous run
+ * - The median is the reported time (robust against single preempted runs), the
+ *   minimum is the best case, stddev / median is the run-to-run noise
+ * - BenchCsv writes one row per measurement for plotting outside the program
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Bytes touched by a cache flush (larger than the last-level cache of common CPUs)
+constexpr size_t BENCH_FLUSH_BYTES = size_t(64) << 20;
+
+/////////////////////
+///    HARNESS    ///
+/////////////////////
+/**
+ * BenchOptions: how bench_run repeats a measurement.
+ */
+struct BenchOptions {
+    int warmup = 1;            // Untimed runs before the measurement
+    int repetitions = 5;       // Timed runs
+    bool flush_cache = false;  // Evict the caches before every timed run
+};
+
+/**
+ * BenchStats: summary of the timed runs, in milliseconds.
+ */
+struct BenchStats {
+    double median_ms = 0.0;
+    double min_ms = 0.0;
+    double mean_ms = 0.0;
+    double stddev_ms = 0.0;
+    int runs = 0;
+};
+
+/**
+ * Evicts the caches by writing and reading a buffer larger than the last-level cache.
+ */
+static void bench_flush_caches() {
+    static std::vector<uint64_t> buffer(BENCH_FLUSH_BYTES / sizeof(uint64_t));
+    static volatile uint64_t sink = 0;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] += i;
+        sum += buffer[i];
+    }
+    sink = sink + sum;
+}
+
+/**
+ * Median, minimum, mean and sample standard deviation of `samples` (milliseconds).
+ */
+static BenchStats bench_stats(std::vector<double> samples) {
+    BenchStats stats;
+    stats.runs = static_cast<int>(samples.size());
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    const size_t mid = samples.size() / 2;
+    stats.median_ms = samples.size() % 2 == 1 ? samples[mid] : 0.5 * (samples[mid - 1] + samples[mid]);
+    stats.min_ms = samples.front();
+
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+    stats.mean_ms = sum / samples.size();
+
+    double sq = 0.0;
+    for (double s : samples) sq += (s - stats.mean_ms) * (s - stats.mean_ms);
+    stats.stddev_ms = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0.0;
+    return stats;
+}
+
+/**
+ * Times fn() with warm-up and repetitions as configured.
+ *
+ * @param options  Warm-up runs, timed runs, cache flushing
+ * @param fn       Code under test (no arguments; should leave its result in place)
+ * @return         Statistics of the timed runs
+ */
+template <typename Fn>
+static BenchStats bench_run(const BenchOptions& options, Fn&& fn) {
+    for (int w = 0; w < options.warmup; ++w) fn();
+
+    std::vector<double> samples;
+    samples.reserve(std::max(1, options.repetitions));
+    for (int r = 0; r < std::max(1, options.repetitions); ++r) {
+        if (options.flush_cache) bench_flush_caches();
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return bench_stats(std::move(samples));
+}
+
+/////////////////////
+///      CSV      ///
+/////////////////////
+/**
+ * BenchCsv: comma-separated results file with a header row.
+ *
+ * Fields containing a comma or a quote are quoted. An empty path disables the writer
+ * (row() does nothing), so callers need no separate "CSV off" branch.
+ */
+class BenchCsv {
+public:
+    /**
+     * @param path     Output file (truncated; empty: no output)
+     * @param columns  Header row
+     */
+    BenchCsv(const std::string& path, const std::vector<std::string>& columns) {
+        if (path.empty()) return;
+        out_.open(path);
+        if (!out_) return;
+        for (size_t i = 0; i < columns.size(); ++i) out_ << (i > 0 ? "," : "") << field(columns[i]);
+        out_ << "\n";
+    }
+
+    bool is_open() const { return out_.is_open(); }
+
+    /** Appends one row; every field is formatted with operator<<. */
+    template <typename... Fields>
+    void row(const Fields&... fields) {
+        if (!out_.is_open()) return;
+        bool first = true;
+        ((out_ << (first ? "" : ",") << field(fields), first = false), ...);
+        out_ << "\n";
+        out_.flush();
+    }
+
+private:
+    template <typename V>
+    static std::string field(const V& value) {
+        std::ostringstream s;
+        s << value;
+        std::string text = s.str();
+        if (text.find_first_of(",\"") == std::string::npos) return text;
+
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    std::ofstream out_;
+};
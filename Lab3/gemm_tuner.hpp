@@ -0,0 +1,378 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Auto-tuner for the packed GEMM engine.
+ *
+ * A GemmPlan fixes everything the engine otherwise takes from defaults:
+ * - the micro-kernel (instruction set and MR x NR, from gemm_kernel_candidates)
+ * - the cache blocking MC / KC / NC
+ * - the thread decomposition: a static grid_rows x grid_cols grid of C blocks
+ *   (grid_gemm), or 0 x 0 for the dynamic tiles of tiled_gemm
+ *
+ * Search (GemmTuner::tune): coordinate descent from the default plan (Strategy 6), one
+ * parameter at a time, keeping the best plan so far:
+ *
+ *   kernel shape -> KC -> MC -> NC -> thread grid
+ *
+ * Every candidate is timed on a short run (one warm-up, best of GEMM_TUNE_REPEATS) of a
+ * proxy product with the same aspect ratio, scaled down to at most GEMM_TUNE_MAX_MACS
+ * multiply-adds. That is about 25 runs per entry instead of the thousands of the full
+ * cross product. A candidate replaces the best only if it is GEMM_TUNE_MIN_GAIN faster,
+ * so timing noise does not move the plan away from the default.
+ *
+ * Cache: the best plan per (shape class, type, threads) is kept in a text file, one
+ * entry per line, read when the tuner is constructed and rewritten after each search:
+ *
+ *   # shape type threads kernel mc kc nc grid_rows grid_cols tuned_gops default_gops
+ *   square-1024 int32 4 "AVX-512 12x32 (int32)" 144 256 3072 0 0 31.20 30.65
+ *
+ * Shape class = aspect (square / tall / wide, plus "-thin" when K is small) and size
+ * bucket (power of two nearest the geometric mean of m, n, k), so nearby shapes share
+ * a plan. Entries naming a kernel this CPU lacks are ignored (the file may come from
+ * another machine) and the default plan is used.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Cache file used when none is given
+constexpr const char* GEMM_TUNE_CACHE_FILE = "gemm_tuning.cache";
+
+// Largest proxy product timed per candidate (2^28 multiply-adds, about 645^3)
+constexpr double GEMM_TUNE_MAX_MACS = double(1 << 28);
+
+// Timed runs per candidate after the warm-up (the fastest counts)
+constexpr int GEMM_TUNE_REPEATS = 3;
+
+// Relative speed-up a candidate needs to replace the best plan so far
+constexpr double GEMM_TUNE_MIN_GAIN = 1.02;
+
+/////////////////////
+///     KEYS      ///
+/////////////////////
+/**
+ * Shape class of an m x n x k product, e.g. "square-1024", "tall-512", "wide-thin-256".
+ */
+static inline std::string gemm_shape_class(int m, int n, int k) {
+    std::string aspect = m >= 4 * n ? "tall" : (n >= 4 * m ? "wide" : "square");
+    if (4 * k <= std::min(m, n)) aspect += "-thin";
+
+    // Nearest power of two on a log scale (cut at bucket * sqrt(2))
+    const double mean = std::cbrt(static_cast<double>(m) * n * k);
+    int bucket = 16;
+    while (bucket < 16384 && bucket * 1.4142135 < mean) bucket *= 2;
+    return aspect + "-" + std::to_string(bucket);
+}
+
+template <typename T>
+static constexpr const char* gemm_type_label() {
+    if constexpr (std::is_same_v<T, int32_t>) return "int32";
+    else if constexpr (std::is_same_v<T, int64_t>) return "int64";
+    else if constexpr (std::is_same_v<T, float>) return "float";
+    else if constexpr (std::is_same_v<T, double>) return "double";
+    else return "other";
+}
+
+/** Type key of a pair: "int32" for T = Acc, "int32->int64" otherwise. */
+template <typename T, typename Acc>
+static std::string gemm_type_key() {
+    std::string key = gemm_type_label<T>();
+    if (!std::is_same_v<T, Acc>) key += std::string("->") + gemm_type_label<Acc>();
+    return key;
+}
+
+/////////////////////
+///     PLANS     ///
+/////////////////////
+/**
+ * GemmPlan: Kernel, blocking and thread decomposition for one product.
+ */
+template <typename T, typename Acc>
+struct GemmPlan {
+    GemmKernel<T, Acc> kernel;
+    GemmBlocking blk;
+    int grid_rows = 0;  // 0: dynamic tiles (tiled_gemm)
+    int grid_cols = 0;
+
+    bool operator==(const GemmPlan& other) const {
+        return std::strcmp(kernel.name, other.kernel.name) == 0 && blk.mc == other.blk.mc &&
+               blk.kc == other.blk.kc && blk.nc == other.blk.nc &&
+               grid_rows == other.grid_rows && grid_cols == other.grid_cols;
+    }
+
+    /** e.g. "AVX-512 12x32 (int32), MC 144 KC 256 NC 3072, grid 2x2". */
+    std::string describe() const {
+        std::ostringstream out;
+        out << kernel.name << ", MC " << blk.mc << " KC " << blk.kc << " NC " << blk.nc << ", ";
+        if (grid_rows > 0) out << "grid " << grid_rows << "x" << grid_cols;
+        else out << "dynamic tiles";
+        return out.str();
+    }
+};
+
+/** The plan Strategy 6 uses: selected kernel, default blocking, dynamic tiles. */
+template <typename T, typename Acc>
+static GemmPlan<T, Acc> default_gemm_plan() {
+    return {select_gemm_kernel<T, Acc>(), GemmBlocking{}, 0, 0};
+}
+
+/**
+ * C = A x B (same arguments as packed_gemm) with the plan's kernel, blocking and
+ * thread decomposition.
+ */
+template <typename T, typename Acc>
+static void run_gemm_plan(ThreadPool& pool, const GemmPlan<T, Acc>& plan, int m, int n, int k,
+                          const T* a, int lda, const T* b, int ldb, Acc* c, int ldc) {
+    if (plan.grid_rows > 0 && plan.grid_cols > 0) {
+        grid_gemm(pool, plan.kernel, plan.blk, plan.grid_rows, plan.grid_cols, m, n, k, a, lda, b, ldb, c, ldc);
+    } else {
+        tiled_gemm(pool, plan.kernel, plan.blk, m, n, k, a, lda, b, ldb, c, ldc);
+    }
+}
+
+/////////////////////
+///     TUNER     ///
+/////////////////////
+/**
+ * GemmTuneEntry: One cache line (type-independent; the kernel is kept by name).
+ */
+struct GemmTuneEntry {
+    std::string kernel;
+    int mc = 0;
+    int kc = 0;
+    int nc = 0;
+    int grid_rows = 0;
+    int grid_cols = 0;
+    double tuned_gops = 0.0;    // Proxy product, best plan
+    double default_gops = 0.0;  // Proxy product, default plan
+};
+
+class GemmTuner {
+public:
+    /**
+     * @param path  Cache file (read now if it exists, rewritten by tune())
+     */
+    explicit GemmTuner(std::string path = GEMM_TUNE_CACHE_FILE) : path_(std::move(path)) { load(); }
+
+    const std::string& path() const { return path_; }
+    size_t size() const { return entries_.size(); }
+
+    /** Cache entry for this product on `threads` workers, or nullptr. */
+    template <typename T, typename Acc>
+    const GemmTuneEntry* entry(int m, int n, int k, int threads) const {
+        auto it = entries_.find(key(gemm_shape_class(m, n, k), gemm_type_key<T, Acc>(), threads));
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * Cached plan for this product on `threads` workers.
+     * @return  False if there is no entry or its kernel is not available on this CPU
+     */
+    template <typename T, typename Acc>
+    bool find(int m, int n, int k, int threads, GemmPlan<T, Acc>& plan) const {
+        const GemmTuneEntry* e = entry<T, Acc>(m, n, k, threads);
+        if (e == nullptr) return false;
+        for (const auto& kern : gemm_kernel_candidates<T, Acc>()) {
+            if (e->kernel == kern.name) {
+                // Keep MC / NC multiples of MR / NR, as auto_tune does, for hand-edited caches
+                auto round_up = [](int x, int to) { return (x + to - 1) / to * to; };
+                plan = {kern, GemmBlocking{round_up(e->mc, kern.mr), e->kc, round_up(e->nc, kern.nr)},
+                        e->grid_rows, e->grid_cols};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Plan for this product on `pool`: the cached one, else a new search (auto_tune)
+     * or the default plan.
+     */
+    template <typename T, typename Acc>
+    GemmPlan<T, Acc> plan(ThreadPool& pool, int m, int n, int k, bool auto_tune = true) {
+        GemmPlan<T, Acc> cached;
+        if (find(m, n, k, pool.size(), cached)) return cached;
+        return auto_tune ? tune<T, Acc>(pool, m, n, k) : default_gemm_plan<T, Acc>();
+    }
+
+    /**
+     * Searches the best plan for the shape class of m x n x k on `pool`, stores it
+     * (replacing any cached entry) and rewrites the cache file.
+     */
+    template <typename T, typename Acc>
+    GemmPlan<T, Acc> tune(ThreadPool& pool, int m, int n, int k) {
+        // Proxy product: same aspect ratio, at most GEMM_TUNE_MAX_MACS
+        const double scale = std::min(1.0, std::cbrt(GEMM_TUNE_MAX_MACS / (static_cast<double>(m) * n * k)));
+        const int pm = std::max(16, static_cast<int>(m * scale));
+        const int pn = std::max(16, static_cast<int>(n * scale));
+        const int pk = std::max(16, static_cast<int>(k * scale));
+
+        std::vector<T> a(static_cast<size_t>(pm) * pk);
+        std::vector<T> b(static_cast<size_t>(pk) * pn);
+        std::vector<Acc> c(static_cast<size_t>(pm) * pn);
+        std::mt19937 gen(42);
+        if constexpr (std::is_integral_v<T>) {
+            std::uniform_int_distribution<T> dist(1, 10);
+            for (T& x : a) x = dist(gen);
+            for (T& x : b) x = dist(gen);
+        } else {
+            std::uniform_real_distribution<T> dist(-1, 1);
+            for (T& x : a) x = dist(gen);
+            for (T& x : b) x = dist(gen);
+        }
+
+        const double ops = 2.0 * pm * pn * pk;
+        double best_ns = 0.0;
+
+        // GOP/s of a candidate; candidates far slower than the best skip the repeats
+        auto measure = [&](const GemmPlan<T, Acc>& plan) {
+            double fastest = 0.0;
+            for (int run = 0; run <= GEMM_TUNE_REPEATS; ++run) {
+                auto start = std::chrono::high_resolution_clock::now();
+                run_gemm_plan(pool, plan, pm, pn, pk, a.data(), pk, b.data(), pn, c.data(), pn);
+                auto end = std::chrono::high_resolution_clock::now();
+                double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+                if (run == 0) {
+                    if (best_ns > 0.0 && ns > 3.0 * best_ns) return ops / ns;
+                    continue;  // Warm-up (packing buffers, caches, page faults)
+                }
+                fastest = fastest == 0.0 ? ns : std::min(fastest, ns);
+            }
+            return ops / fastest;
+        };
+
+        GemmPlan<T, Acc> best = default_gemm_plan<T, Acc>();
+        double best_gops = measure(best);
+        best_ns = ops / best_gops;
+        const double default_gops = best_gops;
+
+        auto consider = [&](const GemmPlan<T, Acc>& candidate) {
+            if (candidate == best) return;
+            double gops = measure(candidate);
+            if (gops > best_gops * GEMM_TUNE_MIN_GAIN) {
+                best = candidate;
+                best_gops = gops;
+                best_ns = ops / gops;
+            }
+        };
+        auto round_to = [](int x, int to) { return std::max(to, (x + to / 2) / to * to); };
+
+        // 1. Micro-kernel shape (MC / NC kept multiples of its MR / NR)
+        GemmPlan<T, Acc> base = best;
+        for (const auto& kern : gemm_kernel_candidates<T, Acc>()) {
+            GemmPlan<T, Acc> candidate = base;
+            candidate.kernel = kern;
+            candidate.blk.mc = round_to(base.blk.mc, kern.mr);
+            candidate.blk.nc = round_to(base.blk.nc, kern.nr);
+            consider(candidate);
+        }
+
+        // 2. KC: depth of the packed slivers (one B sliver of KC x NR should stay in L1)
+        base = best;
+        for (int kc : {128, 192, 256, 384, 512}) {
+            GemmPlan<T, Acc> candidate = base;
+            candidate.blk.kc = kc;
+            consider(candidate);
+        }
+
+        // 3. MC: rows of the packed A block (MC x KC in L2)
+        base = best;
+        for (int mc : {48, 96, 144, 192, 288}) {
+            GemmPlan<T, Acc> candidate = base;
+            candidate.blk.mc = round_to(mc, base.kernel.mr);
+            consider(candidate);
+        }
+
+        // 4. NC: columns of the packed B panel (KC x NC in L3)
+        base = best;
+        for (int nc : {256, 512, 1024, 2048, 4096}) {
+            GemmPlan<T, Acc> candidate = base;
+            candidate.blk.nc = round_to(nc, base.kernel.nr);
+            consider(candidate);
+        }
+
+        // 5. Thread decomposition: dynamic tiles or every rows x cols = workers grid
+        base = best;
+        for (int rows = 0; rows <= pool.size(); ++rows) {
+            if (rows > 0 && pool.size() % rows != 0) continue;
+            GemmPlan<T, Acc> candidate = base;
+            candidate.grid_rows = rows;
+            candidate.grid_cols = rows > 0 ? pool.size() / rows : 0;
+            consider(candidate);
+        }
+
+        entries_[key(gemm_shape_class(m, n, k), gemm_type_key<T, Acc>(), pool.size())] =
+                GemmTuneEntry{best.kernel.name, best.blk.mc, best.blk.kc, best.blk.nc,
+                              best.grid_rows, best.grid_cols, best_gops, default_gops};
+        save();
+        return best;
+    }
+
+    /**
+     * Writes every entry to the cache file.
+     * @return  False if the file could not be written
+     */
+    bool save() const {
+        std::ofstream out(path_);
+        if (!out) return false;
+        out << "# shape type threads kernel mc kc nc grid_rows grid_cols tuned_gops default_gops\n";
+        for (const auto& [k, e] : entries_) {
+            out << k << " " << std::quoted(e.kernel) << " " << e.mc << " " << e.kc << " " << e.nc << " "
+                << e.grid_rows << " " << e.grid_cols << std::fixed << std::setprecision(2)
+                << " " << e.tuned_gops << " " << e.default_gops << "\n";
+        }
+        return static_cast<bool>(out);
+    }
+
+private:
+    static std::string key(const std::string& shape, const std::string& type, int threads) {
+        return shape + " " + type + " " + std::to_string(threads);
+    }
+
+    /** Reads the cache file; a missing file is an empty cache, malformed lines are skipped. */
+    void load() {
+        std::ifstream in(path_);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream fields(line);
+            std::string shape, type;
+            int threads = 0;
+            GemmTuneEntry e;
+            fields >> shape >> type >> threads >> std::quoted(e.kernel) >> e.mc >> e.kc >> e.nc
+                   >> e.grid_rows >> e.grid_cols >> e.tuned_gops >> e.default_gops;
+            if (!fields || threads < 1 || e.mc < 1 || e.kc < 1 || e.nc < 1 || e.grid_rows < 0 || e.grid_cols < 0) {
+                continue;
+            }
+            entries_[key(shape, type, threads)] = e;
+        }
+    }
+
+    std::string path_;
+    std::map<std::string, GemmTuneEntry> entries_;
+};
@@ -3,25 +3,46 @@
 ///////////////////////////
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <random>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "batched_gemm.hpp"
+#include "bench_harness.hpp"
+#include "gemm_tuner.hpp"
+#include "morton.hpp"
+#include "ooc_gemm.hpp"
+#include "packed_gemm.hpp"
+#include "sparse.hpp"
+#include "strassen.hpp"
+
 
 ///////////////////////////
 ///   STRUCTS SECTION   ///
 ///////////////////////////
 
 /**
- * Matrix structure: Simple 2D matrix.
+ * Matrix structure: Simple 2D matrix of element type T.
  *
  * Memory layout: rows stored contiguously, providing good cache locality
  * when accessing elements in the same row sequentially.
+ *
+ * Supported element types: int32_t (default), int64_t, float, double.
  */
+template <typename T = int32_t>
 struct Matrix {
     // Matrix dimensions
     int rows;
@@ -29,7 +50,7 @@ struct Matrix {
 
     // Data storage: flat vector for cache-friendly access
     // Element at (i, j) stored at index: i * cols + j
-    std::vector<int> data;
+    std::vector<T> data;
 
     /**
      * Constructor: Allocates matrix storage and initializes to zero.
@@ -50,7 +71,7 @@ struct Matrix {
      * @param col  Column index (0-based)
      * @return     Reference to element at specified position
      */
-    int& at(int row, int col) {
+    T& at(int row, int col) {
         return data[row * cols + col];
     }
 
@@ -61,25 +82,51 @@ struct Matrix {
      * @param col  Column index (0-based)
      * @return     Const reference to element
      */
-    const int& at(int row, int col) const {
+    const T& at(int row, int col) const {
         return data[row * cols + col];
     }
 
     /**
-     * Random initialization: Fills matrix with random integers.
+     * Random initialization: Fills matrix with random values.
      *
-     * Uses uniform distribution over specified range for test data generation.
+     * Uses uniform distribution over specified range for test data generation
+     * (integers for integral T, reals for floating-point T).
      *
      * @param min_val  Minimum value (inclusive)
      * @param max_val  Maximum value (inclusive)
      */
-    void randomize(int min_val = 1, int max_val = 10) {
+    void randomize(T min_val = 1, T max_val = 10) {
         std::random_device rd;
         std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> dist(min_val, max_val);
 
-        for (int i = 0; i < rows * cols; ++i) {
-            data[i] = dist(gen);
+        if constexpr (std::is_integral_v<T>) {
+            std::uniform_int_distribution<T> dist(min_val, max_val);
+            for (int i = 0; i < rows * cols; ++i) data[i] = dist(gen);
+        } else {
+            std::uniform_real_distribution<T> dist(min_val, max_val);
+            for (int i = 0; i < rows * cols; ++i) data[i] = dist(gen);
+        }
+    }
+
+    /**
+     * Sparse random initialization: Each element is nonzero with probability
+     * `density`, drawn uniformly from [min_val, max_val] (which should exclude 0).
+     *
+     * @param density  Expected fraction of nonzero elements (0..1)
+     * @param min_val  Minimum nonzero value (inclusive)
+     * @param max_val  Maximum nonzero value (inclusive)
+     */
+    void randomize_sparse(double density, T min_val = 1, T max_val = 10) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::bernoulli_distribution keep(density);
+
+        if constexpr (std::is_integral_v<T>) {
+            std::uniform_int_distribution<T> dist(min_val, max_val);
+            for (int i = 0; i < rows * cols; ++i) data[i] = keep(gen) ? dist(gen) : T(0);
+        } else {
+            std::uniform_real_distribution<T> dist(min_val, max_val);
+            for (int i = 0; i < rows * cols; ++i) data[i] = keep(gen) ? dist(gen) : T(0);
         }
     }
 
@@ -103,17 +150,21 @@ struct Matrix {
  * Each thread receives its own configuration specifying which portion
  * of the result matrix to compute. No shared state modification occurs,
  * eliminating need for synchronization primitives.
+ *
+ * T is the element type of A and B, Acc the accumulator (and element) type of C,
+ * e.g. int32_t inputs with int64_t results so that large products cannot overflow.
  */
+template <typename T, typename Acc = T>
 struct ThreadConfig {
     // Thread identifier for debugging output
     int thread_id;
 
     // Input matrices: read-only access (no mutations)
-    const Matrix* A;
-    const Matrix* B;
+    const Matrix<T>* A;
+    const Matrix<T>* B;
 
     // Output matrix: each thread writes to disjoint regions
-    Matrix* C;
+    Matrix<Acc>* C;
 
     // Work distribution: defines which elements this thread computes
     // Interpretation depends on distribution strategy
@@ -140,19 +191,21 @@ struct ThreadConfig {
  * @param row        Row index in result matrix C
  * @param col        Column index in result matrix C
  * @param thread_id  Identifier of calling thread (for debug output)
- * @return           Computed element value for C[row][col]
+ * @return           Computed element value for C[row][col], accumulated in Acc
  */
-static int compute_element(const Matrix& A, const Matrix& B, int row, int col, int thread_id) {
+template <typename T, typename Acc>
+static Acc compute_element(const Matrix<T>& A, const Matrix<T>& B, int row, int col, int thread_id) {
     // Debug output: shows which thread computes each element
     // std::cout << "Thread " << thread_id << ": Computing element (" << row << ", " << col << ")\n";
 
     // Dot product accumulator
-    int sum = 0;
+    Acc sum = 0;
 
     // Multiply corresponding elements from A's row and B's column
     // Inner dimension (A.cols == B.rows) must match for valid multiplication
+    // Operands are widened first, so the products are formed in Acc as well
     for (int k = 0; k < A.cols; ++k) {
-        sum += A.at(row, k) * B.at(k, col);
+        sum += static_cast<Acc>(A.at(row, k)) * static_cast<Acc>(B.at(k, col));
     }
 
     return sum;
@@ -185,7 +238,8 @@ static int compute_element(const Matrix& A, const Matrix& B, int row, int col, i
  *
  * @param cfg  Thread configuration specifying input/output matrices and work range
  */
-static void strategy_row_by_row(const ThreadConfig& cfg) {
+template <typename T, typename Acc>
+static void strategy_row_by_row(const ThreadConfig<T, Acc>& cfg) {
     const int total_elements = cfg.C->rows * cfg.C->cols;
 
     // Iterate through assigned range of linear indices
@@ -197,7 +251,7 @@ static void strategy_row_by_row(const ThreadConfig& cfg) {
 
         // Compute and store result element
         // Direct write to output matrix - no race condition since indices are unique
-        cfg.C->at(row, col) = compute_element(*cfg.A, *cfg.B, row, col, cfg.thread_id);
+        cfg.C->at(row, col) = compute_element<T, Acc>(*cfg.A, *cfg.B, row, col, cfg.thread_id);
     }
 }
 
@@ -230,7 +284,8 @@ static void strategy_row_by_row(const ThreadConfig& cfg) {
  *
  * @param cfg  Thread configuration specifying input/output matrices and work range
  */
-static void strategy_column_by_column(const ThreadConfig& cfg) {
+template <typename T, typename Acc>
+static void strategy_column_by_column(const ThreadConfig<T, Acc>& cfg) {
     const int total_elements = cfg.C->rows * cfg.C->cols;
 
     // Iterate through assigned range of linear indices (column-major interpretation)
@@ -242,7 +297,7 @@ static void strategy_column_by_column(const ThreadConfig& cfg) {
 
         // Compute and store result element
         // Each thread processes different elements - no conflicts
-        cfg.C->at(row, col) = compute_element(*cfg.A, *cfg.B, row, col, cfg.thread_id);
+        cfg.C->at(row, col) = compute_element<T, Acc>(*cfg.A, *cfg.B, row, col, cfg.thread_id);
     }
 }
 
@@ -275,7 +330,8 @@ static void strategy_column_by_column(const ThreadConfig& cfg) {
  *
  * @param cfg  Thread configuration (start_idx represents thread_id, end_idx represents num_threads)
  */
-static void strategy_kth_element(const ThreadConfig& cfg) {
+template <typename T, typename Acc>
+static void strategy_kth_element(const ThreadConfig<T, Acc>& cfg) {
     const int thread_id = cfg.start_idx;    // Repurpose: thread identifier
     const int num_threads = cfg.end_idx;     // Repurpose: total thread count
     const int total_elements = cfg.C->rows * cfg.C->cols;
@@ -289,7 +345,7 @@ static void strategy_kth_element(const ThreadConfig& cfg) {
 
         // Compute and store result element
         // Large stride minimizes cache reuse, demonstrating worst-case performance
-        cfg.C->at(row, col) = compute_element(*cfg.A, *cfg.B, row, col, cfg.thread_id);
+        cfg.C->at(row, col) = compute_element<T, Acc>(*cfg.A, *cfg.B, row, col, cfg.thread_id);
     }
 }
 
@@ -312,7 +368,8 @@ static void strategy_kth_element(const ThreadConfig& cfg) {
  *
  * @param cfg  Thread configuration with element range to process
  */
-static void strategy_blocked_optimized(const ThreadConfig& cfg) {
+template <typename T, typename Acc>
+static void strategy_blocked_optimized(const ThreadConfig<T, Acc>& cfg) {
     // Block size tuned for L1 cache: 64x64x4 bytes = 16KB per block
     // Three blocks (A, B, C) = 48KB total, fits comfortably in typical 32-64KB L1
     const int BLOCK_SIZE = 64;
@@ -373,14 +430,14 @@ static void strategy_blocked_optimized(const ThreadConfig& cfg) {
                     // Initialize or accumulate:
                     // - First K-block (kk=0): Start fresh with 0
                     // - Later K-blocks (kk>0): Add to existing partial sum
-                    int sum = (kk == 0) ? 0 : cfg.C->at(i, j);
+                    Acc sum = (kk == 0) ? Acc(0) : cfg.C->at(i, j);
 
                     // Compute partial dot product for this K-block
                     // This is the core computation: multiply and accumulate
                     for (int k = kk; k < k_end; ++k) {
                         // A[i][k]: Reused for all j in this block (64 times)
                         // B[k][j]: Sequential access within block
-                        sum += cfg.A->at(i, k) * cfg.B->at(k, j);
+                        sum += static_cast<Acc>(cfg.A->at(i, k)) * static_cast<Acc>(cfg.B->at(k, j));
                     }
 
                     // Store partial sum back to result matrix
@@ -392,6 +449,177 @@ static void strategy_blocked_optimized(const ThreadConfig& cfg) {
     }
 }
 
+/**
+ * STRATEGY 5: Packed SIMD Micro-Kernel GEMM (GotoBLAS / BLIS)
+ *
+ * Each thread multiplies its own band of rows with the packed engine from
+ * packed_gemm.hpp:
+ * 1. B is packed per KC x NC panel into NR-wide slivers (contiguous, aligned)
+ * 2. A is packed per MC x KC block into MR-high slivers
+ * 3. An MR x NR register-blocked micro-kernel (AVX-512, AVX2 or scalar, picked at
+ *    run time from CPUID and specialised per T / Acc) performs KC rank-1 updates on
+ *    a tile held in registers
+ *
+ * Unlike Strategy 4 the inner loop touches no strided memory and keeps MR x NR partial
+ * sums in vector registers, so each loaded element feeds MR (or NR) multiply-adds.
+ *
+ * Thread safety: a row belongs to the thread whose element range contains its first
+ * element, so bands are disjoint; packing buffers are per thread.
+ *
+ * @param cfg  Thread configuration with element range to process
+ */
+template <typename T, typename Acc>
+static void strategy_packed_simd(const ThreadConfig<T, Acc>& cfg) {
+    const int C_cols = cfg.C->cols;
+    const int A_cols = cfg.A->cols;
+
+    int row_start = (cfg.start_idx + C_cols - 1) / C_cols;
+    int row_end = std::min((cfg.end_idx + C_cols - 1) / C_cols, cfg.C->rows);
+    if (row_start >= row_end) return;
+
+    packed_gemm(select_gemm_kernel<T, Acc>(), GemmBlocking{},
+                row_end - row_start, C_cols, A_cols,
+                cfg.A->data.data() + row_start * A_cols, A_cols,
+                cfg.B->data.data(), cfg.B->cols,
+                cfg.C->data.data() + row_start * C_cols, C_cols);
+}
+
+
+/**
+ * STRATEGY 6: Persistent Thread Pool with Tile Tasks
+ *
+ * Same packed engine as Strategy 5, but scheduled differently (tiled_gemm):
+ * 1. C is cut into MC x NC tiles (shrunk until there are >= 4 tiles per worker)
+ * 2. Each tile is a task on a ThreadPool created once and reused for every product
+ * 3. Workers claim tiles from an atomic counter, in grouped column-major order so
+ *    concurrent tiles share a B panel and revisit the same A panels in L3
+ *
+ * Compared to Strategies 1-5 no thread is created per call, and a worker that finishes
+ * early takes the next tile instead of idling, whatever the shape of C.
+ *
+ * @param pool  Persistent workers (the caller takes part as worker 0)
+ * @param A     Left operand matrix
+ * @param B     Right operand matrix
+ * @param C     Result matrix (modified in place)
+ */
+template <typename T, typename Acc>
+static void strategy_pool_tiles(ThreadPool& pool, const Matrix<T>& A, const Matrix<T>& B, Matrix<Acc>& C) {
+    tiled_gemm(pool, select_gemm_kernel<T, Acc>(), GemmBlocking{},
+               C.rows, C.cols, A.cols,
+               A.data.data(), A.cols, B.data.data(), B.cols, C.data.data(), C.cols);
+}
+
+
+/**
+ * STRATEGY 7: Strassen-Winograd with Parallel Sub-Products
+ *
+ * Recursive 7-product multiplication from strassen.hpp for square matrices, with T
+ * used for the intermediate sums as well (so A, B and C share one type):
+ * 1. The top levels are expanded breadth-first; their 7^depth sub-products, and the
+ *    sums / combinations of each level, run as tasks on the pool
+ * 2. Below that each sub-product recurses sequentially, and sizes <= cutoff use the
+ *    packed engine of Strategy 5
+ * 3. Odd sizes peel the last row and column (rank-1 update + dot products)
+ * 4. All temporaries come from one arena, allocated once and reused across calls
+ *
+ * Saves 1/8 of the multiplications per level at the price of O(n^2) additions, so it
+ * only pays off well above the cutoff.
+ *
+ * @param pool    Persistent workers
+ * @param arena   Temporaries, reused across calls
+ * @param config  Cutoff and number of parallel levels
+ * @param A       Left operand matrix (n x n)
+ * @param B       Right operand matrix (n x n)
+ * @param C       Result matrix (modified in place)
+ */
+template <typename T>
+static void strategy_strassen(ThreadPool& pool, StrassenArena<T>& arena, const StrassenConfig& config,
+                              const Matrix<T>& A, const Matrix<T>& B, Matrix<T>& C) {
+    strassen_gemm(pool, arena, config, C.rows,
+                  A.data.data(), A.cols, B.data.data(), B.cols, C.data.data(), C.cols);
+}
+
+
+/**
+ * STRATEGY 8: Cache-Oblivious Recursive Multiply on Z-Order Layout
+ *
+ * A and B are copied into Morton tiled layout (morton.hpp): tile x tile tiles stored
+ * contiguously, tiles ordered along the Z curve, so every quadrant at every level of
+ * the recursion is one contiguous block. The multiply recurses on quadrants
+ * (8 half-size products) down to single tiles, which use the packed micro-kernel;
+ * the C blocks of the top levels are tasks on the pool.
+ *
+ * No BLOCK_SIZE to tune: B's "columns" are just other tiles, and some recursion level
+ * fits each cache level. The timed region includes both conversions to Morton layout
+ * and the conversion of C back to row-major.
+ *
+ * @param pool  Persistent workers
+ * @param A     Left operand matrix
+ * @param B     Right operand matrix
+ * @param C     Result matrix (modified in place)
+ */
+template <typename T, typename Acc>
+static void strategy_morton(ThreadPool& pool, const Matrix<T>& A, const Matrix<T>& B, Matrix<Acc>& C) {
+    const int side = std::max({A.rows, A.cols, B.cols});
+    MortonMatrix<T> MA(A.rows, A.cols, side);
+    MortonMatrix<T> MB(B.rows, B.cols, side);
+    MortonMatrix<Acc> MC(C.rows, C.cols, side);
+
+    to_morton(pool, A.data.data(), A.cols, MA);
+    to_morton(pool, B.data.data(), B.cols, MB);
+    morton_gemm(pool, MA, MB, MC);
+    from_morton(pool, MC, C.data.data(), C.cols);
+}
+
+
+/**
+ * STRATEGY 9: Auto-Tuned Packed GEMM
+ *
+ * The packed engine of Strategy 6 with a plan from the auto-tuner (gemm_tuner.hpp)
+ * instead of fixed defaults:
+ * 1. Micro-kernel shape (instruction set and MR x NR)
+ * 2. Cache blocking MC / KC / NC
+ * 3. Thread decomposition: dynamic tiles, or a fixed rows x cols grid of C blocks
+ *
+ * Plans are looked up per (shape class, type, thread count) in the tuner's cache file;
+ * a product with no entry is tuned once (short runs on a proxy of the same shape) and
+ * the result is written back, so later runs start tuned.
+ *
+ * @param pool   Persistent workers
+ * @param tuner  Plan cache (searched and updated on a miss)
+ * @param A      Left operand matrix
+ * @param B      Right operand matrix
+ * @param C      Result matrix (modified in place)
+ */
+template <typename T, typename Acc>
+static void strategy_tuned(ThreadPool& pool, GemmTuner& tuner, const Matrix<T>& A, const Matrix<T>& B, Matrix<Acc>& C) {
+    const GemmPlan<T, Acc> plan = tuner.plan<T, Acc>(pool, C.rows, C.cols, A.cols);
+    run_gemm_plan(pool, plan, C.rows, C.cols, A.cols,
+                  A.data.data(), A.cols, B.data.data(), B.cols, C.data.data(), C.cols);
+}
+
+
+/**
+ * Sparse conversion: CSR and CSC copies of a dense Matrix (zeros dropped).
+ *
+ * The sparse kernels (sparse.hpp) multiply these with dense matrices and vectors:
+ * csr_spmv / csr_spmm for A x and A B, csc_spmv / csc_spmm for A^T x and A^T B, with
+ * rows split across the pool by nonzeros (merge path) rather than by row count.
+ *
+ * @param pool  Persistent workers (rows are counted and copied in parallel)
+ * @param M     Dense matrix
+ * @return      Compressed copy of M
+ */
+template <typename T>
+static CsrMatrix<T> to_csr(ThreadPool& pool, const Matrix<T>& M) {
+    return csr_from_dense(pool, M.data.data(), M.rows, M.cols, M.cols);
+}
+
+template <typename T>
+static CscMatrix<T> to_csc(ThreadPool& pool, const Matrix<T>& M) {
+    return csc_from_dense(pool, M.data.data(), M.rows, M.cols, M.cols);
+}
+
 
 ///////////////////////////
 ///  BENCHMARK SECTION  ///
@@ -410,23 +638,28 @@ static void strategy_blocked_optimized(const ThreadConfig& cfg) {
  * @param num_threads     Number of parallel worker threads
  * @param strategy        Function pointer to distribution strategy
  * @param strategy_name   Human-readable strategy identifier for output
+ * @param verbose         Print the report block (false: only return the time)
  * @return                Execution time in milliseconds
  */
+template <typename T, typename Acc>
 static double measure_performance(
-        const Matrix& A,
-        const Matrix& B,
-        Matrix& C,
+        const Matrix<T>& A,
+        const Matrix<T>& B,
+        Matrix<Acc>& C,
         int num_threads,
-        void (*strategy)(const ThreadConfig&),
-        const char* strategy_name
+        void (*strategy)(const ThreadConfig<T, Acc>&),
+        const char* strategy_name,
+        bool verbose = true
 ) {
-    std::cout << "\n========================================\n";
-    std::cout << "Strategy: " << strategy_name << "\n";
-    std::cout << "========================================\n";
-    std::cout << "Matrix dimensions: " << A.rows << "x" << A.cols
-              << " x " << B.rows << "x" << B.cols << "\n";
-    std::cout << "Result dimensions: " << C.rows << "x" << C.cols << "\n";
-    std::cout << "Worker threads: " << num_threads << "\n";
+    if (verbose) {
+        std::cout << "\n========================================\n";
+        std::cout << "Strategy: " << strategy_name << "\n";
+        std::cout << "========================================\n";
+        std::cout << "Matrix dimensions: " << A.rows << "x" << A.cols
+                  << " x " << B.rows << "x" << B.cols << "\n";
+        std::cout << "Result dimensions: " << C.rows << "x" << C.cols << "\n";
+        std::cout << "Worker threads: " << num_threads << "\n";
+    }
 
     // Record start time with high-resolution clock
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -439,10 +672,10 @@ static double measure_performance(
 
     // Work distribution: divide elements as evenly as possible among threads
     // Strategy 3 requires different parameterization (handled in branch)
-    if (strategy == strategy_kth_element) {
+    if (strategy == strategy_kth_element<T, Acc>) {
         // Strided strategy: each thread gets its own ID and total count
         for (int i = 0; i < num_threads; ++i) {
-            ThreadConfig cfg{
+            ThreadConfig<T, Acc> cfg{
                     .thread_id = i,
                     .A = &A,
                     .B = &B,
@@ -463,7 +696,7 @@ static double measure_performance(
             int current_count = elements_per_thread + (i < remainder ? 1 : 0);
             int current_end = current_start + current_count;
 
-            ThreadConfig cfg{
+            ThreadConfig<T, Acc> cfg{
                     .thread_id = i,
                     .A = &A,
                     .B = &B,
@@ -489,11 +722,67 @@ static double measure_performance(
     double ms = duration.count() / 1000.0;
 
     // Report performance metrics
-    std::cout << "Execution time: " << std::fixed << std::setprecision(3)
-              << ms << " ms\n";
-    std::cout << "Total operations: " << total_elements << "\n";
-    std::cout << "Throughput: " << std::fixed << std::setprecision(2)
-              << (total_elements * 1000.0 / ms) << " elements/sec\n";
+    if (verbose) {
+        std::cout << "Execution time: " << std::fixed << std::setprecision(3)
+                  << ms << " ms\n";
+        std::cout << "Total operations: " << total_elements << "\n";
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+                  << (total_elements * 1000.0 / ms) << " elements/sec\n";
+    }
+
+    return ms;
+}
+
+
+/**
+ * Pool performance measurement: measure_performance for the strategies that run on a
+ * persistent ThreadPool (6 and 7).
+ *
+ * The pool already exists, so the timed region covers only scheduling and compute.
+ *
+ * @param pool           Persistent worker pool
+ * @param A              Left operand matrix
+ * @param B              Right operand matrix
+ * @param C              Result matrix (modified in place)
+ * @param strategy       Callable strategy(pool, A, B, C)
+ * @param strategy_name  Human-readable strategy identifier for output
+ * @param verbose        Print the report block (false: only return the time)
+ * @return               Execution time in milliseconds
+ */
+template <typename T, typename Acc, typename Strategy>
+static double measure_pool_performance(
+        ThreadPool& pool,
+        const Matrix<T>& A,
+        const Matrix<T>& B,
+        Matrix<Acc>& C,
+        Strategy&& strategy,
+        const char* strategy_name,
+        bool verbose = true
+) {
+    if (verbose) {
+        std::cout << "\n========================================\n";
+        std::cout << "Strategy: " << strategy_name << "\n";
+        std::cout << "========================================\n";
+        std::cout << "Matrix dimensions: " << A.rows << "x" << A.cols
+                  << " x " << B.rows << "x" << B.cols << "\n";
+        std::cout << "Result dimensions: " << C.rows << "x" << C.cols << "\n";
+        std::cout << "Pool workers: " << pool.size() << "\n";
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    strategy(pool, A, B, C);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    double ms = duration.count() / 1000.0;
+
+    if (verbose) {
+        const int total_elements = C.rows * C.cols;
+        std::cout << "Execution time: " << std::fixed << std::setprecision(3)
+                  << ms << " ms\n";
+        std::cout << "Total operations: " << total_elements << "\n";
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+                  << (total_elements * 1000.0 / ms) << " elements/sec\n";
+    }
 
     return ms;
 }
@@ -506,15 +795,19 @@ static double measure_performance(
  *
  * @param A  Left operand matrix
  * @param B  Right operand matrix
- * @param C  Result matrix (modified in place)
- * @return   Execution time in milliseconds
+ * @param C        Result matrix (modified in place)
+ * @param verbose  Print the report block (false: only return the time)
+ * @return         Execution time in milliseconds
  */
-static double measure_baseline(const Matrix& A, const Matrix& B, Matrix& C) {
-    std::cout << "\n========================================\n";
-    std::cout << "Baseline: Single-threaded\n";
-    std::cout << "========================================\n";
-    std::cout << "Matrix dimensions: " << A.rows << "x" << A.cols
-              << " x " << B.rows << "x" << B.cols << "\n";
+template <typename T, typename Acc>
+static double measure_baseline(const Matrix<T>& A, const Matrix<T>& B, Matrix<Acc>& C, bool verbose = true) {
+    if (verbose) {
+        std::cout << "\n========================================\n";
+        std::cout << "Baseline: Single-threaded\n";
+        std::cout << "========================================\n";
+        std::cout << "Matrix dimensions: " << A.rows << "x" << A.cols
+                  << " x " << B.rows << "x" << B.cols << "\n";
+    }
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -523,9 +816,9 @@ static double measure_baseline(const Matrix& A, const Matrix& B, Matrix& C) {
     // Inner loop computes dot product for each element
     for (int i = 0; i < C.rows; ++i) {
         for (int j = 0; j < C.cols; ++j) {
-            int sum = 0;
+            Acc sum = 0;
             for (int k = 0; k < A.cols; ++k) {
-                sum += A.at(i, k) * B.at(k, j);
+                sum += static_cast<Acc>(A.at(i, k)) * static_cast<Acc>(B.at(k, j));
             }
             C.at(i, j) = sum;
         }
@@ -535,29 +828,95 @@ static double measure_baseline(const Matrix& A, const Matrix& B, Matrix& C) {
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
     double ms = duration.count() / 1000.0;
 
-    std::cout << "Execution time: " << std::fixed << std::setprecision(3)
-              << ms << " ms\n";
+    if (verbose) {
+        std::cout << "Execution time: " << std::fixed << std::setprecision(3)
+                  << ms << " ms\n";
+    }
 
     return ms;
 }
 
 
+/**
+ * Result check: Compares a strategy's result with a reference result.
+ *
+ * Integral results must match exactly. Floating-point strategies sum in different
+ * orders, so each element may differ by the rounding of a length-k dot product
+ * (bounded by k * eps * sum|a*b|; the test data is positive, so sum|a*b| = |c|).
+ *
+ * @param C          Result to check
+ * @param reference  Reference result
+ * @param k          Inner dimension of the product
+ * @return           True if every element matches
+ */
+template <typename Acc>
+static bool results_match(const Matrix<Acc>& C, const Matrix<Acc>& reference, int k) {
+    if constexpr (std::is_integral_v<Acc>) {
+        return C.data == reference.data;
+    } else {
+        const double tolerance = 2.0 * k * std::numeric_limits<Acc>::epsilon();
+        for (size_t i = 0; i < C.data.size(); ++i) {
+            double expected = reference.data[i];
+            if (std::abs(C.data[i] - expected) > tolerance * std::abs(expected)) return false;
+        }
+        return true;
+    }
+}
+
+
 /**
  * Comprehensive experiment suite: Tests multiple configurations.
  *
  * Systematically varies matrix size and thread count to characterize
  * performance scaling behavior and identify optimal configurations.
+ *
+ * Every strategy and the single-threaded baseline run through the benchmark harness
+ * (bench_harness.hpp): warm-up, repeated timed runs summarised as median / min /
+ * stddev, and optionally a cache flush before each run. Every result is checked
+ * against the baseline's.
+ * - Speedup: baseline median / strategy median
+ * - Efficiency: speedup / threads (parallel efficiency against measure_baseline)
+ * - Peak: GOP/s as a share of the micro-kernel's peak at that thread count
+ *
+ * @param options        Warm-up, repetitions and cache flushing
+ * @param matrix_sizes   Square matrix sizes to sweep
+ * @param thread_counts  Thread counts to sweep
+ * @param csv_path       One CSV row per measurement (empty: no file)
  */
-static void run_experiments() {
-    // Test matrix sizes: spans small to large scale
-    std::vector<int> matrix_sizes = {50, 100, 200, 500, 1000};
-
-    // Test thread counts: evaluates scaling from serial to highly parallel
-    std::vector<int> thread_counts = {1, 4, 16, 32};
-
+static void run_experiments(const BenchOptions& options, const std::vector<int>& matrix_sizes,
+                            const std::vector<int>& thread_counts, const std::string& csv_path) {
     std::cout << "\n############################################\n";
     std::cout << "#  MATRIX MULTIPLICATION EXPERIMENTS      #\n";
     std::cout << "############################################\n";
+    std::cout << "\nRepetitions: " << options.repetitions << " (after " << options.warmup
+              << " warm-up), cache flush: " << (options.flush_cache ? "on" : "off") << "\n";
+
+    // Peak multiply-add throughput of the selected micro-kernel, per thread count
+    // (threads beyond the hardware concurrency add no peak)
+    const GemmKernel<int32_t, int32_t>& kernel = select_gemm_kernel<int32_t, int32_t>();
+    const int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<double> peak_gops;
+    for (int num_threads : thread_counts) {
+        peak_gops.push_back(measure_peak_gops(kernel, std::min(num_threads, hardware_threads)));
+    }
+
+    std::cout << "Micro-kernel: " << kernel.name << "\n";
+    for (size_t t = 0; t < thread_counts.size(); ++t) {
+        std::cout << "Peak (" << thread_counts[t] << " threads): " << std::fixed << std::setprecision(2)
+                  << peak_gops[t] << " GOP/s\n";
+    }
+
+    // One persistent pool per thread count, reused across all sizes (Strategies 6-8)
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    for (int num_threads : thread_counts) {
+        pools.push_back(std::make_unique<ThreadPool>(num_threads));
+    }
+    StrassenArena<int32_t> strassen_arena;
+    const StrassenConfig strassen_config;
+
+    BenchCsv csv(csv_path, {"size", "threads", "strategy", "median_ms", "min_ms", "mean_ms", "stddev_ms",
+                            "gops", "speedup", "efficiency", "check"});
+    if (csv.is_open()) std::cout << "CSV: " << csv_path << "\n";
 
     // Nested loops: test all combinations of size and thread count
     for (int size : matrix_sizes) {
@@ -570,53 +929,869 @@ static void run_experiments() {
         Matrix B(size, size);
         A.randomize(1, 10);
         B.randomize(1, 10);
+        const double ops = 2.0 * size * size * size;
 
-        // Baseline measurement for speedup calculation
+        // Baseline measurement for speedup calculation (and the reference result)
         Matrix C_baseline(size, size);
-        double baseline_time = measure_baseline(A, B, C_baseline);
+        BenchStats baseline = bench_run(options, [&] { measure_baseline(A, B, C_baseline, false); });
+        std::cout << "Baseline (single-threaded): " << std::fixed << std::setprecision(3)
+                  << baseline.median_ms << " ms median, " << baseline.min_ms << " ms min, "
+                  << std::setprecision(2) << ops / (baseline.median_ms * 1e6) << " GOP/s\n";
+        csv.row(size, 1, "Baseline", baseline.median_ms, baseline.min_ms, baseline.mean_ms, baseline.stddev_ms,
+                ops / (baseline.median_ms * 1e6), 1.0, 1.0, "OK");
+
+        std::cout << "\n" << std::setw(26) << std::left << "Strategy" << std::right << std::setw(8) << "Threads"
+                  << std::setw(12) << "Median ms" << std::setw(11) << "Min ms" << std::setw(9) << "Stddev"
+                  << std::setw(10) << "GOP/s" << std::setw(10) << "Speedup" << std::setw(12) << "Efficiency"
+                  << std::setw(8) << "Peak" << std::setw(10) << "Check" << "\n";
 
         // Test each strategy with varying thread counts
-        for (int num_threads : thread_counts) {
+        for (size_t t = 0; t < thread_counts.size(); ++t) {
+            const int num_threads = thread_counts[t];
+            ThreadPool& pool = *pools[t];
+
             // Skip configurations with more threads than elements (pathological case)
             if (num_threads > size * size) continue;
 
-            // Strategy 1: Row-by-row distribution
-            Matrix C1(size, size);
-            double time1 = measure_performance(A, B, C1, num_threads,
-                                               strategy_row_by_row,
-                                               "Strategy 1: Row-by-Row");
-            std::cout << "Speedup vs baseline: " << std::fixed << std::setprecision(2)
-                      << (baseline_time / time1) << "x\n";
-
-            // Strategy 2: Column-by-column distribution
-            Matrix C2(size, size);
-            double time2 = measure_performance(A, B, C2, num_threads,
-                                               strategy_column_by_column,
-                                               "Strategy 2: Column-by-Column");
-            std::cout << "Speedup vs baseline: " << (baseline_time / time2) << "x\n";
-
-            // Strategy 3: Strided (k-th element) distribution
-            Matrix C3(size, size);
-            double time3 = measure_performance(A, B, C3, num_threads,
-                                               strategy_kth_element,
-                                               "Strategy 3: Every k-th Element");
-            std::cout << "Speedup vs baseline: " << (baseline_time / time3) << "x\n";
-
-            // Strategy 4: Cache-Blocked with Optimized Thread Distribution
+            struct Entry {
+                const char* name;
+                std::function<void(Matrix<int32_t>&)> run;
+            };
+            const std::vector<Entry> strategies = {
+                    {"1: Row-by-Row", [&](Matrix<int32_t>& C) {
+                        measure_performance(A, B, C, num_threads, strategy_row_by_row, "", false);
+                    }},
+                    {"2: Column-by-Column", [&](Matrix<int32_t>& C) {
+                        measure_performance(A, B, C, num_threads, strategy_column_by_column, "", false);
+                    }},
+                    {"3: Every k-th Element", [&](Matrix<int32_t>& C) {
+                        measure_performance(A, B, C, num_threads, strategy_kth_element, "", false);
+                    }},
+                    {"4: Cache-Blocked", [&](Matrix<int32_t>& C) {
+                        measure_performance(A, B, C, num_threads, strategy_blocked_optimized, "", false);
+                    }},
+                    {"5: Packed SIMD", [&](Matrix<int32_t>& C) {
+                        measure_performance(A, B, C, num_threads, strategy_packed_simd, "", false);
+                    }},
+                    {"6: Pool Tiles", [&](Matrix<int32_t>& C) {
+                        strategy_pool_tiles(pool, A, B, C);
+                    }},
+                    {"7: Strassen-Winograd", [&](Matrix<int32_t>& C) {
+                        strategy_strassen(pool, strassen_arena, strassen_config, A, B, C);
+                    }},
+                    {"8: Z-Order Recursive", [&](Matrix<int32_t>& C) {
+                        strategy_morton(pool, A, B, C);
+                    }},
+            };
+
+            for (const Entry& strategy : strategies) {
+                Matrix C(size, size);
+                BenchStats stats = bench_run(options, [&] { strategy.run(C); });
+                const bool ok = results_match(C, C_baseline, size);
+                const double gops = ops / (stats.median_ms * 1e6);
+                const double speedup = baseline.median_ms / stats.median_ms;
+                const double efficiency = speedup / num_threads;
+
+                std::cout << std::setw(26) << std::left << strategy.name << std::right << std::setw(8) << num_threads
+                          << std::fixed << std::setprecision(3) << std::setw(12) << stats.median_ms
+                          << std::setw(11) << stats.min_ms << std::setprecision(1)
+                          << std::setw(8) << 100.0 * stats.stddev_ms / stats.median_ms << "%"
+                          << std::setprecision(2) << std::setw(10) << gops << std::setw(9) << speedup << "x"
+                          << std::setprecision(1) << std::setw(11) << 100.0 * efficiency << "%"
+                          << std::setw(7) << 100.0 * gops / peak_gops[t] << "%"
+                          << std::setw(10) << (ok ? "OK" : "MISMATCH") << "\n";
+                csv.row(size, num_threads, strategy.name, stats.median_ms, stats.min_ms, stats.mean_ms,
+                        stats.stddev_ms, gops, speedup, efficiency, ok ? "OK" : "MISMATCH");
+            }
+        }
+    }
+}
+
+
+/**
+ * Pool experiments: Strategy 5 (threads spawned per call, static row bands) against
+ * Strategy 6 (persistent pool, dynamically scheduled tiles).
+ *
+ * - Many small products: `count` back-to-back GEMMs per size, reported as GEMMs/sec,
+ *   where thread creation and join dominate Strategy 5
+ * - Large and non-square products: one GEMM each; the wide and tall shapes leave
+ *   static row bands unbalanced or too thin for the micro-kernel
+ */
+static void run_pool_experiments() {
+    std::vector<int> small_sizes = {64, 96, 128, 192, 256};
+    std::vector<int> thread_counts = {1, 4, 16};
+
+    // Large shapes: {m, n, k}
+    std::vector<std::vector<int>> large_shapes = {
+            {1024, 1024, 1024}, {2048, 2048, 2048}, {96, 4096, 1024}, {4096, 96, 1024}};
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  PERSISTENT POOL VS THREAD-PER-CALL      #\n";
+    std::cout << "############################################\n";
+
+    for (int num_threads : thread_counts) {
+        ThreadPool pool(num_threads);
+
+        std::cout << "\n" << num_threads << " threads - many small GEMMs\n";
+        std::cout << std::setw(8) << "Size" << std::setw(8) << "Count"
+                  << std::setw(16) << "S5 GEMM/s" << std::setw(16) << "S6 GEMM/s"
+                  << std::setw(12) << "S6 GOP/s" << std::setw(10) << "S6/S5" << std::setw(10) << "Check" << "\n";
+
+        for (int size : small_sizes) {
+            // About 2^28 multiply-adds per size
+            const int count = std::max(8, (1 << 28) / (size * size * size));
+            Matrix A(size, size);
+            Matrix B(size, size);
+            A.randomize(1, 10);
+            B.randomize(1, 10);
+            Matrix C5(size, size);
+            Matrix C6(size, size);
+
+            double time5 = 0.0;
+            double time6 = 0.0;
+            for (int i = 0; i < count; ++i) {
+                time5 += measure_performance(A, B, C5, num_threads, strategy_packed_simd, "", false);
+            }
+            for (int i = 0; i < count; ++i) {
+                time6 += measure_pool_performance(pool, A, B, C6, strategy_pool_tiles<int32_t, int32_t>, "", false);
+            }
+
+            double rate5 = count * 1000.0 / time5;
+            double rate6 = count * 1000.0 / time6;
+            std::cout << std::setw(8) << size << std::setw(8) << count
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(16) << rate5 << std::setw(16) << rate6
+                      << std::setprecision(2)
+                      << std::setw(12) << 2.0 * size * size * size * rate6 / 1e9
+                      << std::setw(9) << rate6 / rate5 << "x"
+                      << std::setw(10) << (results_match(C6, C5, size) ? "OK" : "MISMATCH") << "\n";
+        }
+
+        std::cout << "\n" << num_threads << " threads - large and non-square GEMMs\n";
+        std::cout << std::setw(20) << "m x n x k" << std::setw(12) << "S5 GOP/s"
+                  << std::setw(12) << "S6 GOP/s" << std::setw(10) << "S6/S5" << std::setw(10) << "Check" << "\n";
+
+        for (const auto& shape : large_shapes) {
+            const int m = shape[0], n = shape[1], k = shape[2];
+            Matrix A(m, k);
+            Matrix B(k, n);
+            A.randomize(1, 10);
+            B.randomize(1, 10);
+            Matrix C5(m, n);
+            Matrix C6(m, n);
+
+            double time5 = measure_performance(A, B, C5, num_threads, strategy_packed_simd, "", false);
+            double time6 = measure_pool_performance(pool, A, B, C6, strategy_pool_tiles<int32_t, int32_t>, "", false);
+
+            double ops = 2.0 * m * n * k;
+            std::string label = std::to_string(m) + " x " + std::to_string(n) + " x " + std::to_string(k);
+            std::cout << std::setw(20) << label << std::fixed << std::setprecision(2)
+                      << std::setw(12) << ops / (time5 * 1e6) << std::setw(12) << ops / (time6 * 1e6)
+                      << std::setw(9) << time5 / time6 << "x"
+                      << std::setw(10) << (results_match(C6, C5, k) ? "OK" : "MISMATCH") << "\n";
+        }
+    }
+}
+
+
+/**
+ * Per-type throughput: Strategies 4 and 5 for one element / accumulator pair.
+ *
+ * Runs both strategies on all hardware threads for each size and prints one row per
+ * size: GOP/s (2 n^3 operations, i.e. GFLOP/s for floating point), the micro-kernel's
+ * share of its own peak, and the result check of Strategy 5 against Strategy 4.
+ *
+ * @param type_name  Label of the type pair, e.g. "int32 -> int64"
+ * @param sizes      Square matrix sizes to run
+ */
+template <typename T, typename Acc>
+static void run_type_throughput(const char* type_name, const std::vector<int>& sizes) {
+    const GemmKernel<T, Acc>& kernel = select_gemm_kernel<T, Acc>();
+    const int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const double peak = measure_peak_gops(kernel, num_threads);
+
+    std::cout << "\n" << type_name << " (micro-kernel: " << kernel.name << ", peak "
+              << std::fixed << std::setprecision(2) << peak << " GOP/s, "
+              << num_threads << " threads)\n";
+    std::cout << std::setw(8) << "Size" << std::setw(16) << "S4 GOP/s" << std::setw(16) << "S5 GOP/s"
+              << std::setw(14) << "S5 % peak" << std::setw(10) << "Check" << "\n";
+
+    for (int size : sizes) {
+        Matrix<T> A(size, size);
+        Matrix<T> B(size, size);
+        A.randomize(1, 10);
+        B.randomize(1, 10);
+
+        Matrix<Acc> C4(size, size);
+        Matrix<Acc> C5(size, size);
+        double time4 = measure_performance(A, B, C4, num_threads, strategy_blocked_optimized<T, Acc>, "", false);
+        double time5 = measure_performance(A, B, C5, num_threads, strategy_packed_simd<T, Acc>, "", false);
+
+        double ops = 2.0 * size * size * size;
+        double gops4 = ops / (time4 * 1e6);
+        double gops5 = ops / (time5 * 1e6);
+        std::cout << std::setw(8) << size << std::setw(16) << gops4 << std::setw(16) << gops5
+                  << std::setw(13) << 100.0 * gops5 / peak << "%"
+                  << std::setw(10) << (results_match(C5, C4, size) ? "OK" : "MISMATCH") << "\n";
+    }
+}
+
+
+/**
+ * Type sweep: Throughput of the blocked and packed strategies for every supported
+ * element / accumulator pair.
+ */
+static void run_type_experiments() {
+    std::vector<int> sizes = {256, 512, 1024};
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  THROUGHPUT PER ELEMENT TYPE            #\n";
+    std::cout << "############################################\n";
+
+    run_type_throughput<int32_t, int32_t>("int32 -> int32", sizes);
+    run_type_throughput<int32_t, int64_t>("int32 -> int64", sizes);
+    run_type_throughput<int64_t, int64_t>("int64 -> int64", sizes);
+    run_type_throughput<float, float>("float -> float", sizes);
+    run_type_throughput<double, double>("double -> double", sizes);
+}
+
+
+/**
+ * Strassen experiments: Strategy 7 against the blocked Strategy 6 on the same pool.
+ *
+ * 1. Cutoff sweep at 2048 on one thread; the fastest cutoff is used afterwards
+ * 2. Size sweep (odd sizes included, to exercise peeling) per thread count, in
+ *    effective GOP/s (2n^3 / time, so the two columns compare directly)
+ * 3. Crossover: the smallest size above the cutoff from which Strassen stays faster
+ *    for the rest of the sweep
+ */
+static void run_strassen_experiments() {
+    std::vector<int> cutoffs = {64, 128, 256, 512, 1024};
+    std::vector<int> sizes = {256, 512, 768, 1000, 1024, 1536, 2048, 3000, 4096};
+    std::vector<int> thread_counts = {1, 4, 16};
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  STRASSEN-WINOGRAD VS BLOCKED            #\n";
+    std::cout << "############################################\n";
+
+    StrassenArena<int32_t> arena;
+    StrassenConfig config;
+
+    {
+        const int size = 2048;
+        ThreadPool pool(1);
+        Matrix A(size, size);
+        Matrix B(size, size);
+        A.randomize(1, 10);
+        B.randomize(1, 10);
+        Matrix C(size, size);
+
+        std::cout << "\nCutoff sweep (" << size << "x" << size << ", 1 thread)\n";
+        double best_time = 0.0;
+        for (int cutoff : cutoffs) {
+            StrassenConfig candidate{cutoff, -1};
+            double ms = measure_pool_performance(pool, A, B, C, [&](ThreadPool& p, const Matrix<int32_t>& a,
+                                                                    const Matrix<int32_t>& b, Matrix<int32_t>& c) {
+                strategy_strassen(p, arena, candidate, a, b, c);
+            }, "", false);
+            std::cout << "Cutoff " << std::setw(5) << cutoff << ": " << std::fixed << std::setprecision(3)
+                      << ms << " ms\n";
+            if (best_time == 0.0 || ms < best_time) {
+                best_time = ms;
+                config = candidate;
+            }
+        }
+        std::cout << "Using cutoff " << config.cutoff << "\n";
+    }
+
+    for (int num_threads : thread_counts) {
+        ThreadPool pool(num_threads);
+
+        std::cout << "\n" << num_threads << " threads\n";
+        std::cout << std::setw(8) << "Size" << std::setw(16) << "Blocked GOP/s" << std::setw(18) << "Strassen GOP/s"
+                  << std::setw(10) << "Ratio" << std::setw(10) << "Check" << "\n";
+
+        int crossover = 0;
+        for (int size : sizes) {
+            Matrix A(size, size);
+            Matrix B(size, size);
+            A.randomize(1, 10);
+            B.randomize(1, 10);
+            Matrix C6(size, size);
+            Matrix C7(size, size);
+
+            double time6 = measure_pool_performance(pool, A, B, C6, strategy_pool_tiles<int32_t, int32_t>, "", false);
+            double time7 = measure_pool_performance(pool, A, B, C7, [&](ThreadPool& p, const Matrix<int32_t>& a,
+                                                                         const Matrix<int32_t>& b, Matrix<int32_t>& c) {
+                strategy_strassen(p, arena, config, a, b, c);
+            }, "", false);
+
+            double ops = 2.0 * size * size * size;
+            std::cout << std::setw(8) << size << std::fixed << std::setprecision(2)
+                      << std::setw(16) << ops / (time6 * 1e6) << std::setw(18) << ops / (time7 * 1e6)
+                      << std::setw(9) << time6 / time7 << "x"
+                      << std::setw(10) << (results_match(C7, C6, size) ? "OK" : "MISMATCH") << "\n";
+
+            // At or below the cutoff Strassen runs the blocked product itself
+            if (size > config.cutoff && time7 < time6) {
+                if (crossover == 0) crossover = size;
+            } else {
+                crossover = 0;
+            }
+        }
+
+        if (crossover != 0) {
+            std::cout << "Crossover (" << num_threads << " threads): Strassen faster from n = " << crossover << "\n";
+        } else {
+            std::cout << "Crossover (" << num_threads << " threads): not reached up to n = " << sizes.back() << "\n";
+        }
+    }
+}
+
+
+/**
+ * Z-order experiments: Strategy 8 against the row-major blocked strategies, 256 to 8192.
+ *
+ * Columns (GOP/s, all hardware threads):
+ * - S4: Strategy 4 (row-major, BLOCK_SIZE = 64); skipped above MORTON_S4_MAX_SIZE,
+ *   where a single run takes minutes
+ * - S6: Strategy 6 (row-major, packed tiles on the pool)
+ * - Z:  Morton multiply only (operands already in Z-order layout)
+ * - Z+conv: Strategy 8 as a drop-in, conversions to and from row-major included
+ */
+static void run_morton_experiments() {
+    constexpr int MORTON_S4_MAX_SIZE = 2048;
+    std::vector<int> sizes = {256, 512, 1000, 1024, 2048, 3000, 4096, 8192};
+    const int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    ThreadPool pool(num_threads);
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  Z-ORDER LAYOUT VS ROW-MAJOR             #\n";
+    std::cout << "############################################\n";
+    std::cout << "\n" << num_threads << " threads\n";
+    std::cout << std::setw(8) << "Size" << std::setw(12) << "Tiling" << std::setw(10) << "S4"
+              << std::setw(10) << "S6" << std::setw(10) << "Z" << std::setw(10) << "Z+conv"
+              << std::setw(10) << "Check" << "\n";
+
+    for (int size : sizes) {
+        Matrix A(size, size);
+        Matrix B(size, size);
+        A.randomize(1, 10);
+        B.randomize(1, 10);
+        const double ops = 2.0 * size * size * size;
+
+        std::string s4 = "-";
+        if (size <= MORTON_S4_MAX_SIZE) {
             Matrix C4(size, size);
-            double time4 = measure_performance(A, B, C3, num_threads,
-                                               strategy_blocked_optimized,
-                                               "Strategy 4: Cache-Blocked with Optimized Thread Distribution");
-            std::cout << "Speedup vs baseline: " << (baseline_time / time3) << "x\n";
+            double time4 = measure_performance(A, B, C4, num_threads, strategy_blocked_optimized, "", false);
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << ops / (time4 * 1e6);
+            s4 = out.str();
+        }
+
+        Matrix C6(size, size);
+        double time6 = measure_pool_performance(pool, A, B, C6, strategy_pool_tiles<int32_t, int32_t>, "", false);
+
+        // Multiply only, on operands converted beforehand
+        MortonMatrix<int32_t> MA(size, size);
+        MortonMatrix<int32_t> MB(size, size);
+        MortonMatrix<int32_t> MC(size, size);
+        to_morton(pool, A.data.data(), size, MA);
+        to_morton(pool, B.data.data(), size, MB);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        morton_gemm(pool, MA, MB, MC);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double time_z = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+        Matrix C8(size, size);
+        double time8 = measure_pool_performance(pool, A, B, C8, strategy_morton<int32_t, int32_t>, "", false);
+
+        std::string tiling = std::to_string(MC.tiles_per_side()) + "x" + std::to_string(MC.tile);
+        std::cout << std::setw(8) << size << std::setw(12) << tiling << std::setw(10) << s4
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(10) << ops / (time6 * 1e6) << std::setw(10) << ops / (time_z * 1e6)
+                  << std::setw(10) << ops / (time8 * 1e6)
+                  << std::setw(10) << (results_match(C8, C6, size) ? "OK" : "MISMATCH") << "\n";
+    }
+}
+
+
+/**
+ * Auto-tuned plans for one type pair: Strategy 9 against the default plan (Strategy 6).
+ *
+ * For every shape the plan comes from the tuner's cache (searched now on a miss, or
+ * always with retune); then both strategies run once on the full-size product.
+ *
+ * @param tuner      Plan cache
+ * @param type_name  Label of the type pair
+ * @param shapes     Products {m, n, k}
+ * @param threads    Pool sizes to tune for
+ * @param retune     Search again even if the cache has an entry
+ */
+template <typename T, typename Acc>
+static void run_tuned_shapes(GemmTuner& tuner, const char* type_name, const std::vector<std::vector<int>>& shapes,
+                             const std::vector<int>& thread_counts, bool retune) {
+    for (int num_threads : thread_counts) {
+        ThreadPool pool(num_threads);
+
+        std::cout << "\n" << type_name << ", " << num_threads << " threads\n";
+        std::cout << std::setw(20) << "m x n x k" << std::setw(18) << "Class" << std::setw(8) << "Plan"
+                  << std::setw(12) << "S6 GOP/s" << std::setw(12) << "S9 GOP/s" << std::setw(10) << "S9/S6"
+                  << std::setw(10) << "Check" << "  Configuration\n";
+
+        for (const auto& shape : shapes) {
+            const int m = shape[0], n = shape[1], k = shape[2];
+            GemmPlan<T, Acc> plan;
+            const bool cached = !retune && tuner.find(m, n, k, num_threads, plan);
+            if (!cached) plan = tuner.tune<T, Acc>(pool, m, n, k);
+
+            Matrix<T> A(m, k);
+            Matrix<T> B(k, n);
+            A.randomize(1, 10);
+            B.randomize(1, 10);
+            Matrix<Acc> C6(m, n);
+            Matrix<Acc> C9(m, n);
+
+            double time6 = measure_pool_performance(pool, A, B, C6, strategy_pool_tiles<T, Acc>, "", false);
+            double time9 = measure_pool_performance(
+                    pool, A, B, C9,
+                    [&](ThreadPool& p, const Matrix<T>& a, const Matrix<T>& b, Matrix<Acc>& c) {
+                        strategy_tuned(p, tuner, a, b, c);
+                    },
+                    "", false);
+
+            double ops = 2.0 * m * n * k;
+            std::string label = std::to_string(m) + " x " + std::to_string(n) + " x " + std::to_string(k);
+            std::cout << std::setw(20) << label << std::setw(18) << gemm_shape_class(m, n, k)
+                      << std::setw(8) << (cached ? "cache" : "tuned") << std::fixed << std::setprecision(2)
+                      << std::setw(12) << ops / (time6 * 1e6) << std::setw(12) << ops / (time9 * 1e6)
+                      << std::setw(9) << time6 / time9 << "x"
+                      << std::setw(10) << (results_match(C9, C6, k) ? "OK" : "MISMATCH")
+                      << "  " << plan.describe() << "\n";
         }
     }
 }
 
 
+/**
+ * Auto-tuning experiments: Strategy 9 for square, tall, wide and thin-K products,
+ * int32 and double, on 1, 4 and 16 workers.
+ *
+ * Plans are read from GEMM_TUNE_CACHE_FILE in the working directory; missing entries
+ * (all of them on the first run, or with retune) are searched and written back.
+ *
+ * @param retune  Ignore cached plans and search every entry again (--tune)
+ */
+static void run_tuning_experiments(bool retune) {
+    std::vector<std::vector<int>> shapes = {
+            {512, 512, 512}, {1024, 1024, 1024}, {2048, 2048, 2048},
+            {4096, 256, 1024}, {256, 4096, 1024}, {2048, 2048, 128}};
+    std::vector<int> thread_counts = {1, 4, 16};
+    GemmTuner tuner(GEMM_TUNE_CACHE_FILE);
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  AUTO-TUNED BLOCKING AND THREAD GRID     #\n";
+    std::cout << "############################################\n";
+    std::cout << "\nPlan cache: " << tuner.path() << " (" << tuner.size() << " entries"
+              << (retune ? ", ignored: --tune" : "") << ")\n";
+
+    run_tuned_shapes<int32_t, int32_t>(tuner, "int32 -> int32", shapes, thread_counts, retune);
+    run_tuned_shapes<double, double>(tuner, "double -> double", shapes, thread_counts, retune);
+
+    std::cout << "\nPlan cache now has " << tuner.size() << " entries\n";
+}
+
+
+/**
+ * Sparse experiments: CSR / CSC kernels against dense kernels on the same pool.
+ *
+ * 1. SpMV density sweep (4096 x 4096): CSR y = A x against a dense row-band GEMV.
+ *    Also checks CSC y = A^T x.
+ * 2. SpMM density sweep (2048 x 2048 sparse x 2048 x 256 dense): CSR C = A B against
+ *    Strategy 6 on the dense matrix
+ * 3. Load balance on a skewed matrix (a few dense rows): row-count split against
+ *    merge path, as the largest task's share of the nonzeros and as time
+ *
+ * Effective bandwidth counts the minimum traffic: the sparse arrays, the dense
+ * operand and the result, each once. The crossover is the lowest density from which
+ * the dense kernel stays faster.
+ */
+static void run_sparse_experiments() {
+    std::vector<double> densities = {0.0005, 0.001, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.3, 0.5};
+    const int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    ThreadPool pool(num_threads);
+
+    // Milliseconds per call of fn, averaged over enough calls to cover ~50 ms
+    auto time_ms = [](auto&& fn) {
+        int reps = 0;
+        double total = 0.0;
+        while (total < 50.0 || reps < 3) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            total += std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            ++reps;
+        }
+        return total / reps;
+    };
+
+    // Dense y = A x on the pool, one task per row band
+    auto dense_gemv = [&](const Matrix<int32_t>& A, const std::vector<int32_t>& x, std::vector<int64_t>& y) {
+        const int tasks = std::min(A.rows, pool.size() * SPARSE_TASKS_PER_WORKER);
+        pool.parallel_for(tasks, [&](int task, int) {
+            const int r0 = static_cast<int>(static_cast<int64_t>(A.rows) * task / tasks);
+            const int r1 = static_cast<int>(static_cast<int64_t>(A.rows) * (task + 1) / tasks);
+            for (int r = r0; r < r1; ++r) {
+                const int32_t* row = A.data.data() + static_cast<size_t>(r) * A.cols;
+                int64_t sum = 0;
+                for (int c = 0; c < A.cols; ++c) sum += static_cast<int64_t>(row[c]) * x[c];
+                y[r] = sum;
+            }
+        });
+    };
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  SPARSE (CSR / CSC) VS DENSE             #\n";
+    std::cout << "############################################\n";
+
+    // 1. SpMV
+    {
+        const int n = 4096;
+        std::vector<int32_t> x(n);
+        for (int i = 0; i < n; ++i) x[i] = 1 + i % 7;
+        double crossover = -1.0;
+
+        std::cout << "\nSpMV " << n << " x " << n << ", int32 -> int64, " << num_threads << " threads\n";
+        std::cout << std::setw(10) << "Density" << std::setw(12) << "nnz" << std::setw(10) << "Conv ms"
+                  << std::setw(11) << "CSR ms" << std::setw(11) << "CSR GB/s" << std::setw(11) << "Dense ms"
+                  << std::setw(12) << "Dense GB/s" << std::setw(11) << "Dense/CSR" << std::setw(10) << "Check" << "\n";
+
+        for (double density : densities) {
+            Matrix A(n, n);
+            A.randomize_sparse(density, 1, 10);
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            CsrMatrix<int32_t> csr = to_csr(pool, A);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            double conv_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            CscMatrix<int32_t> csc = csc_from_csr(csr);
+
+            std::vector<int64_t> y_csr(n), y_dense(n), y_csc(n), y_ref_t(n, 0);
+            double csr_ms = time_ms([&] { csr_spmv(pool, csr, x.data(), y_csr.data()); });
+            double dense_ms = time_ms([&] { dense_gemv(A, x, y_dense); });
+            csc_spmv(pool, csc, x.data(), y_csc.data());
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < n; ++c) y_ref_t[c] += static_cast<int64_t>(A.at(r, c)) * x[r];
+            }
+
+            const double csr_bytes = spmv_bytes<int32_t, int64_t>(csr.nnz(), n, n);
+            const double dense_bytes = static_cast<double>(n) * n * sizeof(int32_t) + n * (sizeof(int32_t) + sizeof(int64_t));
+            if (dense_ms < csr_ms && crossover < 0.0) crossover = density;
+            if (dense_ms >= csr_ms) crossover = -1.0;
+
+            bool ok = y_csr == y_dense && y_csc == y_ref_t;
+            std::cout << std::setw(10) << density << std::setw(12) << csr.nnz() << std::fixed << std::setprecision(2)
+                      << std::setw(10) << conv_ms << std::setprecision(3) << std::setw(11) << csr_ms
+                      << std::setprecision(2) << std::setw(11) << csr_bytes / (csr_ms * 1e6)
+                      << std::setprecision(3) << std::setw(11) << dense_ms
+                      << std::setprecision(2) << std::setw(12) << dense_bytes / (dense_ms * 1e6)
+                      << std::setw(10) << dense_ms / csr_ms << "x" << std::setw(10) << (ok ? "OK" : "MISMATCH") << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+        if (crossover > 0.0) std::cout << "SpMV crossover: dense is faster from density " << crossover << "\n";
+        else std::cout << "SpMV crossover: CSR is faster at every density tested\n";
+    }
+
+    // 2. SpMM
+    {
+        const int m = 2048, k = 2048, n = 256;
+        Matrix B(k, n);
+        B.randomize(1, 10);
+        double crossover = -1.0;
+
+        std::cout << "\nSpMM " << m << " x " << k << " (sparse) x " << k << " x " << n << ", int32, "
+                  << num_threads << " threads\n";
+        std::cout << std::setw(10) << "Density" << std::setw(12) << "nnz" << std::setw(11) << "CSR ms"
+                  << std::setw(11) << "CSR GB/s" << std::setw(12) << "CSR GOP/s" << std::setw(10) << "S6 ms"
+                  << std::setw(10) << "S6/CSR" << std::setw(10) << "Check" << "\n";
+
+        for (double density : densities) {
+            Matrix A(m, k);
+            A.randomize_sparse(density, 1, 10);
+            CsrMatrix<int32_t> csr = to_csr(pool, A);
+
+            Matrix C_csr(m, n);
+            Matrix C6(m, n);
+            double csr_ms = time_ms([&] { csr_spmm(pool, csr, n, B.data.data(), n, C_csr.data.data(), n); });
+            double dense_ms = time_ms([&] { strategy_pool_tiles(pool, A, B, C6); });
+
+            if (dense_ms < csr_ms && crossover < 0.0) crossover = density;
+            if (dense_ms >= csr_ms) crossover = -1.0;
+
+            const double bytes = spmm_bytes<int32_t, int32_t>(csr.nnz(), m, k, n);
+            std::cout << std::setw(10) << density << std::setw(12) << csr.nnz() << std::fixed
+                      << std::setprecision(3) << std::setw(11) << csr_ms << std::setprecision(2)
+                      << std::setw(11) << bytes / (csr_ms * 1e6)
+                      << std::setw(12) << 2.0 * csr.nnz() * n / (csr_ms * 1e6)
+                      << std::setprecision(3) << std::setw(10) << dense_ms
+                      << std::setprecision(2) << std::setw(9) << dense_ms / csr_ms << "x"
+                      << std::setw(10) << (results_match(C_csr, C6, k) ? "OK" : "MISMATCH") << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+        if (crossover > 0.0) std::cout << "SpMM crossover: dense is faster from density " << crossover << "\n";
+        else std::cout << "SpMM crossover: CSR is faster at every density tested\n";
+    }
+
+    // 3. Load balance: the first 1/128 of the rows are half full, the rest 0.1%
+    {
+        const int n = 8192, dense_rows = n / 128, cols_b = 64;
+        Matrix A(n, n);
+        A.randomize_sparse(0.001, 1, 10);
+        {
+            Matrix head(dense_rows, n);
+            head.randomize_sparse(0.5, 1, 10);
+            std::copy(head.data.begin(), head.data.end(), A.data.begin());
+        }
+        CsrMatrix<int32_t> csr = to_csr(pool, A);
+        Matrix B(n, cols_b);
+        B.randomize(1, 10);
+        std::vector<int32_t> x(n, 1);
+
+        std::cout << "\nLoad balance: " << n << " x " << n << ", " << dense_rows << " rows at 50%, rest at 0.1% ("
+                  << csr.nnz() << " nnz)\n";
+        std::cout << std::setw(10) << "Workers" << std::setw(14) << "Split" << std::setw(12) << "Max/mean"
+                  << std::setw(11) << "SpMV ms" << std::setw(11) << "SpMM ms" << std::setw(10) << "Check" << "\n";
+
+        for (int workers : {num_threads, 16}) {
+            ThreadPool split_pool(workers);
+            std::vector<int64_t> y_ref(n);
+            Matrix C_ref(n, cols_b);
+            csr_spmv(split_pool, csr, x.data(), y_ref.data(), SparseSplit::rows);
+            csr_spmm(split_pool, csr, cols_b, B.data.data(), cols_b, C_ref.data.data(), cols_b, SparseSplit::rows);
+
+            for (SparseSplit split : {SparseSplit::rows, SparseSplit::merge_path}) {
+                const int tasks = workers * SPARSE_TASKS_PER_WORKER;
+                const double imbalance = sparse_imbalance(sparse_partition(csr.row_ptr.data(), n, tasks, split));
+                std::vector<int64_t> y(n);
+                Matrix C(n, cols_b);
+                double mv_ms = time_ms([&] { csr_spmv(split_pool, csr, x.data(), y.data(), split); });
+                double mm_ms = time_ms([&] {
+                    csr_spmm(split_pool, csr, cols_b, B.data.data(), cols_b, C.data.data(), cols_b, split);
+                });
+
+                bool ok = y == y_ref && C.data == C_ref.data;
+                std::cout << std::setw(10) << workers << std::setw(14)
+                          << (split == SparseSplit::rows ? "rows" : "merge path") << std::fixed
+                          << std::setprecision(2) << std::setw(12) << imbalance << std::setprecision(3)
+                          << std::setw(11) << mv_ms << std::setw(11) << mm_ms
+                          << std::setw(10) << (ok ? "OK" : "MISMATCH") << "\n";
+                std::cout.unsetf(std::ios::fixed);
+            }
+        }
+    }
+}
+
+
+/**
+ * Out-of-core experiments: ooc_gemm on memory-mapped, tiled A, B and C files.
+ *
+ * Every run multiplies the same n x n int32 files with a different tile cache size,
+ * from the 4-slot minimum (double buffering only) up to a cache holding both operands.
+ * Per run: wall, compute, I/O and stall time, I/O throughput, overlap (share of the
+ * I/O hidden behind compute), cache hit rate and GOP/s. The result is checked on
+ * sampled elements, each recomputed from A and B through the mappings.
+ *
+ * The files are created in `dir` and removed afterwards. If they fit in RAM the reads
+ * may come from the page cache; matrices larger than RAM (e.g. --ooc 100000, about
+ * 37 GB per file) measure the disk.
+ *
+ * @param n            Matrix side
+ * @param dir          Directory for the three files
+ * @param tile         Tile side
+ * @param cache_sizes  Tile cache sizes to run, in bytes
+ */
+static void run_ooc_experiments(int n, const std::string& dir, int tile, const std::vector<size_t>& cache_sizes) {
+    const int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    ThreadPool pool(num_threads);
+    const std::string path_a = dir + "/ooc_A.bin";
+    const std::string path_b = dir + "/ooc_B.bin";
+    const std::string path_c = dir + "/ooc_C.bin";
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  OUT-OF-CORE (MEMORY-MAPPED) GEMM        #\n";
+    std::cout << "############################################\n";
+
+    try {
+        OocMatrix<int32_t> A(path_a, n, n, tile, true);
+        OocMatrix<int32_t> B(path_b, n, n, tile, true);
+        OocMatrix<int32_t> C(path_c, n, n, tile, true);
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        A.fill(pool, [](int i, int j) { return static_cast<int32_t>(1 + (i * 7 + j * 13) % 10); });
+        B.fill(pool, [](int i, int j) { return static_cast<int32_t>(1 + (i * 11 + j * 5) % 10); });
+        auto end_time = std::chrono::high_resolution_clock::now();
+
+        std::cout << "\n" << n << " x " << n << " int32, " << tile << " x " << tile << " tiles ("
+                  << A.tile_bytes() / (1 << 20) << " MiB), " << A.file_bytes() / double(1 << 30)
+                  << " GiB per file in " << dir << ", " << num_threads << " threads\n";
+        std::cout << "Files written in " << std::fixed << std::setprecision(2)
+                  << std::chrono::duration<double>(end_time - start_time).count() << " s\n";
+        std::cout << std::setw(10) << "Cache MiB" << std::setw(7) << "Slots" << std::setw(7) << "Ahead"
+                  << std::setw(9) << "Wall s" << std::setw(11) << "Compute s" << std::setw(8) << "I/O s"
+                  << std::setw(9) << "Stall s" << std::setw(10) << "I/O GB/s" << std::setw(10) << "Overlap"
+                  << std::setw(8) << "Hits" << std::setw(9) << "GOP/s" << std::setw(10) << "Check" << "\n";
+
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        for (size_t cache_bytes : cache_sizes) {
+            OocStats stats = ooc_gemm(pool, A, B, C, cache_bytes);
+
+            bool ok = true;
+            for (int sample = 0; sample < 32 && ok; ++sample) {
+                const int i = pick(gen);
+                const int j = pick(gen);
+                int32_t expected = 0;
+                for (int k = 0; k < n; ++k) expected += A.at(i, k) * B.at(k, j);
+                ok = C.at(i, j) == expected;
+            }
+
+            const double requests = static_cast<double>(stats.hits + stats.misses);
+            std::cout << std::setw(10) << cache_bytes / (1 << 20) << std::setw(7) << stats.slots
+                      << std::setw(7) << stats.lookahead << std::setprecision(2)
+                      << std::setw(9) << stats.wall_ms / 1000.0 << std::setw(11) << stats.compute_ms / 1000.0
+                      << std::setw(8) << stats.io_ms / 1000.0 << std::setw(9) << stats.stall_ms / 1000.0
+                      << std::setw(10) << stats.io_gbps() << std::setw(9) << 100.0 * stats.overlap() << "%"
+                      << std::setw(7) << (requests > 0 ? 100.0 * stats.hits / requests : 0.0) << "%"
+                      << std::setw(9) << 2.0 * n * n * n / (stats.wall_ms * 1e6)
+                      << std::setw(10) << (ok ? "OK" : "MISMATCH") << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Out-of-core run failed: " << e.what() << "\n";
+    }
+
+    std::remove(path_a.c_str());
+    std::remove(path_b.c_str());
+    std::remove(path_c.c_str());
+}
+
+
+/**
+ * Batched small-matrix experiments: many independent n x n products (int32), with
+ * n from 4 to 32.
+ *
+ * - S4 per call: measure_performance once per matrix (Strategy 4 on 1 thread), with
+ *   the thread spawn, join and config of every call
+ * - S4 inline: Strategy 4's blocked loop nest called directly per matrix (no threads)
+ * - Batched: batched_gemm on the interleaved batch, on 1 worker and on all workers
+ *
+ * The two loops run on the first `sample` matrices only, since their rates are per
+ * matrix. Their results also check the batched results. Sizes 12 and 20 use a
+ * row-blocked and a run-time-n kernel respectively.
+ */
+static void run_batched_experiments() {
+    std::vector<int> sizes = {4, 8, 12, 16, 20, 32};
+    const int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int lanes = batched_gemm_lanes<int32_t, int32_t>();
+    const BenchOptions options{2, 5, false};
+    ThreadPool serial(1);
+    ThreadPool pool(hardware_threads);
+
+    std::cout << "\n############################################\n";
+    std::cout << "#  BATCHED SMALL-MATRIX EXPERIMENTS       #\n";
+    std::cout << "############################################\n";
+    std::cout << "\nInterleave width: " << lanes << " matrices, pool: " << hardware_threads << " workers\n";
+    std::cout << "Rates in million matrices/sec\n\n";
+    std::cout << std::setw(4) << "n" << std::setw(10) << "Batch" << std::setw(33) << "Kernel"
+              << std::setw(13) << "S4 per call" << std::setw(11) << "S4 inline" << std::setw(12) << "Batched x1"
+              << std::setw(12) << ("Batched x" + std::to_string(hardware_threads)) << std::setw(9) << "GOP/s"
+              << std::setw(11) << "vs inline" << std::setw(8) << "Check" << "\n";
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int32_t> dist(1, 10);
+
+    for (int n : sizes) {
+        const int count = std::max(4096, (1 << 24) / (n * n));
+        const int sample = std::min(count, 2048);
+        const double ops = 2.0 * n * n * n;
+
+        MatrixBatch<int32_t> A = make_matrix_batch<int32_t>(count, n, lanes);
+        MatrixBatch<int32_t> B = make_matrix_batch<int32_t>(count, n, lanes);
+        MatrixBatch<int32_t> C = make_matrix_batch<int32_t>(count, n, lanes);
+        for (int b = 0; b < count; ++b) {
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    A.at(b, i, j) = dist(gen);
+                    B.at(b, i, j) = dist(gen);
+                }
+            }
+        }
+
+        // Row-major copies of the sampled matrices for the per-matrix loops
+        std::vector<Matrix<int32_t>> As, Bs, Cs;
+        for (int b = 0; b < sample; ++b) {
+            As.emplace_back(n, n);
+            Bs.emplace_back(n, n);
+            Cs.emplace_back(n, n);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    As[b].at(i, j) = A.at(b, i, j);
+                    Bs[b].at(i, j) = B.at(b, i, j);
+                }
+            }
+        }
+
+        BenchStats per_call = bench_run(options, [&] {
+            for (int b = 0; b < sample; ++b) {
+                measure_performance(As[b], Bs[b], Cs[b], 1, strategy_blocked_optimized, "", false);
+            }
+        });
+        BenchStats inline_loop = bench_run(options, [&] {
+            for (int b = 0; b < sample; ++b) {
+                strategy_blocked_optimized(ThreadConfig<int32_t, int32_t>{0, &As[b], &Bs[b], &Cs[b], 0, n * n});
+            }
+        });
+        BenchStats batched1 = bench_run(options, [&] { batched_gemm(serial, A, B, C); });
+        BenchStats batchedP = bench_run(options, [&] { batched_gemm(pool, A, B, C); });
+
+        bool ok = true;
+        for (int b = 0; b < sample && ok; ++b) {
+            for (int i = 0; i < n && ok; ++i) {
+                for (int j = 0; j < n && ok; ++j) ok = Cs[b].at(i, j) == C.at(b, i, j);
+            }
+        }
+
+        auto rate = [](int matrices, const BenchStats& stats) { return matrices / (stats.median_ms * 1e3); };
+        const double best = std::max(rate(count, batched1), rate(count, batchedP));
+        std::cout << std::setw(4) << n << std::setw(10) << count << std::setw(33)
+                  << select_batched_kernel<int32_t, int32_t>(n).name << std::fixed << std::setprecision(3)
+                  << std::setw(13) << rate(sample, per_call) << std::setw(11) << rate(sample, inline_loop)
+                  << std::setw(12) << rate(count, batched1) << std::setw(12) << rate(count, batchedP)
+                  << std::setprecision(2) << std::setw(9) << best * ops * 1e-3 << std::setw(10)
+                  << best / rate(sample, inline_loop) << "x" << std::setw(8) << (ok ? "OK" : "FAIL") << "\n";
+    }
+}
+
+
 /////////////////////////
 ///   MAIN SECTION    ///
 /////////////////////////
 
+/**
+ * Parses a comma-separated list of positive integers ("256,512,1024"), skipping
+ * entries that are not positive.
+ */
+static std::vector<int> parse_int_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int value = std::atoi(item.c_str());
+        if (value > 0) values.push_back(value);
+    }
+    return values;
+}
+
+
 /**
  * Main entry point: Orchestrates matrix multiplication benchmarks.
  *
@@ -625,14 +1800,45 @@ static void run_experiments() {
  * completely independent output regions, showcasing ideal parallel scaling.
  *
  * Command-line modes:
- * - (no args): Quick demonstration with small matrix
- * - --full: Comprehensive benchmark suite
- * - --debug: Small matrix with verbose element-level output
+ * - (no args): Full experiment suite; Strategy 9 uses cached tuning plans
+ * - --tune: Auto-tuning mode: search every plan again and rewrite the plan cache
+ * - --ooc N [--ooc-dir DIR]: Out-of-core product of N x N matrices in files under DIR
+ *   (default: working directory), e.g. --ooc 100000 for about 37 GB per matrix
+ * - --bench: Strategy sweep only, with harness options
+ *   [--sizes 256,512] [--threads 1,4] [--reps 5] [--warmup 1] [--flush] [--csv FILE]
  */
 int main(int argc, char* argv[]) {
     // Debug Flag
     bool DEBUG = false;
 
+    // Auto-tuning mode
+    bool TUNE = false;
+
+    // Out-of-core mode: matrix side (0: off) and file directory
+    int OOC_SIZE = 0;
+    std::string OOC_DIR = ".";
+
+    // Strategy sweep mode and its harness settings
+    bool BENCH = false;
+    BenchOptions BENCH_OPTIONS;
+    std::vector<int> BENCH_SIZES = {50, 100, 200, 500, 1000};
+    std::vector<int> BENCH_THREADS = {1, 4, 16, 32};
+    std::string BENCH_CSV = "experiments.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tune") TUNE = true;
+        else if (arg == "--ooc" && i + 1 < argc) OOC_SIZE = std::atoi(argv[++i]);
+        else if (arg == "--ooc-dir" && i + 1 < argc) OOC_DIR = argv[++i];
+        else if (arg == "--bench") BENCH = true;
+        else if (arg == "--sizes" && i + 1 < argc) BENCH_SIZES = parse_int_list(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) BENCH_THREADS = parse_int_list(argv[++i]);
+        else if (arg == "--reps" && i + 1 < argc) BENCH_OPTIONS.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--warmup" && i + 1 < argc) BENCH_OPTIONS.warmup = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--flush") BENCH_OPTIONS.flush_cache = true;
+        else if (arg == "--csv" && i + 1 < argc) BENCH_CSV = argv[++i];
+    }
+
     // Seed random number generator for reproducible test data
     srand(static_cast<unsigned>(time(nullptr)));
 
@@ -646,9 +1852,30 @@ int main(int argc, char* argv[]) {
     std::cout << "Pointer size: " << (sizeof(void*) * 8) << "-bit\n";
 
     // Mode selection based on command-line arguments
-    if (DEBUG == false) {
+    if (TUNE) {
+        // Auto-tuning only: fresh search for every shape class, type and thread count
+        run_tuning_experiments(true);
+
+    } else if (OOC_SIZE > 0) {
+        // Out-of-core only: one run with the default tile and cache
+        run_ooc_experiments(OOC_SIZE, OOC_DIR, OOC_DEFAULT_TILE, {OOC_DEFAULT_CACHE_BYTES});
+
+    } else if (BENCH) {
+        // Strategy sweep only: sizes, thread counts and repetitions from the command line
+        run_experiments(BENCH_OPTIONS, BENCH_SIZES, BENCH_THREADS, BENCH_CSV);
+
+    } else if (DEBUG == false) {
         // Full experiment suite: multiple sizes and thread counts
-        run_experiments();
+        run_experiments(BENCH_OPTIONS, BENCH_SIZES, BENCH_THREADS, BENCH_CSV);
+        run_type_experiments();
+        run_pool_experiments();
+        run_strassen_experiments();
+        run_morton_experiments();
+        run_tuning_experiments(false);
+        run_sparse_experiments();
+        run_ooc_experiments(4096, ".", 1024, {size_t(16) << 20, size_t(24) << 20, size_t(48) << 20,
+                                              size_t(128) << 20});
+        run_batched_experiments();
 
     } else {
         // Debug mode: small matrix with detailed element-level logging
@@ -0,0 +1,256 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Morton (Z-order) tiled matrix layout and a cache-oblivious recursive multiply on it.
+ *
+ * Layout: the matrix is padded to (2^levels x tile)^2 and cut into tile x tile tiles.
+ * Each tile is stored contiguously (row-major inside the tile), and the tiles follow
+ * the Z-order curve (Morton index: tile row and column bits interleaved):
+ *
+ *   tiles  0  1 |  4  5          every quadrant of every power-of-two block of tiles
+ *          2  3 |  6  7          is one contiguous range of memory, so a recursive
+ *          -----+-----           algorithm touches contiguous data at every level
+ *          8  9 | 12 13
+ *         10 11 | 14 15
+ *
+ * Multiply: C += A x B recurses on quadrants (8 half-size products) down to single
+ * tiles, which go through the packed micro-kernel. No block size is tuned per cache
+ * level: at some depth the operands of a sub-product fit in L1, L2 and L3 in turn.
+ *
+ * The tile size is picked per matrix as the smallest multiple of MORTON_TILE_ALIGN with
+ * 2^levels tiles covering n and tile <= MORTON_TILE_MAX, so padding stays below one
+ * tile per 2^levels (e.g. 1000 -> 16 x 64, 3000 -> 64 x 48, 8192 -> 128 x 64).
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Largest tile side (64 x 64 int32 = 16 KiB: A, B and C tiles fit in L1 / L2)
+constexpr int MORTON_TILE_MAX = 64;
+
+// Tile sides are multiples of this (keeps rows of a tile vector-aligned)
+constexpr int MORTON_TILE_ALIGN = 16;
+
+/////////////////////
+///    INDEXING   ///
+/////////////////////
+/** Spreads the low 16 bits of x to the even bit positions. */
+static inline uint32_t morton_spread(uint32_t x) {
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+/** Morton index of tile (row, col): ... r1 c1 r0 c0 (quadrant order TL, TR, BL, BR). */
+static inline uint32_t morton_index(uint32_t row, uint32_t col) {
+    return (morton_spread(row) << 1) | morton_spread(col);
+}
+
+/////////////////////
+///    MATRIX     ///
+/////////////////////
+/**
+ * MortonMatrix: rows x cols matrix in Z-order tiled layout (zero padding outside).
+ */
+template <typename T>
+struct MortonMatrix {
+    int rows = 0;
+    int cols = 0;
+    int tile = MORTON_TILE_ALIGN;  // Tile side
+    int levels = 0;                // 2^levels tiles per side
+    AlignedBuffer<T> data;
+
+    MortonMatrix() = default;
+
+    /**
+     * Allocates a zeroed matrix covering rows x cols.
+     * @param side_hint  Side the tiling must cover (pass the largest dimension of all
+     *                   operands so A, B and C get the same tiling)
+     */
+    MortonMatrix(int r, int c, int side_hint = 0) : rows(r), cols(c) {
+        const int side = std::max({r, c, side_hint, 1});
+        while ((1 << levels) * MORTON_TILE_MAX < side) ++levels;
+        const int per_side = 1 << levels;
+        tile = ((side + per_side - 1) / per_side + MORTON_TILE_ALIGN - 1) / MORTON_TILE_ALIGN * MORTON_TILE_ALIGN;
+        data = make_aligned_buffer<T>(elements());
+        std::fill(data.get(), data.get() + elements(), T(0));
+    }
+
+    int tiles_per_side() const { return 1 << levels; }
+    int padded() const { return tile << levels; }
+    size_t tile_elements() const { return static_cast<size_t>(tile) * tile; }
+    size_t elements() const { return tile_elements() << (2 * levels); }
+
+    /** Start of tile (ti, tj). */
+    T* tile_at(int ti, int tj) { return data.get() + morton_index(ti, tj) * tile_elements(); }
+    const T* tile_at(int ti, int tj) const { return data.get() + morton_index(ti, tj) * tile_elements(); }
+
+    /** Element (i, j) (for checks and debugging; not for hot loops). */
+    T at(int i, int j) const { return tile_at(i / tile, j / tile)[(i % tile) * tile + j % tile]; }
+};
+
+/////////////////////
+///  CONVERSION   ///
+/////////////////////
+/**
+ * Copies a row-major matrix (rows x cols, row stride ld) into Morton layout.
+ * Tiles are independent, so they are converted as tasks on `pool`.
+ */
+template <typename T>
+static void to_morton(ThreadPool& pool, const T* src, int ld, MortonMatrix<T>& dst) {
+    const int per_side = dst.tiles_per_side();
+    const int tile = dst.tile;
+    pool.parallel_for(per_side * per_side, [&](int task, int) {
+        const int ti = task / per_side;
+        const int tj = task % per_side;
+        T* out = dst.tile_at(ti, tj);
+        const int r0 = ti * tile;
+        const int c0 = tj * tile;
+        const int rows = std::clamp(dst.rows - r0, 0, tile);
+        const int cols = std::clamp(dst.cols - c0, 0, tile);
+
+        for (int r = 0; r < rows; ++r) {
+            const T* row = src + static_cast<size_t>(r0 + r) * ld + c0;
+            std::copy(row, row + cols, out + r * tile);
+            std::fill(out + r * tile + cols, out + (r + 1) * tile, T(0));
+        }
+        std::fill(out + rows * tile, out + tile * tile, T(0));
+    });
+}
+
+/**
+ * Copies a Morton matrix back to row-major (rows x cols, row stride ld).
+ */
+template <typename T>
+static void from_morton(ThreadPool& pool, const MortonMatrix<T>& src, T* dst, int ld) {
+    const int per_side = src.tiles_per_side();
+    const int tile = src.tile;
+    pool.parallel_for(per_side * per_side, [&](int task, int) {
+        const int ti = task / per_side;
+        const int tj = task % per_side;
+        const T* in = src.tile_at(ti, tj);
+        const int r0 = ti * tile;
+        const int c0 = tj * tile;
+        const int rows = std::clamp(src.rows - r0, 0, tile);
+        const int cols = std::clamp(src.cols - c0, 0, tile);
+
+        for (int r = 0; r < rows; ++r) {
+            std::copy(in + r * tile, in + r * tile + cols, dst + static_cast<size_t>(r0 + r) * ld + c0);
+        }
+    });
+}
+
+/////////////////////
+///   MULTIPLY    ///
+/////////////////////
+/**
+ * C += A x B for one tile of each, through the packed micro-kernel.
+ */
+template <typename T, typename Acc>
+static void morton_tile_multiply(const GemmKernel<T, Acc>& kern, int tile,
+                                 const T* a, const T* b, Acc* c, GemmWorkspace<T, Acc>& ws) {
+    pack_a(a, tile, tile, tile, kern.mr, ws.a_pack.get());
+    pack_b(b, tile, tile, tile, kern.nr, ws.b_pack.get());
+    packed_macro_kernel(kern, tile, tile, tile, ws.a_pack.get(), ws.b_pack.get(), c, tile, true, ws.tile.data());
+}
+
+/**
+ * Cache-oblivious C += A x B on blocks of `side` x `side` tiles (side a power of two).
+ * a, b, c point to the blocks' first tile; each quadrant is `quad` elements further.
+ *
+ *   C11 += A11 B11 + A12 B21    C12 += A11 B12 + A12 B22
+ *   C21 += A21 B11 + A22 B21    C22 += A21 B12 + A22 B22
+ */
+template <typename T, typename Acc>
+static void morton_multiply_rec(const GemmKernel<T, Acc>& kern, int tile, int side,
+                                const T* a, const T* b, Acc* c, GemmWorkspace<T, Acc>& ws) {
+    if (side == 1) {
+        morton_tile_multiply(kern, tile, a, b, c, ws);
+        return;
+    }
+
+    const size_t quad = static_cast<size_t>(tile) * tile * (side / 2) * (side / 2);
+    const int half = side / 2;
+    const T* a11 = a;
+    const T* a12 = a + quad;
+    const T* a21 = a + 2 * quad;
+    const T* a22 = a + 3 * quad;
+    const T* b11 = b;
+    const T* b12 = b + quad;
+    const T* b21 = b + 2 * quad;
+    const T* b22 = b + 3 * quad;
+    Acc* c11 = c;
+    Acc* c12 = c + quad;
+    Acc* c21 = c + 2 * quad;
+    Acc* c22 = c + 3 * quad;
+
+    // Order keeps one operand quadrant shared between consecutive calls
+    morton_multiply_rec(kern, tile, half, a11, b11, c11, ws);
+    morton_multiply_rec(kern, tile, half, a11, b12, c12, ws);
+    morton_multiply_rec(kern, tile, half, a21, b12, c22, ws);
+    morton_multiply_rec(kern, tile, half, a21, b11, c21, ws);
+    morton_multiply_rec(kern, tile, half, a22, b21, c21, ws);
+    morton_multiply_rec(kern, tile, half, a22, b22, c22, ws);
+    morton_multiply_rec(kern, tile, half, a12, b22, c12, ws);
+    morton_multiply_rec(kern, tile, half, a12, b21, c11, ws);
+}
+
+/**
+ * C = A x B for Morton matrices with the same tiling (A: m x k, B: k x n, C: m x n).
+ *
+ * The top `depth` levels are split over C only: the 4^depth C blocks are independent
+ * tasks on `pool` (depth = smallest with 4^depth >= 4 x workers), and each task sums
+ * its row of A blocks times its column of B blocks with the sequential recursion.
+ */
+template <typename T, typename Acc>
+static void morton_gemm(ThreadPool& pool, const MortonMatrix<T>& A, const MortonMatrix<T>& B, MortonMatrix<Acc>& C) {
+    const GemmKernel<T, Acc>& kern = select_gemm_kernel<T, Acc>();
+    const int tile = C.tile;
+    const int levels = C.levels;
+
+    int depth = 0;
+    while (depth < levels && (1 << (2 * depth)) < 4 * pool.size()) ++depth;
+    if (pool.size() == 1) depth = 0;
+
+    const int grid = 1 << depth;
+    const int side = 1 << (levels - depth);
+    const size_t block = static_cast<size_t>(tile) * tile * side * side;
+
+    std::fill(C.data.get(), C.data.get() + C.elements(), Acc(0));
+
+    pool.parallel_for(grid * grid, [&](int task, int) {
+        static thread_local GemmWorkspace<T, Acc> ws;
+        ws.reserve(static_cast<size_t>(tile + kern.mr) * tile, static_cast<size_t>(tile + kern.nr) * tile,
+                   static_cast<size_t>(kern.mr) * kern.nr);
+
+        // Tasks in Morton order too, so neighbouring tasks share operand blocks
+        int bi = 0, bj = 0;
+        for (int bit = 0; bit < depth; ++bit) {
+            bj |= ((task >> (2 * bit)) & 1) << bit;
+            bi |= ((task >> (2 * bit + 1)) & 1) << bit;
+        }
+
+        Acc* c = C.data.get() + morton_index(bi, bj) * block;
+        for (int bk = 0; bk < grid; ++bk) {
+            const T* a = A.data.get() + morton_index(bi, bk) * block;
+            const T* b = B.data.get() + morton_index(bk, bj) * block;
+            morton_multiply_rec(kern, tile, side, a, b, c, ws);
+        }
+    });
+}
@@ -0,0 +1,535 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX  // Keep std::min / std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Out-of-core C = A x B for matrices in memory-mapped files (POSIX mmap on Linux/macOS,
+ * CreateFileMapping/MapViewOfFile on Windows).
+ *
+ * Layout: each file holds whole tile x tile tiles (row-major inside a tile, tiles in
+ * row-major order, edges zero-padded), so every tile is one contiguous range of the
+ * file and is read or written sequentially.
+ *
+ * Pipeline (OocGemm::run):
+ *
+ *   I/O thread:      load A(i,k), B(k,j) for step s + 1 ... s + lookahead  |  write C(i,j)
+ *   compute (pool):  C(i,j) += A(i,k) B(k,j) for step s on resident tiles  |  next C buffer
+ *
+ * - The steps are known in advance (C tiles row by row, k innermost), so the I/O thread
+ *   walks the same list ahead of the compute threads and fills the tile cache.
+ * - The tile cache is bounded: `slots` tile buffers, LRU replacement among tiles no
+ *   pending step needs. A tile still in the cache when a later step asks for it again
+ *   (e.g. the row panel of A while the C row is computed) is a hit and costs no I/O.
+ * - The I/O thread pins the tiles of every step it prepares, and the compute threads
+ *   unpin them after the step, so a tile is never evicted before its use. The lookahead
+ *   is slots / 2 - 1 steps. The minimum of 4 slots is plain double buffering: one step
+ *   being computed while the next one loads.
+ * - C tiles accumulate in two in-memory buffers. A finished C tile is written back by
+ *   the I/O thread while the compute threads start on the other buffer.
+ * - Tiles are copied between the mapping and the cache with memcpy. Page faults do the
+ *   actual disk reads, helped by MADV_WILLNEED / MADV_SEQUENTIAL on the tile's range.
+ *   Afterwards MADV_DONTNEED unmaps the range, so the process's resident memory stays
+ *   at cache + 2 C tiles whatever the file sizes (the kernel may still keep the pages
+ *   in the page cache). On Windows PrefetchVirtualMemory replaces the read-ahead
+ *   hints, FlushViewOfFile replaces msync, and dropping pages is left to the working
+ *   set manager.
+ *
+ * Statistics: I/O busy time and bytes give the I/O throughput. The time the compute
+ * threads wait for tiles (stall) against the I/O busy time gives the overlap, i.e. the
+ * share of I/O hidden behind compute.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Default tile side (2048^2 x 4 B = 16 MiB per tile)
+constexpr int OOC_DEFAULT_TILE = 2048;
+
+// Default tile cache size
+constexpr size_t OOC_DEFAULT_CACHE_BYTES = size_t(1) << 30;
+
+// Fewest cache slots (two steps of A and B tiles: double buffering)
+constexpr int OOC_MIN_SLOTS = 4;
+
+/////////////////////
+///    MATRIX     ///
+/////////////////////
+/**
+ * OocMatrix: rows x cols matrix stored tile by tile in a memory-mapped file.
+ */
+template <typename T>
+class OocMatrix {
+public:
+    /**
+     * Maps `path`, creating (or resizing) it if `create`, else opening the existing file.
+     * @throws std::runtime_error if the file cannot be opened, sized or mapped
+     */
+    OocMatrix(std::string path, int rows, int cols, int tile, bool create)
+            : path_(std::move(path)), rows_(rows), cols_(cols), tile_(tile),
+              tiles_m_((rows + tile - 1) / tile), tiles_n_((cols + tile - 1) / tile) {
+#if defined(_WIN32)
+        file_ = CreateFileA(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                            create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) fail("CreateFile");
+
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(file_bytes());
+        if (create && (!SetFilePointerEx(file_, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)))
+            fail("SetEndOfFile");
+
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE, static_cast<DWORD>(size.QuadPart >> 32),
+                                      static_cast<DWORD>(size.QuadPart & 0xFFFFFFFF), nullptr);
+        if (mapping_ == nullptr) fail("CreateFileMapping");
+        void* map = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, file_bytes());
+        if (map == nullptr) fail("MapViewOfFile");
+#else
+        fd_ = ::open(path_.c_str(), create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+        if (fd_ < 0) fail("open");
+        if (create && ::ftruncate(fd_, static_cast<off_t>(file_bytes())) != 0) fail("ftruncate");
+
+        void* map = ::mmap(nullptr, file_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) fail("mmap");
+#endif
+        map_ = static_cast<T*>(map);
+    }
+
+    ~OocMatrix() {
+#if defined(_WIN32)
+        if (map_ != nullptr) UnmapViewOfFile(map_);
+        close_handles();
+#else
+        if (map_ != nullptr) ::munmap(map_, file_bytes());
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    OocMatrix(const OocMatrix&) = delete;
+    OocMatrix& operator=(const OocMatrix&) = delete;
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int tile() const { return tile_; }
+    int tiles_m() const { return tiles_m_; }
+    int tiles_n() const { return tiles_n_; }
+    const std::string& path() const { return path_; }
+    size_t tile_elements() const { return static_cast<size_t>(tile_) * tile_; }
+    size_t tile_bytes() const { return tile_elements() * sizeof(T); }
+    size_t file_bytes() const { return static_cast<size_t>(tiles_m_) * tiles_n_ * tile_bytes(); }
+
+    /** Tile (ti, tj) inside the mapping. */
+    T* tile_data(int ti, int tj) { return map_ + (static_cast<size_t>(ti) * tiles_n_ + tj) * tile_elements(); }
+    const T* tile_data(int ti, int tj) const {
+        return map_ + (static_cast<size_t>(ti) * tiles_n_ + tj) * tile_elements();
+    }
+
+    /** Copies tile (ti, tj) from the file into `out` and drops the mapped pages. */
+    void read_tile(int ti, int tj, T* out) const {
+        const T* src = tile_data(ti, tj);
+        will_read(src);
+        std::memcpy(out, src, tile_bytes());
+        drop(src);
+    }
+
+    /** Copies `in` into tile (ti, tj) of the file, starts write-back and drops the pages. */
+    void write_tile(int ti, int tj, const T* in) {
+        T* dst = tile_data(ti, tj);
+        std::memcpy(dst, in, tile_bytes());
+        write_back(dst);
+        drop(dst);
+    }
+
+    /** Element (i, j), read through the mapping (for checks). */
+    T at(int i, int j) const {
+        return tile_data(i / tile_, j / tile_)[static_cast<size_t>(i % tile_) * tile_ + j % tile_];
+    }
+
+    /**
+     * Writes value(i, j) to every element (zero in the padding), one tile per task,
+     * dropping each tile's pages once written.
+     */
+    template <typename Fn>
+    void fill(ThreadPool& pool, Fn&& value) {
+        pool.parallel_for(tiles_m_ * tiles_n_, [&](int task, int) {
+            const int ti = task / tiles_n_;
+            const int tj = task % tiles_n_;
+            T* dst = tile_data(ti, tj);
+            for (int r = 0; r < tile_; ++r) {
+                for (int c = 0; c < tile_; ++c) {
+                    const int i = ti * tile_ + r;
+                    const int j = tj * tile_ + c;
+                    dst[static_cast<size_t>(r) * tile_ + c] = (i < rows_ && j < cols_) ? value(i, j) : T(0);
+                }
+            }
+            write_back(dst);
+            drop(dst);
+        });
+    }
+
+private:
+    /** Starts reading a tile's pages ahead of the copy. */
+    void will_read(const T* tile) const {
+#if defined(_WIN32)
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+        WIN32_MEMORY_RANGE_ENTRY range{const_cast<T*>(tile), tile_bytes()};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        (void)tile;  // PrefetchVirtualMemory needs Windows 8; page faults do the reads
+#endif
+#else
+        ::madvise(const_cast<T*>(tile), tile_bytes(), MADV_WILLNEED);
+        ::madvise(const_cast<T*>(tile), tile_bytes(), MADV_SEQUENTIAL);
+#endif
+    }
+
+    /** Starts writing a tile's dirty pages back to the file (does not wait). */
+    void write_back(T* tile) const {
+#if defined(_WIN32)
+        FlushViewOfFile(tile, tile_bytes());
+#else
+        ::msync(tile, tile_bytes(), MS_ASYNC);
+#endif
+    }
+
+    /** Drops a tile's pages from the process (no-op on Windows: the working set manager trims them). */
+    void drop(const T* tile) const {
+#if defined(_WIN32)
+        (void)tile;
+#else
+        ::madvise(const_cast<T*>(tile), tile_bytes(), MADV_DONTNEED);
+#endif
+    }
+
+#if defined(_WIN32)
+    void close_handles() {
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+    }
+
+    [[noreturn]] void fail(const char* what) {
+        const std::string message = path_ + ": " + what + ": error " + std::to_string(GetLastError());
+        close_handles();
+        throw std::runtime_error(message);
+    }
+#else
+    [[noreturn]] void fail(const char* what) {
+        const std::string message = path_ + ": " + what + ": " + std::strerror(errno);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(message);
+    }
+#endif
+
+    std::string path_;
+    int rows_;
+    int cols_;
+    int tile_;
+    int tiles_m_;
+    int tiles_n_;
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    T* map_ = nullptr;
+};
+
+/////////////////////
+///     STATS     ///
+/////////////////////
+/**
+ * OocStats: Time and traffic of one out-of-core product.
+ */
+struct OocStats {
+    int slots = 0;
+    int lookahead = 0;
+    double wall_ms = 0.0;
+    double compute_ms = 0.0;  // Compute threads busy in the kernel
+    double stall_ms = 0.0;    // Compute threads waiting for tiles or a free C buffer
+    double io_ms = 0.0;       // I/O thread busy reading or writing
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t hits = 0;        // Tile requests served by the cache
+    uint64_t misses = 0;      // Tile requests read from the file
+
+    double io_gbps() const { return io_ms > 0.0 ? (bytes_read + bytes_written) / (io_ms * 1e6) : 0.0; }
+
+    /** Share of the I/O time hidden behind compute (1: the compute threads never waited). */
+    double overlap() const { return io_ms > 0.0 ? std::clamp(1.0 - stall_ms / io_ms, 0.0, 1.0) : 1.0; }
+};
+
+/////////////////////
+///    ENGINE     ///
+/////////////////////
+/**
+ * OocGemm: One out-of-core product C = A x B with a tile cache of `cache_bytes`.
+ */
+template <typename T, typename Acc>
+class OocGemm {
+public:
+    OocGemm(const OocMatrix<T>& A, const OocMatrix<T>& B, OocMatrix<Acc>& C, size_t cache_bytes)
+            : A_(A), B_(B), C_(C), tile_(A.tile()) {
+        if (B.tile() != tile_ || C.tile() != tile_ || A.cols() != B.rows() || C.rows() != A.rows() ||
+            C.cols() != B.cols()) {
+            throw std::invalid_argument("OocGemm: operands must share the tile size and have matching shapes");
+        }
+        const int slots = std::max<int>(OOC_MIN_SLOTS, static_cast<int>(cache_bytes / A.tile_bytes()));
+        stats_.slots = slots;
+        stats_.lookahead = slots / 2 - 1;
+        slots_.resize(slots);
+        for (Slot& slot : slots_) slot.data = make_aligned_buffer<T>(A.tile_elements());
+        for (auto& buffer : c_tiles_) buffer = make_aligned_buffer<Acc>(C.tile_elements());
+
+        // C tiles row by row, k innermost
+        for (int ti = 0; ti < C.tiles_m(); ++ti) {
+            for (int tj = 0; tj < C.tiles_n(); ++tj) {
+                for (int tk = 0; tk < A.tiles_n(); ++tk) steps_.push_back({ti, tj, tk});
+            }
+        }
+        step_slots_.assign(steps_.size(), {-1, -1});
+    }
+
+    /**
+     * Runs the product: the I/O thread streams tiles, the calling thread drives the
+     * compute on `pool` (tiled_gemm on each resident A, B tile pair).
+     */
+    OocStats run(ThreadPool& pool) {
+        const GemmKernel<T, Acc>& kern = select_gemm_kernel<T, Acc>();
+        const GemmBlocking blk{};
+        auto wall_start = std::chrono::high_resolution_clock::now();
+        std::thread io([this] { io_loop(); });
+
+        int c_index = 0;
+        for (size_t s = 0; s < steps_.size(); ++s) {
+            const Step step = steps_[s];
+            const bool first = step.tk == 0;
+            const bool last = step.tk == A_.tiles_n() - 1;
+            Acc* c = c_tiles_[c_index % 2].get();
+
+            // Wait for this step's tiles (and, on a new C tile, for its buffer's write-back)
+            auto wait_start = std::chrono::high_resolution_clock::now();
+            int a_slot, b_slot;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                compute_cv_.wait(lock, [&] {
+                    return step_slots_[s][1] >= 0 && slots_[step_slots_[s][0]].ready &&
+                           slots_[step_slots_[s][1]].ready && !(first && c_pending_[c_index % 2]);
+                });
+                a_slot = step_slots_[s][0];
+                b_slot = step_slots_[s][1];
+            }
+            auto compute_start = std::chrono::high_resolution_clock::now();
+            stats_.stall_ms += std::chrono::duration<double, std::milli>(compute_start - wait_start).count();
+
+            tiled_gemm(pool, kern, blk, tile_, tile_, tile_, slots_[a_slot].data.get(), tile_,
+                       slots_[b_slot].data.get(), tile_, c, tile_, !first);
+            stats_.compute_ms += std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - compute_start).count();
+
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                for (int slot : {a_slot, b_slot}) {
+                    --slots_[slot].pins;
+                    slots_[slot].last_use = ++clock_;
+                }
+                consumed_ = s + 1;
+                if (last) {
+                    c_pending_[c_index % 2] = true;
+                    writes_.push_back({step.ti, step.tj, c_index % 2});
+                    ++c_index;
+                }
+            }
+            io_cv_.notify_one();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            done_ = true;
+        }
+        io_cv_.notify_one();
+        io.join();
+
+        stats_.wall_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - wall_start).count();
+        return stats_;
+    }
+
+private:
+    struct Step {
+        int ti;
+        int tj;
+        int tk;
+    };
+
+    struct Slot {
+        AlignedBuffer<T> data;
+        uint64_t key = ~uint64_t(0);
+        int pins = 0;
+        bool ready = false;
+        uint64_t last_use = 0;
+    };
+
+    struct WriteJob {
+        int ti;
+        int tj;
+        int buffer;
+    };
+
+    static uint64_t key(int matrix, int ti, int tj) {
+        return (static_cast<uint64_t>(matrix) << 62) | (static_cast<uint64_t>(ti) << 31) | static_cast<uint64_t>(tj);
+    }
+
+    /** Runs queued C write-backs (lock held on entry and exit, released while writing). */
+    void drain_writes(std::unique_lock<std::mutex>& lock) {
+        while (!writes_.empty()) {
+            const WriteJob job = writes_.front();
+            writes_.pop_front();
+            lock.unlock();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            C_.write_tile(job.ti, job.tj, c_tiles_[job.buffer].get());
+            stats_.io_ms += std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+            stats_.bytes_written += C_.tile_bytes();
+
+            lock.lock();
+            c_pending_[job.buffer] = false;
+            compute_cv_.notify_one();
+        }
+    }
+
+    /** Waits for `ready` while serving write-backs (so the compute threads never wait on a blocked I/O thread). */
+    template <typename Pred>
+    void io_wait(std::unique_lock<std::mutex>& lock, Pred ready) {
+        while (true) {
+            drain_writes(lock);
+            if (ready()) return;
+            io_cv_.wait(lock, [&] { return !writes_.empty() || ready(); });
+        }
+    }
+
+    /** Pins the tile for a step, loading it into the least recently used free slot on a miss. */
+    int acquire(std::unique_lock<std::mutex>& lock, int matrix, int ti, int tj) {
+        const uint64_t k = key(matrix, ti, tj);
+        auto it = where_.find(k);
+        if (it != where_.end()) {
+            ++slots_[it->second].pins;
+            ++stats_.hits;
+            return it->second;
+        }
+
+        int victim = -1;
+        io_wait(lock, [&] {
+            victim = -1;
+            for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+                if (slots_[i].pins == 0 && (victim < 0 || slots_[i].last_use < slots_[victim].last_use)) victim = i;
+            }
+            return victim >= 0;
+        });
+
+        Slot& slot = slots_[victim];
+        if (slot.key != ~uint64_t(0)) where_.erase(slot.key);
+        slot.key = k;
+        slot.pins = 1;
+        slot.ready = false;
+        where_[k] = victim;
+        ++stats_.misses;
+        lock.unlock();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        (matrix == 0 ? A_ : B_).read_tile(ti, tj, slot.data.get());
+        stats_.io_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+        stats_.bytes_read += A_.tile_bytes();
+
+        lock.lock();
+        slot.ready = true;
+        return victim;
+    }
+
+    void io_loop() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        for (size_t s = 0; s < steps_.size(); ++s) {
+            // Stay at most `lookahead` steps ahead of the compute threads
+            io_wait(lock, [&] { return s <= consumed_ + stats_.lookahead; });
+
+            const Step step = steps_[s];
+            const int a_slot = acquire(lock, 0, step.ti, step.tk);
+            step_slots_[s][0] = a_slot;
+            const int b_slot = acquire(lock, 1, step.tk, step.tj);
+            step_slots_[s][1] = b_slot;
+            compute_cv_.notify_one();
+        }
+        io_wait(lock, [&] { return done_ && writes_.empty(); });
+    }
+
+    const OocMatrix<T>& A_;
+    const OocMatrix<T>& B_;
+    OocMatrix<Acc>& C_;
+    const int tile_;
+
+    std::vector<Step> steps_;
+    std::vector<Slot> slots_;
+    std::vector<std::array<int, 2>> step_slots_;  // Cache slots of A and B per step (-1: not yet)
+    std::unordered_map<uint64_t, int> where_;     // Tile key -> slot
+    AlignedBuffer<Acc> c_tiles_[2];
+    bool c_pending_[2] = {false, false};          // Buffer waiting for write-back
+    std::deque<WriteJob> writes_;
+
+    std::mutex mtx_;
+    std::condition_variable compute_cv_;
+    std::condition_variable io_cv_;
+    size_t consumed_ = 0;  // Steps finished by the compute threads
+    uint64_t clock_ = 0;
+    bool done_ = false;
+
+    // Written by the I/O thread (io_ms, bytes, hits, misses) or the compute thread (the
+    // rest) only; read after the join
+    OocStats stats_;
+};
+
+/**
+ * C = A x B out of core with a tile cache of `cache_bytes`.
+ * @return  Timing, traffic and overlap of the run
+ */
+template <typename T, typename Acc>
+static OocStats ooc_gemm(ThreadPool& pool, const OocMatrix<T>& A, const OocMatrix<T>& B, OocMatrix<Acc>& C,
+                         size_t cache_bytes = OOC_DEFAULT_CACHE_BYTES) {
+    OocGemm<T, Acc> gemm(A, B, C, cache_bytes);
+    return gemm.run(pool);
+}
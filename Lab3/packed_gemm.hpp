@@ -0,0 +1,760 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PACKED_GEMM_X86 1
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Packed GEMM engine (GotoBLAS / BLIS loop structure) for row-major matrices,
+ * C (Acc) = A (T) x B (T), templated on the element type T and accumulator type Acc.
+ *
+ *   for jc in N step NC            B panel KC x NC  -> packed B~ (shared L3)
+ *     for pc in K step KC
+ *       pack B~ into NR-column slivers
+ *       for ic in M step MC        A block MC x KC  -> packed A~ (L2)
+ *         pack A~ into MR-row slivers
+ *         for jr in NC step NR     one B~ sliver (KC x NR) stays in L1
+ *           for ir in MC step MR
+ *             micro-kernel: MR x NR tile of C held in registers, KC rank-1 updates
+ *
+ * Packing copies every sliver into a contiguous, 64-byte aligned buffer in exactly the
+ * order the micro-kernel reads it (zero-padded at the edges), so the kernel only sees
+ * unit-stride loads whatever the shape and row stride of A and B.
+ *
+ * The micro-kernel is one template per instruction set, specialised per type through an
+ * "Ops" description (load, broadcast, multiply-add, store). It is picked once per type
+ * at run time from the CPU features:
+ *
+ * | T -> Acc      | AVX-512 (MR x NR)           | AVX2 + FMA (MR x NR)           |
+ * |---------------|-----------------------------|--------------------------------|
+ * | int32 -> int32| 12 x 32, vpmulld + vpaddd   | 6 x 16, vpmulld + vpaddd       |
+ * | int32 -> int64| 12 x 16, vpmuldq + vpaddq   | 6 x 8, vpmuldq + vpaddq        |
+ * | int64 -> int64| 12 x 16, vpmullq + vpaddq   | - (scalar)                     |
+ * | float         | 12 x 32, vfmadd (ps)        | 6 x 16, vfmadd (ps)            |
+ * | double        | 12 x 16, vfmadd (pd)        | 6 x 8, vfmadd (pd)             |
+ *
+ * Any other pair, and CPUs without AVX2, use a portable 4 x 4 scalar kernel.
+ *
+ * Three drivers share the loop body: packed_gemm (one thread, callers split rows),
+ * tiled_gemm (MC x NC tiles of C as tasks on a persistent ThreadPool) and grid_gemm
+ * (a fixed 2D grid of C blocks, one per task). Other MR for the same instruction
+ * sets are listed by gemm_kernel_candidates() for the auto-tuner (gemm_tuner.hpp).
+ * The peak used for "% of peak" is measured with the kernel's own multiply-add on
+ * registers only (no loads), i.e. the ceiling for this kernel on this machine.
+ */
+
+/////////////////////
+///    TYPES      ///
+/////////////////////
+/**
+ * GemmKernel: One micro-kernel and its register tile shape.
+ */
+template <typename T, typename Acc>
+struct GemmKernel {
+    const char* name;
+    int mr;
+    int nr;
+
+    // ct (mr x nr, row-major) = A sliver (kc x mr, k-major) x B sliver (kc x nr, k-major)
+    void (*compute)(int kc, const T* a, const T* b, Acc* ct);
+
+    // Register-only multiply-add loop; returns the operations performed
+    uint64_t (*peak)(uint64_t iterations);
+};
+
+/**
+ * GemmBlocking: Cache blocking parameters.
+ * Defaults for 4-byte elements: A~ = 144 x 256 x 4 B = 144 KiB (L2), one B~ sliver
+ * = 256 x 16 x 4 B = 16 KiB (L1), B~ = 256 x 3072 x 4 B = 3 MiB (L3).
+ * MC and NC are multiples of every kernel's MR and NR.
+ */
+struct GemmBlocking {
+    int mc = 144;
+    int kc = 256;
+    int nc = 3072;
+};
+
+/**
+ * Heap buffer aligned to a cache line. Uses the C++17 aligned operator new, which every
+ * toolchain provides (unlike std::aligned_alloc on MSVC / MinGW) and throws std::bad_alloc
+ * instead of returning null.
+ */
+constexpr std::align_val_t BUFFER_ALIGNMENT{64};
+
+struct AlignedFree {
+    void operator()(void* p) const { ::operator delete(p, BUFFER_ALIGNMENT); }
+};
+
+template <typename T>
+using AlignedBuffer = std::unique_ptr<T[], AlignedFree>;
+
+template <typename T>
+static inline AlignedBuffer<T> make_aligned_buffer(size_t count) {
+    size_t bytes = (count * sizeof(T) + 63) / 64 * 64;
+    return AlignedBuffer<T>(static_cast<T*>(::operator new(std::max<size_t>(bytes, 64), BUFFER_ALIGNMENT)));
+}
+
+/////////////////////
+///    KERNELS    ///
+/////////////////////
+/**
+ * Portable 4 x 4 kernel for any element / accumulator pair.
+ */
+template <typename T, typename Acc>
+static void gemm_kernel_scalar(int kc, const T* a, const T* b, Acc* ct) {
+    Acc c[4][4] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int r = 0; r < 4; ++r) {
+            for (int j = 0; j < 4; ++j) c[r][j] += static_cast<Acc>(a[r]) * static_cast<Acc>(b[j]);
+        }
+        a += 4;
+        b += 4;
+    }
+    for (int r = 0; r < 4; ++r) {
+        for (int j = 0; j < 4; ++j) ct[r * 4 + j] = c[r][j];
+    }
+}
+
+template <typename T, typename Acc>
+static uint64_t gemm_peak_scalar(uint64_t iterations) {
+    Acc acc[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    T x = 0;
+    for (uint64_t it = 0; it < iterations; ++it) {
+#if defined(__GNUC__)
+        __asm__ volatile("" : "+g"(x));
+#endif
+        for (Acc& v : acc) v += v * static_cast<Acc>(x);
+    }
+    volatile Acc sink = acc[0] + acc[7];
+    (void)sink;
+    return iterations * 8 * 2;
+}
+
+#if PACKED_GEMM_X86
+/**
+ * Defines gemm_kernel_<ISA><Ops, MR> and gemm_peak_<ISA><Ops, MR>, compiled for TARGET.
+ * Ops provides T, Acc, Vec, LANES (Acc values per vector), type (label for kernel names)
+ * and the inlined operations zero(), load_b(const T*), broadcast(T),
+ * madd(c, a, b) = c + a * b, store(Acc*, Vec).
+ * The tile is MR x (2 * LANES): two B vectors per k, one broadcast of A per row.
+ * REG is the inline-asm register class of Vec, used to keep the peak loop opaque; each
+ * peak accumulator multiplies itself (c += c * x), so no product can be shared.
+ */
+#define GEMM_DEFINE_SIMD_KERNELS(ISA, TARGET, REG)                                                \
+    template <typename Ops, int MR>                                                               \
+    __attribute__((target(TARGET)))                                                               \
+    static void gemm_kernel_##ISA(int kc, const typename Ops::T* a, const typename Ops::T* b,     \
+                                  typename Ops::Acc* ct) {                                        \
+        constexpr int L = Ops::LANES;                                                             \
+        typename Ops::Vec c[MR][2];                                                               \
+        for (int r = 0; r < MR; ++r) c[r][0] = c[r][1] = Ops::zero();                             \
+                                                                                                  \
+        for (int p = 0; p < kc; ++p) {                                                            \
+            typename Ops::Vec b0 = Ops::load_b(b);                                                \
+            typename Ops::Vec b1 = Ops::load_b(b + L);                                            \
+            _Pragma("GCC unroll 32")                                                              \
+            for (int r = 0; r < MR; ++r) {                                                        \
+                typename Ops::Vec ar = Ops::broadcast(a[r]);                                      \
+                c[r][0] = Ops::madd(c[r][0], ar, b0);                                             \
+                c[r][1] = Ops::madd(c[r][1], ar, b1);                                             \
+            }                                                                                     \
+            a += MR;                                                                              \
+            b += 2 * L;                                                                           \
+        }                                                                                         \
+                                                                                                  \
+        for (int r = 0; r < MR; ++r) {                                                            \
+            Ops::store(ct + r * 2 * L, c[r][0]);                                                  \
+            Ops::store(ct + r * 2 * L + L, c[r][1]);                                              \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    template <typename Ops, int MR>                                                               \
+    __attribute__((target(TARGET)))                                                               \
+    static uint64_t gemm_peak_##ISA(uint64_t iterations) {                                        \
+        typename Ops::Vec c[2 * MR];                                                              \
+        for (auto& v : c) v = Ops::broadcast(1);                                                  \
+        typename Ops::Vec x = Ops::zero();                                                        \
+        for (uint64_t it = 0; it < iterations; ++it) {                                            \
+            __asm__ volatile("" : "+" REG(x));                                                    \
+            _Pragma("GCC unroll 32")                                                              \
+            for (int j = 0; j < 2 * MR; ++j) c[j] = Ops::madd(c[j], c[j], x);                     \
+        }                                                                                         \
+        typename Ops::Acc out[Ops::LANES];                                                        \
+        typename Ops::Acc total = 0;                                                              \
+        for (auto& v : c) {                                                                       \
+            Ops::store(out, v);                                                                   \
+            total += out[0];                                                                      \
+        }                                                                                         \
+        volatile typename Ops::Acc sink = total;                                                  \
+        (void)sink;                                                                               \
+        return iterations * 2 * MR * Ops::LANES * 2;                                              \
+    }
+
+#define GEMM_AVX2_TARGET "avx2,fma"
+#define GEMM_AVX512_TARGET "avx512f,avx512dq"
+#define GEMM_AVX2_OP __attribute__((target(GEMM_AVX2_TARGET), always_inline)) static inline
+#define GEMM_AVX512_OP __attribute__((target(GEMM_AVX512_TARGET), always_inline)) static inline
+
+/**
+ * Avx2Ops / Avx512Ops: per-type operations for the SIMD kernels
+ * (available = false: no kernel for this pair on that instruction set).
+ */
+template <typename T_, typename Acc_>
+struct Avx2Ops {
+    static constexpr bool available = false;
+};
+
+template <typename T_, typename Acc_>
+struct Avx512Ops {
+    static constexpr bool available = false;
+};
+
+template <>
+struct Avx2Ops<int32_t, int32_t> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "int32";
+    using T = int32_t;
+    using Acc = int32_t;
+    using Vec = __m256i;
+    static constexpr int LANES = 8;
+    GEMM_AVX2_OP Vec zero() { return _mm256_setzero_si256(); }
+    GEMM_AVX2_OP Vec load_b(const T* b) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)); }
+    GEMM_AVX2_OP Vec broadcast(T a) { return _mm256_set1_epi32(a); }
+    GEMM_AVX2_OP Vec madd(Vec c, Vec a, Vec b) { return _mm256_add_epi32(c, _mm256_mullo_epi32(a, b)); }
+    GEMM_AVX2_OP void store(Acc* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+};
+
+template <>
+struct Avx2Ops<int32_t, int64_t> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "int32 -> int64";
+    using T = int32_t;
+    using Acc = int64_t;
+    using Vec = __m256i;
+    static constexpr int LANES = 4;
+    GEMM_AVX2_OP Vec zero() { return _mm256_setzero_si256(); }
+    GEMM_AVX2_OP Vec load_b(const T* b) { return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b))); }
+    GEMM_AVX2_OP Vec broadcast(T a) { return _mm256_set1_epi64x(a); }
+    GEMM_AVX2_OP Vec madd(Vec c, Vec a, Vec b) { return _mm256_add_epi64(c, _mm256_mul_epi32(a, b)); }
+    GEMM_AVX2_OP void store(Acc* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+};
+
+template <>
+struct Avx2Ops<float, float> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "float";
+    using T = float;
+    using Acc = float;
+    using Vec = __m256;
+    static constexpr int LANES = 8;
+    GEMM_AVX2_OP Vec zero() { return _mm256_setzero_ps(); }
+    GEMM_AVX2_OP Vec load_b(const T* b) { return _mm256_loadu_ps(b); }
+    GEMM_AVX2_OP Vec broadcast(T a) { return _mm256_set1_ps(a); }
+    GEMM_AVX2_OP Vec madd(Vec c, Vec a, Vec b) { return _mm256_fmadd_ps(a, b, c); }
+    GEMM_AVX2_OP void store(Acc* p, Vec v) { _mm256_storeu_ps(p, v); }
+};
+
+template <>
+struct Avx2Ops<double, double> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "double";
+    using T = double;
+    using Acc = double;
+    using Vec = __m256d;
+    static constexpr int LANES = 4;
+    GEMM_AVX2_OP Vec zero() { return _mm256_setzero_pd(); }
+    GEMM_AVX2_OP Vec load_b(const T* b) { return _mm256_loadu_pd(b); }
+    GEMM_AVX2_OP Vec broadcast(T a) { return _mm256_set1_pd(a); }
+    GEMM_AVX2_OP Vec madd(Vec c, Vec a, Vec b) { return _mm256_fmadd_pd(a, b, c); }
+    GEMM_AVX2_OP void store(Acc* p, Vec v) { _mm256_storeu_pd(p, v); }
+};
+
+template <>
+struct Avx512Ops<int32_t, int32_t> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "int32";
+    using T = int32_t;
+    using Acc = int32_t;
+    using Vec = __m512i;
+    static constexpr int LANES = 16;
+    GEMM_AVX512_OP Vec zero() { return _mm512_setzero_si512(); }
+    GEMM_AVX512_OP Vec load_b(const T* b) { return _mm512_loadu_si512(b); }
+    GEMM_AVX512_OP Vec broadcast(T a) { return _mm512_set1_epi32(a); }
+    GEMM_AVX512_OP Vec madd(Vec c, Vec a, Vec b) { return _mm512_add_epi32(c, _mm512_mullo_epi32(a, b)); }
+    GEMM_AVX512_OP void store(Acc* p, Vec v) { _mm512_storeu_si512(p, v); }
+};
+
+template <>
+struct Avx512Ops<int32_t, int64_t> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "int32 -> int64";
+    using T = int32_t;
+    using Acc = int64_t;
+    using Vec = __m512i;
+    static constexpr int LANES = 8;
+    GEMM_AVX512_OP Vec zero() { return _mm512_setzero_si512(); }
+    GEMM_AVX512_OP Vec load_b(const T* b) { return _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b))); }
+    GEMM_AVX512_OP Vec broadcast(T a) { return _mm512_set1_epi64(a); }
+    GEMM_AVX512_OP Vec madd(Vec c, Vec a, Vec b) { return _mm512_add_epi64(c, _mm512_mul_epi32(a, b)); }
+    GEMM_AVX512_OP void store(Acc* p, Vec v) { _mm512_storeu_si512(p, v); }
+};
+
+template <>
+struct Avx512Ops<int64_t, int64_t> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "int64";
+    using T = int64_t;
+    using Acc = int64_t;
+    using Vec = __m512i;
+    static constexpr int LANES = 8;
+    GEMM_AVX512_OP Vec zero() { return _mm512_setzero_si512(); }
+    GEMM_AVX512_OP Vec load_b(const T* b) { return _mm512_loadu_si512(b); }
+    GEMM_AVX512_OP Vec broadcast(T a) { return _mm512_set1_epi64(a); }
+    GEMM_AVX512_OP Vec madd(Vec c, Vec a, Vec b) { return _mm512_add_epi64(c, _mm512_mullo_epi64(a, b)); }
+    GEMM_AVX512_OP void store(Acc* p, Vec v) { _mm512_storeu_si512(p, v); }
+};
+
+template <>
+struct Avx512Ops<float, float> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "float";
+    using T = float;
+    using Acc = float;
+    using Vec = __m512;
+    static constexpr int LANES = 16;
+    GEMM_AVX512_OP Vec zero() { return _mm512_setzero_ps(); }
+    GEMM_AVX512_OP Vec load_b(const T* b) { return _mm512_loadu_ps(b); }
+    GEMM_AVX512_OP Vec broadcast(T a) { return _mm512_set1_ps(a); }
+    GEMM_AVX512_OP Vec madd(Vec c, Vec a, Vec b) { return _mm512_fmadd_ps(a, b, c); }
+    GEMM_AVX512_OP void store(Acc* p, Vec v) { _mm512_storeu_ps(p, v); }
+};
+
+template <>
+struct Avx512Ops<double, double> {
+    static constexpr bool available = true;
+    static constexpr const char* type = "double";
+    using T = double;
+    using Acc = double;
+    using Vec = __m512d;
+    static constexpr int LANES = 8;
+    GEMM_AVX512_OP Vec zero() { return _mm512_setzero_pd(); }
+    GEMM_AVX512_OP Vec load_b(const T* b) { return _mm512_loadu_pd(b); }
+    GEMM_AVX512_OP Vec broadcast(T a) { return _mm512_set1_pd(a); }
+    GEMM_AVX512_OP Vec madd(Vec c, Vec a, Vec b) { return _mm512_fmadd_pd(a, b, c); }
+    GEMM_AVX512_OP void store(Acc* p, Vec v) { _mm512_storeu_pd(p, v); }
+};
+
+GEMM_DEFINE_SIMD_KERNELS(avx2, GEMM_AVX2_TARGET, "x")
+
+// GCC 12 reports the undefined pass-through operand of vpmuldq / vpmovsxdq as
+// "may be used uninitialized" once the intrinsics are inlined; it is never read
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+GEMM_DEFINE_SIMD_KERNELS(avx512, GEMM_AVX512_TARGET, "v")
+#pragma GCC diagnostic pop
+#endif
+
+#if PACKED_GEMM_X86
+/**
+ * GemmKernel for the SIMD kernel template of one instruction set (AVX512 = true:
+ * AVX-512, else AVX2 + FMA) with MR rows; named "<ISA> <MR>x<NR> (<type>)".
+ */
+template <typename Ops, int MR, bool AVX512>
+static GemmKernel<typename Ops::T, typename Ops::Acc> gemm_simd_kernel() {
+    static const std::string name = std::string(AVX512 ? "AVX-512 " : "AVX2 ") + std::to_string(MR) + "x" +
+                                    std::to_string(2 * Ops::LANES) + " (" + Ops::type + ")";
+    if constexpr (AVX512) {
+        return {name.c_str(), MR, 2 * Ops::LANES, gemm_kernel_avx512<Ops, MR>, gemm_peak_avx512<Ops, MR>};
+    } else {
+        return {name.c_str(), MR, 2 * Ops::LANES, gemm_kernel_avx2<Ops, MR>, gemm_peak_avx2<Ops, MR>};
+    }
+}
+
+static inline bool gemm_cpu_has_avx512() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+}
+
+static inline bool gemm_cpu_has_avx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+/**
+ * Micro-kernel for this CPU and type pair: AVX-512 if available, else AVX2 + FMA,
+ * else scalar. Detected once per type pair, on first use.
+ */
+template <typename T, typename Acc>
+static const GemmKernel<T, Acc>& select_gemm_kernel() {
+    static const GemmKernel<T, Acc> kernel = []() -> GemmKernel<T, Acc> {
+#if PACKED_GEMM_X86
+        if constexpr (Avx512Ops<T, Acc>::available) {
+            if (gemm_cpu_has_avx512()) return gemm_simd_kernel<Avx512Ops<T, Acc>, 12, true>();
+        }
+        if constexpr (Avx2Ops<T, Acc>::available) {
+            if (gemm_cpu_has_avx2()) return gemm_simd_kernel<Avx2Ops<T, Acc>, 6, false>();
+        }
+#endif
+        return {"scalar 4x4", 4, 4, gemm_kernel_scalar<T, Acc>, gemm_peak_scalar<T, Acc>};
+    }();
+    return kernel;
+}
+
+/**
+ * Every micro-kernel shape this CPU runs for the type pair (the auto-tuner's kernel
+ * candidates), select_gemm_kernel()'s choice first:
+ * - AVX-512, MR = 4, 8, 12, 14 (14 x 2 accumulators + 2 B vectors + 1 broadcast
+ *   use 31 of the 32 vector registers)
+ * - AVX2 + FMA, MR = 4, 6 (6 x 2 + 3 of 16 registers)
+ * - scalar 4 x 4
+ */
+template <typename T, typename Acc>
+static const std::vector<GemmKernel<T, Acc>>& gemm_kernel_candidates() {
+    static const std::vector<GemmKernel<T, Acc>> kernels = [] {
+        std::vector<GemmKernel<T, Acc>> list = {select_gemm_kernel<T, Acc>()};
+        auto add = [&](const GemmKernel<T, Acc>& kern) {
+            for (const auto& known : list) {
+                if (std::strcmp(known.name, kern.name) == 0) return;
+            }
+            list.push_back(kern);
+        };
+#if PACKED_GEMM_X86
+        if constexpr (Avx512Ops<T, Acc>::available) {
+            using Ops = Avx512Ops<T, Acc>;
+            if (gemm_cpu_has_avx512()) {
+                add(gemm_simd_kernel<Ops, 4, true>());
+                add(gemm_simd_kernel<Ops, 8, true>());
+                add(gemm_simd_kernel<Ops, 12, true>());
+                add(gemm_simd_kernel<Ops, 14, true>());
+            }
+        }
+        if constexpr (Avx2Ops<T, Acc>::available) {
+            using Ops = Avx2Ops<T, Acc>;
+            if (gemm_cpu_has_avx2()) {
+                add(gemm_simd_kernel<Ops, 4, false>());
+                add(gemm_simd_kernel<Ops, 6, false>());
+            }
+        }
+#endif
+        add({"scalar 4x4", 4, 4, gemm_kernel_scalar<T, Acc>, gemm_peak_scalar<T, Acc>});
+        return list;
+    }();
+    return kernels;
+}
+
+/////////////////////
+///    PACKING    ///
+/////////////////////
+/**
+ * Packs the mc x kc block of A at `a` (row stride lda) into MR-row slivers, each stored
+ * k-major (kc groups of mr values); rows past mc are zero.
+ */
+template <typename T>
+static void pack_a(const T* a, int lda, int mc, int kc, int mr, T* out) {
+    for (int i = 0; i < mc; i += mr) {
+        int rows = std::min(mr, mc - i);
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < rows; ++r) *out++ = a[(i + r) * lda + p];
+            for (int r = rows; r < mr; ++r) *out++ = T(0);
+        }
+    }
+}
+
+/**
+ * Packs the kc x nc block of B at `b` (row stride ldb) into NR-column slivers, each
+ * stored k-major (kc groups of nr values); columns past nc are zero.
+ */
+template <typename T>
+static void pack_b(const T* b, int ldb, int kc, int nc, int nr, T* out) {
+    for (int j = 0; j < nc; j += nr) {
+        int cols = std::min(nr, nc - j);
+        for (int p = 0; p < kc; ++p) {
+            const T* row = b + p * ldb + j;
+            for (int c = 0; c < cols; ++c) *out++ = row[c];
+            for (int c = cols; c < nr; ++c) *out++ = T(0);
+        }
+    }
+}
+
+/////////////////////
+///    DRIVER     ///
+/////////////////////
+/**
+ * Macro-kernel: C block (mc x nc at c, row stride ldc) (+)= packed A~ x packed B~.
+ * Runs the micro-kernel on every MR x NR tile and writes back its valid part
+ * (assigned on the first KC block, accumulated on later ones).
+ */
+template <typename T, typename Acc>
+static inline void packed_macro_kernel(const GemmKernel<T, Acc>& kern, int mc, int nc, int kc,
+                                       const T* a_pack, const T* b_pack, Acc* c, int ldc,
+                                       bool accumulate, Acc* tile) {
+    const int mr = kern.mr;
+    const int nr = kern.nr;
+
+    for (int jr = 0; jr < nc; jr += nr) {
+        const int cols = std::min(nr, nc - jr);
+        const T* b_sliver = b_pack + jr * kc;
+
+        for (int ir = 0; ir < mc; ir += mr) {
+            const int rows = std::min(mr, mc - ir);
+            kern.compute(kc, a_pack + ir * kc, b_sliver, tile);
+
+            // Write back the valid part of the register tile
+            for (int r = 0; r < rows; ++r) {
+                Acc* dst = c + (ir + r) * ldc + jr;
+                const Acc* src = tile + r * nr;
+                if (accumulate) {
+                    for (int j = 0; j < cols; ++j) dst[j] += src[j];
+                } else {
+                    for (int j = 0; j < cols; ++j) dst[j] = src[j];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * C = A x B for row-major A (m x k, row stride lda), B (k x n, ldb), C (m x n, ldc).
+ * Single-threaded; callers parallelise over disjoint row ranges of A and C.
+ */
+template <typename T, typename Acc>
+static void packed_gemm(const GemmKernel<T, Acc>& kern, const GemmBlocking& blk,
+                        int m, int n, int k,
+                        const T* a, int lda, const T* b, int ldb, Acc* c, int ldc) {
+    if (k == 0) {
+        for (int i = 0; i < m; ++i) std::fill(c + i * ldc, c + i * ldc + n, Acc(0));
+        return;
+    }
+
+    const int mr = kern.mr;
+    const int nr = kern.nr;
+    // pack_a / pack_b pad the last sliver to MR / NR, so round after clamping: MC / NC
+    // need not be multiples of MR / NR
+    const int mc_max = (std::min(blk.mc, m) + mr - 1) / mr * mr;
+    const int nc_max = (std::min(blk.nc, n) + nr - 1) / nr * nr;
+    const int kc_max = std::min(blk.kc, k);
+
+    AlignedBuffer<T> a_pack = make_aligned_buffer<T>(static_cast<size_t>(mc_max) * kc_max);
+    AlignedBuffer<T> b_pack = make_aligned_buffer<T>(static_cast<size_t>(nc_max) * kc_max);
+    std::vector<Acc> tile(static_cast<size_t>(mr) * nr);
+
+    for (int jc = 0; jc < n; jc += blk.nc) {
+        const int nc = std::min(blk.nc, n - jc);
+
+        for (int pc = 0; pc < k; pc += blk.kc) {
+            const int kc = std::min(blk.kc, k - pc);
+            const bool accumulate = pc > 0;
+            pack_b(b + pc * ldb + jc, ldb, kc, nc, nr, b_pack.get());
+
+            for (int ic = 0; ic < m; ic += blk.mc) {
+                const int mc = std::min(blk.mc, m - ic);
+                pack_a(a + ic * lda + pc, lda, mc, kc, mr, a_pack.get());
+                packed_macro_kernel(kern, mc, nc, kc, a_pack.get(), b_pack.get(),
+                                    c + ic * ldc + jc, ldc, accumulate, tile.data());
+            }
+        }
+    }
+}
+
+/////////////////////
+///  TASK DRIVER  ///
+/////////////////////
+// Bytes of A row panels the tile order tries to keep in the last-level cache
+constexpr size_t GEMM_L3_PANEL_BYTES = size_t(8) << 20;
+
+/**
+ * GemmTileGrid: C split into tile_m x tile_n tiles, numbered in an L3-friendly order.
+ *
+ * Tiles are taken in groups of `group` tile rows; inside a group the order is
+ * column-major. Tasks that run at the same time are neighbours in this order, so they
+ * share one B column panel, and the group's A row panels (sized to fit
+ * GEMM_L3_PANEL_BYTES) are reused from L3 as the group moves to the next column.
+ */
+struct GemmTileGrid {
+    int tile_m;
+    int tile_n;
+    int tiles_m;
+    int tiles_n;
+    int group;
+
+    int count() const { return tiles_m * tiles_n; }
+
+    /** Tile coordinates (row, column) of task t. */
+    void locate(int t, int& ti, int& tj) const {
+        const int per_group = group * tiles_n;
+        const int g = t / per_group;
+        const int within = t % per_group;
+        const int rows = std::min(group, tiles_m - g * group);
+        ti = g * group + within % rows;
+        tj = within / rows;
+    }
+};
+
+/**
+ * Tile grid for an m x n x k product on `workers` workers. Starts from MC x NC and
+ * halves the larger tile side (kept a multiple of MR / NR) until there are at least
+ * four tiles per worker, so small and skinny products still spread over the pool.
+ */
+static inline GemmTileGrid make_tile_grid(const GemmBlocking& blk, int mr, int nr,
+                                          int m, int n, int k, int workers, size_t elem_bytes) {
+    auto round_up = [](int x, int to) { return (x + to - 1) / to * to; };
+    int tile_m = std::min(blk.mc, round_up(std::max(m, 1), mr));
+    int tile_n = std::min(blk.nc, round_up(std::max(n, 1), nr));
+    auto tiles = [&] { return ((m + tile_m - 1) / tile_m) * ((n + tile_n - 1) / tile_n); };
+
+    while (tiles() < 4 * workers) {
+        if (tile_n >= tile_m && tile_n > nr) tile_n = round_up(tile_n / 2, nr);
+        else if (tile_m > mr) tile_m = round_up(tile_m / 2, mr);
+        else if (tile_n > nr) tile_n = round_up(tile_n / 2, nr);
+        else break;
+    }
+
+    GemmTileGrid grid{tile_m, tile_n, (m + tile_m - 1) / tile_m, (n + tile_n - 1) / tile_n, 1};
+    size_t panel_bytes = static_cast<size_t>(tile_m) * std::max(k, 1) * elem_bytes;
+    grid.group = static_cast<int>(std::clamp<size_t>(GEMM_L3_PANEL_BYTES / panel_bytes, 1,
+                                                     static_cast<size_t>(std::max(grid.tiles_m, 1))));
+    return grid;
+}
+
+/**
+ * Per-thread packing buffers, kept between calls (pool workers are persistent, so
+ * repeated products reuse them without allocating).
+ */
+template <typename T, typename Acc>
+struct GemmWorkspace {
+    AlignedBuffer<T> a_pack;
+    AlignedBuffer<T> b_pack;
+    size_t a_capacity = 0;
+    size_t b_capacity = 0;
+    std::vector<Acc> tile;
+
+    void reserve(size_t a_elems, size_t b_elems, size_t tile_elems) {
+        if (a_elems > a_capacity) {
+            a_pack = make_aligned_buffer<T>(a_elems);
+            a_capacity = a_elems;
+        }
+        if (b_elems > b_capacity) {
+            b_pack = make_aligned_buffer<T>(b_elems);
+            b_capacity = b_elems;
+        }
+        if (tile.size() < tile_elems) tile.resize(tile_elems);
+    }
+};
+
+/**
+ * C = A x B (same arguments as packed_gemm) with the tiles of C as tasks on `pool`.
+ * Each task owns one C tile, loops over K in KC blocks and packs its own A and B
+ * blocks, so tasks are independent and any worker may take any tile.
+ * With accumulate = true it computes C += A x B instead.
+ */
+template <typename T, typename Acc>
+static void tiled_gemm(ThreadPool& pool, const GemmKernel<T, Acc>& kern, const GemmBlocking& blk,
+                       int m, int n, int k,
+                       const T* a, int lda, const T* b, int ldb, Acc* c, int ldc, bool accumulate = false) {
+    if (m <= 0 || n <= 0) return;
+    if (k == 0 && accumulate) return;
+    if (k == 0) {
+        for (int i = 0; i < m; ++i) std::fill(c + i * ldc, c + i * ldc + n, Acc(0));
+        return;
+    }
+
+    const GemmTileGrid grid = make_tile_grid(blk, kern.mr, kern.nr, m, n, k, pool.size(), sizeof(T));
+    const int kc_max = std::min(blk.kc, k);
+
+    pool.parallel_for(grid.count(), [&](int task, int) {
+        static thread_local GemmWorkspace<T, Acc> ws;
+        ws.reserve(static_cast<size_t>(grid.tile_m + kern.mr) * kc_max,
+                   static_cast<size_t>(grid.tile_n + kern.nr) * kc_max,
+                   static_cast<size_t>(kern.mr) * kern.nr);
+
+        int ti, tj;
+        grid.locate(task, ti, tj);
+        const int ic = ti * grid.tile_m;
+        const int jc = tj * grid.tile_n;
+        const int mc = std::min(grid.tile_m, m - ic);
+        const int nc = std::min(grid.tile_n, n - jc);
+
+        for (int pc = 0; pc < k; pc += blk.kc) {
+            const int kc = std::min(blk.kc, k - pc);
+            pack_b(b + pc * ldb + jc, ldb, kc, nc, kern.nr, ws.b_pack.get());
+            pack_a(a + ic * lda + pc, lda, mc, kc, kern.mr, ws.a_pack.get());
+            packed_macro_kernel(kern, mc, nc, kc, ws.a_pack.get(), ws.b_pack.get(),
+                                c + ic * ldc + jc, ldc, accumulate || pc > 0, ws.tile.data());
+        }
+    });
+}
+
+/**
+ * C = A x B (same arguments as packed_gemm) on a static grid_rows x grid_cols grid of
+ * C blocks, one packed_gemm per block as a task on `pool`. Block edges are multiples of
+ * MR / NR. With grid_rows x grid_cols = pool.size() every worker gets one large block,
+ * which packs each A and B panel fewer times than tiled_gemm's small dynamic tiles but
+ * cannot rebalance; the auto-tuner picks whichever is faster for a shape.
+ */
+template <typename T, typename Acc>
+static void grid_gemm(ThreadPool& pool, const GemmKernel<T, Acc>& kern, const GemmBlocking& blk,
+                      int grid_rows, int grid_cols, int m, int n, int k,
+                      const T* a, int lda, const T* b, int ldb, Acc* c, int ldc) {
+    if (m <= 0 || n <= 0) return;
+
+    // Start of part `part` of `parts` over `extent`, in units of `align`
+    auto cut = [](int extent, int parts, int part, int align) {
+        const int64_t units = (extent + align - 1) / align;
+        return std::min(extent, static_cast<int>(units * part / parts) * align);
+    };
+
+    pool.parallel_for(grid_rows * grid_cols, [&](int task, int) {
+        const int gi = task / grid_cols;
+        const int gj = task % grid_cols;
+        const int i0 = cut(m, grid_rows, gi, kern.mr);
+        const int i1 = cut(m, grid_rows, gi + 1, kern.mr);
+        const int j0 = cut(n, grid_cols, gj, kern.nr);
+        const int j1 = cut(n, grid_cols, gj + 1, kern.nr);
+        if (i0 >= i1 || j0 >= j1) return;
+
+        packed_gemm(kern, blk, i1 - i0, j1 - j0, k, a + i0 * lda, lda, b + j0, ldb, c + i0 * ldc + j0, ldc);
+    });
+}
+
+/**
+ * Peak throughput (GOP/s, or GFLOP/s for floating point) of the kernel's multiply-add
+ * on `threads` threads running the register-only loop at the same time.
+ */
+template <typename T, typename Acc>
+static double measure_peak_gops(const GemmKernel<T, Acc>& kern, int threads) {
+    const uint64_t iterations = 1 << 22;
+    std::vector<uint64_t> ops(threads, 0);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] { ops[t] = kern.peak(iterations); });
+    }
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    uint64_t total = 0;
+    for (uint64_t o : ops) total += o;
+    std::chrono::duration<double, std::nano> duration = end - start;
+    return total / duration.count();
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Compressed sparse matrices (CSR / CSC) and parallel sparse x dense products.
+ *
+ *   CSR: row_ptr[rows + 1], col_idx[nnz], values[nnz]   (row r = [row_ptr[r], row_ptr[r+1]))
+ *   CSC: col_ptr[cols + 1], row_idx[nnz], values[nnz]   (the CSR arrays of the transpose)
+ *
+ * Kernels (y, C dense; x, B dense, row-major):
+ * - csr_spmv:  y = A x            csr_spmm:  C = A B
+ * - csc_spmv:  y = A^T x          csc_spmm:  C = A^T B
+ * CSC stores A^T in CSR form, so the same gather kernels compute the transposed
+ * products without materialising A^T.
+ *
+ * Work split (merge path, Merrill & Garland): the kernels walk the merge of the row end
+ * offsets row_ptr[1..rows] with the nonzero indices 0..nnz-1, a path of rows + nnz
+ * steps. Each task takes an equal share of the path, found by a binary search on its
+ * diagonal, so every task gets the same rows + nonzeros whatever the row lengths
+ * (one row with half the nonzeros is split across several tasks). A task writes every
+ * row it finishes and leaves the partial sum of the row it stops in as a carry; the
+ * carries are added after the parallel part. SparseSplit::rows (equal row counts, no
+ * carries) is kept for comparison.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Tasks per pool worker (more tasks than workers lets the pool absorb slow workers)
+constexpr int SPARSE_TASKS_PER_WORKER = 4;
+
+// Dense columns an SpMM row accumulates at once (64 int32 / float = 4 AVX-512 registers)
+constexpr int SPARSE_COL_BLOCK = 64;
+
+/////////////////////
+///    FORMATS    ///
+/////////////////////
+/**
+ * CsrMatrix: rows x cols matrix in compressed sparse row form.
+ */
+template <typename T>
+struct CsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int64_t> row_ptr;  // rows + 1 offsets into col_idx / values
+    std::vector<int32_t> col_idx;
+    std::vector<T> values;
+
+    int64_t nnz() const { return static_cast<int64_t>(values.size()); }
+
+    /** Bytes of the three arrays (the whole matrix as the kernels read it). */
+    size_t bytes() const {
+        return row_ptr.size() * sizeof(int64_t) + col_idx.size() * sizeof(int32_t) + values.size() * sizeof(T);
+    }
+};
+
+/**
+ * CscMatrix: rows x cols matrix in compressed sparse column form.
+ */
+template <typename T>
+struct CscMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int64_t> col_ptr;  // cols + 1 offsets into row_idx / values
+    std::vector<int32_t> row_idx;
+    std::vector<T> values;
+
+    int64_t nnz() const { return static_cast<int64_t>(values.size()); }
+
+    size_t bytes() const {
+        return col_ptr.size() * sizeof(int64_t) + row_idx.size() * sizeof(int32_t) + values.size() * sizeof(T);
+    }
+};
+
+/////////////////////
+///  CONVERSION   ///
+/////////////////////
+/**
+ * CSR copy of a dense row-major matrix (rows x cols, row stride ld); zeros are dropped.
+ * Two parallel passes over row bands: count the nonzeros per row, then (after a prefix
+ * sum) copy them to their final offsets.
+ */
+template <typename T>
+static CsrMatrix<T> csr_from_dense(ThreadPool& pool, const T* a, int rows, int cols, int ld) {
+    CsrMatrix<T> csr;
+    csr.rows = rows;
+    csr.cols = cols;
+    csr.row_ptr.assign(static_cast<size_t>(rows) + 1, 0);
+
+    const int tasks = std::min(rows, pool.size() * SPARSE_TASKS_PER_WORKER);
+    auto band = [&](int task) { return static_cast<int>(static_cast<int64_t>(rows) * task / tasks); };
+
+    pool.parallel_for(tasks, [&](int task, int) {
+        for (int r = band(task); r < band(task + 1); ++r) {
+            const T* row = a + static_cast<size_t>(r) * ld;
+            csr.row_ptr[r + 1] = cols - std::count(row, row + cols, T(0));
+        }
+    });
+    for (int r = 0; r < rows; ++r) csr.row_ptr[r + 1] += csr.row_ptr[r];
+
+    csr.col_idx.resize(csr.row_ptr[rows]);
+    csr.values.resize(csr.row_ptr[rows]);
+    pool.parallel_for(tasks, [&](int task, int) {
+        for (int r = band(task); r < band(task + 1); ++r) {
+            const T* row = a + static_cast<size_t>(r) * ld;
+            int64_t out = csr.row_ptr[r];
+            for (int c = 0; c < cols; ++c) {
+                if (row[c] != T(0)) {
+                    csr.col_idx[out] = c;
+                    csr.values[out] = row[c];
+                    ++out;
+                }
+            }
+        }
+    });
+    return csr;
+}
+
+/**
+ * CSC copy of a CSR matrix (counting sort by column; row indices stay sorted).
+ */
+template <typename T>
+static CscMatrix<T> csc_from_csr(const CsrMatrix<T>& csr) {
+    CscMatrix<T> csc;
+    csc.rows = csr.rows;
+    csc.cols = csr.cols;
+    csc.col_ptr.assign(static_cast<size_t>(csr.cols) + 1, 0);
+    csc.row_idx.resize(csr.nnz());
+    csc.values.resize(csr.nnz());
+
+    for (int32_t c : csr.col_idx) ++csc.col_ptr[c + 1];
+    for (int c = 0; c < csr.cols; ++c) csc.col_ptr[c + 1] += csc.col_ptr[c];
+
+    std::vector<int64_t> next(csc.col_ptr.begin(), csc.col_ptr.end() - 1);
+    for (int r = 0; r < csr.rows; ++r) {
+        for (int64_t p = csr.row_ptr[r]; p < csr.row_ptr[r + 1]; ++p) {
+            const int64_t out = next[csr.col_idx[p]]++;
+            csc.row_idx[out] = r;
+            csc.values[out] = csr.values[p];
+        }
+    }
+    return csc;
+}
+
+/**
+ * CSC copy of a dense row-major matrix.
+ */
+template <typename T>
+static CscMatrix<T> csc_from_dense(ThreadPool& pool, const T* a, int rows, int cols, int ld) {
+    return csc_from_csr(csr_from_dense(pool, a, rows, cols, ld));
+}
+
+/**
+ * Dense row-major copy of a CSR matrix (out: rows x cols, row stride ld).
+ */
+template <typename T>
+static void csr_to_dense(const CsrMatrix<T>& csr, T* out, int ld) {
+    for (int r = 0; r < csr.rows; ++r) {
+        T* row = out + static_cast<size_t>(r) * ld;
+        std::fill(row, row + csr.cols, T(0));
+        for (int64_t p = csr.row_ptr[r]; p < csr.row_ptr[r + 1]; ++p) row[csr.col_idx[p]] = csr.values[p];
+    }
+}
+
+/////////////////////
+///   PARTITION   ///
+/////////////////////
+enum class SparseSplit {
+    rows,        // Equal row counts per task
+    merge_path,  // Equal rows + nonzeros per task
+};
+
+/**
+ * SparseCoord: A point on the merge path (next row to finish, next nonzero).
+ */
+struct SparseCoord {
+    int row;
+    int64_t nz;
+};
+
+/**
+ * Point where diagonal `diag` (row + nz = diag) crosses the merge path of the row end
+ * offsets ptr[1..rows] and the nonzero indices: the number of rows finished before
+ * nonzero index diag - row is consumed.
+ */
+static inline SparseCoord merge_path_search(const int64_t* ptr, int rows, int64_t nnz, int64_t diag) {
+    int64_t lo = std::max<int64_t>(diag - nnz, 0);
+    int64_t hi = std::min<int64_t>(diag, rows);
+    while (lo < hi) {
+        const int64_t mid = (lo + hi) / 2;
+        if (ptr[mid + 1] <= diag - mid - 1) lo = mid + 1;
+        else hi = mid;
+    }
+    return {static_cast<int>(lo), diag - lo};
+}
+
+/**
+ * tasks + 1 path coordinates; task t covers [bounds[t], bounds[t + 1]).
+ */
+static inline std::vector<SparseCoord> sparse_partition(const int64_t* ptr, int rows, int tasks, SparseSplit split) {
+    const int64_t nnz = ptr[rows];
+    std::vector<SparseCoord> bounds(static_cast<size_t>(tasks) + 1);
+    for (int t = 0; t <= tasks; ++t) {
+        if (split == SparseSplit::merge_path) {
+            bounds[t] = merge_path_search(ptr, rows, nnz, (rows + nnz) * t / tasks);
+        } else {
+            const int row = static_cast<int>(static_cast<int64_t>(rows) * t / tasks);
+            bounds[t] = {row, ptr[row]};
+        }
+    }
+    return bounds;
+}
+
+/**
+ * Largest task's share of the nonzeros over the mean share (1.0 = perfectly even).
+ */
+static inline double sparse_imbalance(const std::vector<SparseCoord>& bounds) {
+    const int tasks = static_cast<int>(bounds.size()) - 1;
+    const int64_t total = bounds.back().nz - bounds.front().nz;
+    if (tasks < 1 || total == 0) return 1.0;
+    int64_t largest = 0;
+    for (int t = 0; t < tasks; ++t) largest = std::max(largest, bounds[t + 1].nz - bounds[t].nz);
+    return static_cast<double>(largest) * tasks / total;
+}
+
+/////////////////////
+///    KERNELS    ///
+/////////////////////
+/**
+ * y[r] = sum over row r of values * x[idx] for the compressed rows described by
+ * ptr / idx / values (CSR of A: y = A x; CSC of A: y = A^T x).
+ */
+template <typename T, typename Acc>
+static void sparse_gather_mv(ThreadPool& pool, int rows, const int64_t* ptr, const int32_t* idx, const T* values,
+                             const T* x, Acc* y, SparseSplit split) {
+    if (rows <= 0) return;
+    const int tasks = std::min<int64_t>(pool.size() * SPARSE_TASKS_PER_WORKER, rows + ptr[rows]);
+    const std::vector<SparseCoord> bounds = sparse_partition(ptr, rows, tasks, split);
+    std::vector<Acc> carry(tasks, Acc(0));
+
+    pool.parallel_for(tasks, [&](int task, int) {
+        int r = bounds[task].row;
+        int64_t p = bounds[task].nz;
+        const SparseCoord end = bounds[task + 1];
+
+        // Rows this task finishes (the first may have been started by earlier tasks)
+        for (; r < end.row; ++r) {
+            Acc sum = 0;
+            for (; p < ptr[r + 1]; ++p) sum += static_cast<Acc>(values[p]) * static_cast<Acc>(x[idx[p]]);
+            y[r] = sum;
+        }
+
+        // Head of the row the next task finishes
+        Acc sum = 0;
+        for (; p < end.nz; ++p) sum += static_cast<Acc>(values[p]) * static_cast<Acc>(x[idx[p]]);
+        carry[task] = sum;
+    });
+
+    for (int t = 0; t < tasks; ++t) {
+        if (bounds[t + 1].row < rows) y[bounds[t + 1].row] += carry[t];
+    }
+}
+
+/**
+ * C row r = sum over row r of values * B row idx (n columns; B row stride ldb, C row
+ * stride ldc) for the compressed rows described by ptr / idx / values
+ * (CSR of A: C = A B; CSC of A: C = A^T B).
+ */
+template <typename T, typename Acc>
+static void sparse_gather_mm(ThreadPool& pool, int rows, const int64_t* ptr, const int32_t* idx, const T* values,
+                             int n, const T* b, int ldb, Acc* c, int ldc, SparseSplit split) {
+    if (rows <= 0 || n <= 0) return;
+    const int tasks = std::min<int64_t>(pool.size() * SPARSE_TASKS_PER_WORKER, rows + ptr[rows]);
+    const std::vector<SparseCoord> bounds = sparse_partition(ptr, rows, tasks, split);
+    std::vector<Acc> carry(static_cast<size_t>(tasks) * n, Acc(0));
+
+    // out[0..n) += sum of values[p] * B row idx[p] for p in [begin, end), one block of
+    // SPARSE_COL_BLOCK columns at a time so the partial sums stay in registers
+    auto accumulate = [&](int64_t begin, int64_t end, Acc* out) {
+        for (int j0 = 0; j0 < n; j0 += SPARSE_COL_BLOCK) {
+            Acc sum[SPARSE_COL_BLOCK] = {};
+            if (n - j0 >= SPARSE_COL_BLOCK) {
+                for (int64_t p = begin; p < end; ++p) {
+                    const Acc v = static_cast<Acc>(values[p]);
+                    const T* row = b + static_cast<size_t>(idx[p]) * ldb + j0;
+                    for (int j = 0; j < SPARSE_COL_BLOCK; ++j) sum[j] += v * static_cast<Acc>(row[j]);
+                }
+                for (int j = 0; j < SPARSE_COL_BLOCK; ++j) out[j0 + j] += sum[j];
+            } else {
+                const int width = n - j0;
+                for (int64_t p = begin; p < end; ++p) {
+                    const Acc v = static_cast<Acc>(values[p]);
+                    const T* row = b + static_cast<size_t>(idx[p]) * ldb + j0;
+                    for (int j = 0; j < width; ++j) sum[j] += v * static_cast<Acc>(row[j]);
+                }
+                for (int j = 0; j < width; ++j) out[j0 + j] += sum[j];
+            }
+        }
+    };
+
+    pool.parallel_for(tasks, [&](int task, int) {
+        int r = bounds[task].row;
+        int64_t p = bounds[task].nz;
+        const SparseCoord end = bounds[task + 1];
+
+        for (; r < end.row; ++r) {
+            Acc* out = c + static_cast<size_t>(r) * ldc;
+            std::fill(out, out + n, Acc(0));
+            accumulate(p, ptr[r + 1], out);
+            p = ptr[r + 1];
+        }
+        accumulate(p, end.nz, carry.data() + static_cast<size_t>(task) * n);
+    });
+
+    for (int t = 0; t < tasks; ++t) {
+        const int r = bounds[t + 1].row;
+        if (r >= rows || bounds[t + 1].nz == bounds[t].nz) continue;
+        Acc* out = c + static_cast<size_t>(r) * ldc;
+        const Acc* add = carry.data() + static_cast<size_t>(t) * n;
+        for (int j = 0; j < n; ++j) out[j] += add[j];
+    }
+}
+
+/** y (rows) = A x (cols). */
+template <typename T, typename Acc>
+static void csr_spmv(ThreadPool& pool, const CsrMatrix<T>& A, const T* x, Acc* y,
+                     SparseSplit split = SparseSplit::merge_path) {
+    sparse_gather_mv(pool, A.rows, A.row_ptr.data(), A.col_idx.data(), A.values.data(), x, y, split);
+}
+
+/** C (rows x n, stride ldc) = A B (cols x n, stride ldb). */
+template <typename T, typename Acc>
+static void csr_spmm(ThreadPool& pool, const CsrMatrix<T>& A, int n, const T* b, int ldb, Acc* c, int ldc,
+                     SparseSplit split = SparseSplit::merge_path) {
+    sparse_gather_mm(pool, A.rows, A.row_ptr.data(), A.col_idx.data(), A.values.data(), n, b, ldb, c, ldc, split);
+}
+
+/** y (cols) = A^T x (rows). */
+template <typename T, typename Acc>
+static void csc_spmv(ThreadPool& pool, const CscMatrix<T>& A, const T* x, Acc* y,
+                     SparseSplit split = SparseSplit::merge_path) {
+    sparse_gather_mv(pool, A.cols, A.col_ptr.data(), A.row_idx.data(), A.values.data(), x, y, split);
+}
+
+/** C (cols x n, stride ldc) = A^T B (rows x n, stride ldb). */
+template <typename T, typename Acc>
+static void csc_spmm(ThreadPool& pool, const CscMatrix<T>& A, int n, const T* b, int ldb, Acc* c, int ldc,
+                     SparseSplit split = SparseSplit::merge_path) {
+    sparse_gather_mm(pool, A.cols, A.col_ptr.data(), A.row_idx.data(), A.values.data(), n, b, ldb, c, ldc, split);
+}
+
+/////////////////////
+///   BANDWIDTH   ///
+/////////////////////
+/**
+ * Minimum bytes an SpMV moves: the matrix arrays once, x once and y once.
+ */
+template <typename T, typename Acc>
+static double spmv_bytes(int64_t nnz, int out_rows, int in_rows) {
+    return static_cast<double>(nnz) * (sizeof(T) + sizeof(int32_t)) + (out_rows + 1.0) * sizeof(int64_t) +
+           static_cast<double>(in_rows) * sizeof(T) + static_cast<double>(out_rows) * sizeof(Acc);
+}
+
+/**
+ * Minimum bytes an SpMM with n dense columns moves: the matrix arrays once, B once and C once.
+ */
+template <typename T, typename Acc>
+static double spmm_bytes(int64_t nnz, int out_rows, int in_rows, int n) {
+    return static_cast<double>(nnz) * (sizeof(T) + sizeof(int32_t)) + (out_rows + 1.0) * sizeof(int64_t) +
+           static_cast<double>(in_rows) * n * sizeof(T) + static_cast<double>(out_rows) * n * sizeof(Acc);
+}
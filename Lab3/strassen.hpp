@@ -0,0 +1,402 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Strassen-Winograd multiplication C = A x B of square n x n row-major matrices
+ * (element and accumulator type T; integer results are exact while the intermediate
+ * sums fit in T).
+ *
+ * Winograd's form of Strassen: 7 half-size products, 15 additions per level.
+ *
+ *   S1 = A21 + A22   S2 = S1 - A11   S3 = A11 - A21   S4 = A12 - S2
+ *   T1 = B12 - B11   T2 = B22 - T1   T3 = B22 - B12   T4 = T2 - B21
+ *
+ *   M1 = A11 B11   M2 = A12 B21   M3 = S4 B22   M4 = A22 T4
+ *   M5 = S1 T1     M6 = S2 T2     M7 = S3 T3
+ *
+ *   C11 = M1 + M2            C12 = M1 + M6 + M5 + M3
+ *   C21 = M1 + M6 + M7 - M4  C22 = M1 + M6 + M7 + M5
+ *
+ * M2..M5 are computed straight into the four quadrants of C, so a level needs
+ * 8 sums + 3 products = 11 quadrant-size temporaries.
+ *
+ * - Cutoff: sizes <= cutoff go to the packed GEMM engine (packed_gemm per sub-product;
+ *   tiled_gemm on the whole pool if n itself is below the cutoff).
+ * - Odd sizes (dynamic peeling): the even (n-1) core is multiplied recursively, then
+ *   the core gets the rank-1 update A[:, n-1] B[n-1, :] and the last row and column
+ *   of C are computed as dot products.
+ * - Parallelism: the top `depth` levels are expanded breadth-first into a tree of
+ *   7^depth independent sub-products. Sums and combinations of each level run as
+ *   row-band tasks, and the leaves run as one batch of tasks (each recursing
+ *   sequentially) on a ThreadPool.
+ * - Memory: every temporary comes from one StrassenArena, sized up front for (n, cutoff,
+ *   depth) by strassen_workspace and reused by later calls; no level allocates.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Rows of a quadrant handled by one sum / combination task
+constexpr int STRASSEN_BAND_ROWS = 64;
+
+// Arena allocations are rounded to a cache line of elements
+constexpr size_t STRASSEN_ALIGN_BYTES = 64;
+
+/////////////////////
+///     TYPES     ///
+/////////////////////
+/**
+ * StrassenConfig: Tuning knobs.
+ */
+struct StrassenConfig {
+    // Sub-products of this size or smaller use the packed GEMM engine
+    int cutoff = 256;
+
+    // Breadth-first (parallel) levels; -1 picks the smallest depth with
+    // 7^depth >= 2 x workers
+    int parallel_depth = -1;
+};
+
+/** Elements an arena request for `count` elements consumes (rounded to a cache line). */
+template <typename T>
+static inline size_t strassen_footprint(size_t count) {
+    const size_t per_line = std::max<size_t>(1, STRASSEN_ALIGN_BYTES / sizeof(T));
+    return (count + per_line - 1) / per_line * per_line;
+}
+
+/**
+ * StrassenBump: Bump allocator over a region of the arena (no frees; the region is
+ * reused by the next call).
+ */
+template <typename T>
+struct StrassenBump {
+    T* base;
+    size_t used = 0;
+
+    T* take(size_t count) {
+        T* p = base + used;
+        used += strassen_footprint<T>(count);
+        return p;
+    }
+};
+
+/**
+ * StrassenArena: The one aligned buffer all temporaries come from.
+ * reserve() grows it only when a call needs more than any previous one.
+ */
+template <typename T>
+class StrassenArena {
+public:
+    void reserve(size_t elements) {
+        if (elements > capacity_) {
+            buffer_ = make_aligned_buffer<T>(elements);
+            capacity_ = elements;
+        }
+    }
+
+    /** Allocator over the whole buffer. */
+    StrassenBump<T> bump() { return StrassenBump<T>{buffer_.get()}; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    AlignedBuffer<T> buffer_;
+    size_t capacity_ = 0;
+};
+
+/**
+ * StrassenNode: One (sub-)product C = A x B of size n, with its temporaries when split.
+ */
+template <typename T>
+struct StrassenNode {
+    int n;
+    const T* a;
+    int lda;
+    const T* b;
+    int ldb;
+    T* c;
+    int ldc;
+
+    // Split nodes: quadrant size of the even core, S1..S4, T1..T4 and M1, M6, M7
+    int h = 0;
+    T* s[4] = {};
+    T* t[4] = {};
+    T* m[3] = {};
+};
+
+/////////////////////
+///   WORKSPACE   ///
+/////////////////////
+/**
+ * Arena elements for a product of size n: 11 quadrant temporaries per split level,
+ * plus the 7 children's workspace when the level is parallel (depth > 0) or one
+ * child's when the recursion is sequential (children run one after another).
+ */
+template <typename T>
+static size_t strassen_workspace(int n, int cutoff, int depth) {
+    if (n <= cutoff || n < 2) return 0;
+    const int h = n / 2;
+    const size_t own = 11 * strassen_footprint<T>(static_cast<size_t>(h) * h);
+    const size_t child = strassen_workspace<T>(h, cutoff, depth > 0 ? depth - 1 : 0);
+    return own + (depth > 0 ? 7 * child : child);
+}
+
+/////////////////////
+///     LEVEL     ///
+/////////////////////
+/**
+ * Splits a node: takes its 11 temporaries from the arena.
+ */
+template <typename T>
+static void strassen_split(StrassenNode<T>& node, StrassenBump<T>& arena) {
+    node.h = node.n / 2;
+    const size_t quad = static_cast<size_t>(node.h) * node.h;
+    for (auto& p : node.s) p = arena.take(quad);
+    for (auto& p : node.t) p = arena.take(quad);
+    for (auto& p : node.m) p = arena.take(quad);
+}
+
+/**
+ * The 7 sub-products of a split node (children's outputs: M1, C11..C22, M6, M7).
+ */
+template <typename T>
+static void strassen_children(const StrassenNode<T>& node, StrassenNode<T> out[7]) {
+    const int h = node.h;
+    const T* a11 = node.a;
+    const T* a12 = node.a + h;
+    const T* a21 = node.a + h * node.lda;
+    const T* a22 = a21 + h;
+    const T* b11 = node.b;
+    const T* b21 = node.b + h * node.ldb;
+    const T* b22 = b21 + h;
+    T* c11 = node.c;
+    T* c12 = node.c + h;
+    T* c21 = node.c + h * node.ldc;
+    T* c22 = c21 + h;
+
+    out[0] = StrassenNode<T>{h, a11, node.lda, b11, node.ldb, node.m[0], h};
+    out[1] = StrassenNode<T>{h, a12, node.lda, b21, node.ldb, c11, node.ldc};
+    out[2] = StrassenNode<T>{h, node.s[3], h, b22, node.ldb, c12, node.ldc};
+    out[3] = StrassenNode<T>{h, a22, node.lda, node.t[3], h, c21, node.ldc};
+    out[4] = StrassenNode<T>{h, node.s[0], h, node.t[0], h, c22, node.ldc};
+    out[5] = StrassenNode<T>{h, node.s[1], h, node.t[1], h, node.m[1], h};
+    out[6] = StrassenNode<T>{h, node.s[2], h, node.t[2], h, node.m[2], h};
+}
+
+/**
+ * S1..S4 and T1..T4 for quadrant rows [r0, r1).
+ */
+template <typename T>
+static void strassen_sums(const StrassenNode<T>& node, int r0, int r1) {
+    const int h = node.h;
+    for (int i = r0; i < r1; ++i) {
+        const T* a11 = node.a + i * node.lda;
+        const T* a12 = a11 + h;
+        const T* a21 = node.a + (i + h) * node.lda;
+        const T* a22 = a21 + h;
+        const T* b11 = node.b + i * node.ldb;
+        const T* b12 = b11 + h;
+        const T* b21 = node.b + (i + h) * node.ldb;
+        const T* b22 = b21 + h;
+        T* s1 = node.s[0] + i * h;
+        T* s2 = node.s[1] + i * h;
+        T* s3 = node.s[2] + i * h;
+        T* s4 = node.s[3] + i * h;
+        T* t1 = node.t[0] + i * h;
+        T* t2 = node.t[1] + i * h;
+        T* t3 = node.t[2] + i * h;
+        T* t4 = node.t[3] + i * h;
+
+        for (int j = 0; j < h; ++j) {
+            s1[j] = a21[j] + a22[j];
+            s2[j] = s1[j] - a11[j];
+            s3[j] = a11[j] - a21[j];
+            s4[j] = a12[j] - s2[j];
+            t1[j] = b12[j] - b11[j];
+            t2[j] = b22[j] - t1[j];
+            t3[j] = b22[j] - b12[j];
+            t4[j] = t2[j] - b21[j];
+        }
+    }
+}
+
+/**
+ * C quadrants from M1..M7 for quadrant rows [r0, r1), then the odd-size fix-up of the
+ * same rows (and of the last row, by the band that ends the quadrant).
+ */
+template <typename T>
+static void strassen_combine(const StrassenNode<T>& node, int r0, int r1) {
+    const int h = node.h;
+    for (int i = r0; i < r1; ++i) {
+        const T* m1 = node.m[0] + i * h;
+        const T* m6 = node.m[1] + i * h;
+        const T* m7 = node.m[2] + i * h;
+        T* c11 = node.c + i * node.ldc;
+        T* c12 = c11 + h;
+        T* c21 = node.c + (i + h) * node.ldc;
+        T* c22 = c21 + h;
+
+        for (int j = 0; j < h; ++j) {
+            T u2 = m1[j] + m6[j];
+            T u3 = u2 + m7[j];
+            T m2 = c11[j], m3 = c12[j], m4 = c21[j], m5 = c22[j];
+            c11[j] = m1[j] + m2;
+            c12[j] = u2 + m5 + m3;
+            c21[j] = u3 - m4;
+            c22[j] = u3 + m5;
+        }
+    }
+
+    if (node.n % 2 == 0) return;
+
+    // Peeling: p = n - 1 is the row / column left out of the even core
+    const int n = node.n;
+    const int p = n - 1;
+    auto fix_row = [&](int i) {
+        const T* a_row = node.a + i * node.lda;
+        const T* b_last = node.b + p * node.ldb;
+        T* c_row = node.c + i * node.ldc;
+        const T a_ip = a_row[p];
+        for (int j = 0; j < p; ++j) c_row[j] += a_ip * b_last[j];
+
+        T dot = 0;
+        for (int k = 0; k < n; ++k) dot += a_row[k] * node.b[k * node.ldb + p];
+        c_row[p] = dot;
+    };
+    for (int i = r0; i < r1; ++i) {
+        fix_row(i);
+        fix_row(i + h);
+    }
+
+    if (r1 == h) {
+        const T* a_row = node.a + p * node.lda;
+        T* c_row = node.c + p * node.ldc;
+        std::fill(c_row, c_row + n, T(0));
+        for (int k = 0; k < n; ++k) {
+            const T a_pk = a_row[k];
+            const T* b_row = node.b + k * node.ldb;
+            for (int j = 0; j < n; ++j) c_row[j] += a_pk * b_row[j];
+        }
+    }
+}
+
+/**
+ * Sequential recursion below the parallel levels.
+ */
+template <typename T>
+static void strassen_sequential(StrassenNode<T> node, int cutoff, StrassenBump<T>& arena) {
+    if (node.n <= cutoff || node.n < 2) {
+        packed_gemm(select_gemm_kernel<T, T>(), GemmBlocking{}, node.n, node.n, node.n,
+                    node.a, node.lda, node.b, node.ldb, node.c, node.ldc);
+        return;
+    }
+
+    strassen_split(node, arena);
+    strassen_sums(node, 0, node.h);
+
+    StrassenNode<T> children[7];
+    strassen_children(node, children);
+    // A child's temporaries are dead once it returns, so siblings reuse the same region
+    const size_t mark = arena.used;
+    for (auto& child : children) {
+        strassen_sequential(child, cutoff, arena);
+        arena.used = mark;
+    }
+
+    strassen_combine(node, 0, node.h);
+}
+
+/////////////////////
+///    DRIVER     ///
+/////////////////////
+/**
+ * C = A x B for square n x n row-major matrices (row strides lda, ldb, ldc).
+ *
+ * @param pool    Workers for the sub-products (the caller takes part)
+ * @param arena   Temporaries; grown to strassen_workspace(n, cutoff, depth) if needed
+ * @param config  Cutoff and number of parallel levels
+ */
+template <typename T>
+static void strassen_gemm(ThreadPool& pool, StrassenArena<T>& arena, const StrassenConfig& config,
+                          int n, const T* a, int lda, const T* b, int ldb, T* c, int ldc) {
+    const int cutoff = std::max(config.cutoff, 1);
+
+    int depth = config.parallel_depth;
+    if (depth < 0) {
+        depth = 0;
+        for (long tasks = 1; tasks < 2L * pool.size(); tasks *= 7) ++depth;
+        if (pool.size() == 1) depth = 0;
+    }
+
+    // Levels actually available above the cutoff
+    int levels = 0;
+    for (int size = n; size > cutoff && size >= 2; size /= 2) ++levels;
+    depth = std::min(depth, levels);
+
+    // Nothing to split: this is just the blocked product, on all workers
+    if (levels == 0) {
+        tiled_gemm(pool, select_gemm_kernel<T, T>(), GemmBlocking{}, n, n, n, a, lda, b, ldb, c, ldc);
+        return;
+    }
+
+    arena.reserve(strassen_workspace<T>(n, cutoff, depth));
+    StrassenBump<T> bump = arena.bump();
+
+    // Breadth-first expansion of the parallel levels
+    std::vector<std::vector<StrassenNode<T>>> levels_nodes(depth + 1);
+    levels_nodes[0].push_back(StrassenNode<T>{n, a, lda, b, ldb, c, ldc});
+    for (int d = 0; d < depth; ++d) {
+        for (auto& node : levels_nodes[d]) {
+            strassen_split(node, bump);
+            StrassenNode<T> children[7];
+            strassen_children(node, children);
+            levels_nodes[d + 1].insert(levels_nodes[d + 1].end(), children, children + 7);
+        }
+    }
+
+    // Leaf workspace: one region per leaf for its sequential recursion, so the leaves
+    // run in parallel without touching each other's temporaries
+    const std::vector<StrassenNode<T>>& leaves = levels_nodes[depth];
+    const size_t leaf_elems = strassen_workspace<T>(leaves[0].n, cutoff, 0);
+    T* leaf_base = bump.take(0);
+
+    // Row-band tasks over all nodes of one level
+    auto for_each_band = [&](std::vector<StrassenNode<T>>& nodes, auto&& body) {
+        const int h = nodes.empty() ? 0 : nodes[0].h;
+        const int bands = std::max(1, (h + STRASSEN_BAND_ROWS - 1) / STRASSEN_BAND_ROWS);
+        pool.parallel_for(static_cast<int>(nodes.size()) * bands, [&](int task, int) {
+            StrassenNode<T>& node = nodes[task / bands];
+            const int r0 = (task % bands) * STRASSEN_BAND_ROWS;
+            body(node, r0, std::min(r0 + STRASSEN_BAND_ROWS, node.h));
+        });
+    };
+
+    for (int d = 0; d < depth; ++d) {
+        for_each_band(levels_nodes[d], [](const StrassenNode<T>& node, int r0, int r1) {
+            strassen_sums(node, r0, r1);
+        });
+    }
+
+    pool.parallel_for(static_cast<int>(leaves.size()), [&](int task, int) {
+        StrassenBump<T> leaf_bump{leaf_base + task * leaf_elems};
+        strassen_sequential(leaves[task], cutoff, leaf_bump);
+    });
+
+    for (int d = depth - 1; d >= 0; --d) {
+        for_each_band(levels_nodes[d], [](const StrassenNode<T>& node, int r0, int r1) {
+            strassen_combine(node, r0, r1);
+        });
+    }
+}
@@ -0,0 +1,512 @@
+///////////////////////////
+///   IMPORTS SECTION   ///
+///////////////////////////
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "packed_gemm.hpp"
+#include "thread_pool.hpp"
+
+///////////////////////////
+///   STRUCTS SECTION   ///
+///////////////////////////
+
+/**
+ * Process grid: 2D Cartesian arrangement of the processes of a communicator.
+ *
+ * Created with MPI_Dims_create (as square as the process count allows) and
+ * MPI_Cart_create. The row communicator joins the processes of one grid row (rank in
+ * it = grid column), the column communicator those of one grid column (rank in it =
+ * grid row), so panel broadcasts along a row or a column are plain collectives.
+ */
+struct ProcessGrid {
+    MPI_Comm grid = MPI_COMM_NULL;
+    MPI_Comm row = MPI_COMM_NULL;
+    MPI_Comm col = MPI_COMM_NULL;
+    int rows = 1;
+    int cols = 1;
+    int my_row = 0;
+    int my_col = 0;
+};
+
+
+/**
+ * Local block: This process's part of a block-distributed matrix.
+ *
+ * Process (r, c) of a rows x cols grid owns global rows [row0, row0 + nrows) and
+ * columns [col0, col0 + ncols), with the global rows and columns split as evenly as
+ * possible. Stored row-major.
+ */
+struct LocalBlock {
+    int row0 = 0;
+    int nrows = 0;
+    int col0 = 0;
+    int ncols = 0;
+    std::vector<double> data;
+};
+
+
+/**
+ * SUMMA statistics: Times of one distributed product on one process.
+ */
+struct SummaStats {
+    double total_s = 0.0;    // Whole product
+    double compute_s = 0.0;  // Local GEMMs
+    double wait_s = 0.0;     // Waiting for panel broadcasts
+};
+
+
+///////////////////////////
+///   HELPERS SECTION   ///
+///////////////////////////
+
+/** Start of part `part` when `n` is split into `parts` near-equal parts. */
+static int block_start(int n, int parts, int part) {
+    return static_cast<int>(static_cast<int64_t>(n) * part / parts);
+}
+
+/** Part of an n-split into `parts` that contains index i. */
+static int block_owner(int n, int parts, int i) {
+    int part = static_cast<int>(static_cast<int64_t>(i) * parts / n);
+    while (block_start(n, parts, part + 1) <= i) ++part;
+    while (block_start(n, parts, part) > i) --part;
+    return part;
+}
+
+/** Test data (small integers, so every sum is exact in double). */
+static double value_a(int i, int j) { return 1.0 + (i * 7 + j * 13) % 10; }
+static double value_b(int i, int j) { return 1.0 + (i * 11 + j * 5) % 10; }
+
+
+/**
+ * Process grid setup: Cartesian grid over `comm` plus row and column communicators.
+ *
+ * @param comm  Processes to arrange
+ * @return      Grid (free with free_process_grid)
+ */
+static ProcessGrid make_process_grid(MPI_Comm comm) {
+    ProcessGrid g;
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    int dims[2] = {0, 0};
+    int periods[2] = {0, 0};
+    MPI_Dims_create(size, 2, dims);
+    // No reordering: grid rank 0 (root of the timing reductions) must stay the rank that
+    // prints the report, i.e. rank 0 of `comm` and of MPI_COMM_WORLD
+    MPI_Cart_create(comm, 2, dims, periods, 0, &g.grid);
+
+    int rank, coords[2];
+    MPI_Comm_rank(g.grid, &rank);
+    MPI_Cart_coords(g.grid, rank, 2, coords);
+    g.rows = dims[0];
+    g.cols = dims[1];
+    g.my_row = coords[0];
+    g.my_col = coords[1];
+
+    // Row communicator keeps the column dimension (and vice versa)
+    int keep_cols[2] = {0, 1};
+    int keep_rows[2] = {1, 0};
+    MPI_Cart_sub(g.grid, keep_cols, &g.row);
+    MPI_Cart_sub(g.grid, keep_rows, &g.col);
+    return g;
+}
+
+static void free_process_grid(ProcessGrid& g) {
+    MPI_Comm_free(&g.row);
+    MPI_Comm_free(&g.col);
+    MPI_Comm_free(&g.grid);
+}
+
+
+/**
+ * Local block of a global rows x cols matrix on this process, filled from `value`.
+ */
+template <typename Fn>
+static LocalBlock make_local_block(const ProcessGrid& g, int rows, int cols, Fn&& value) {
+    LocalBlock block;
+    block.row0 = block_start(rows, g.rows, g.my_row);
+    block.nrows = block_start(rows, g.rows, g.my_row + 1) - block.row0;
+    block.col0 = block_start(cols, g.cols, g.my_col);
+    block.ncols = block_start(cols, g.cols, g.my_col + 1) - block.col0;
+    block.data.resize(static_cast<size_t>(block.nrows) * block.ncols);
+    for (int i = 0; i < block.nrows; ++i) {
+        for (int j = 0; j < block.ncols; ++j) {
+            block.data[static_cast<size_t>(i) * block.ncols + j] = value(block.row0 + i, block.col0 + j);
+        }
+    }
+    return block;
+}
+
+
+///////////////////////////
+///   SUMMA SECTION     ///
+///////////////////////////
+
+/**
+ * SUMMA: C = A x B for block-distributed A (m x k), B (k x n) and C (m x n).
+ *
+ * Algorithm (Scalable Universal Matrix Multiplication, van de Geijn & Watts):
+ * 1. K is cut into panels of at most `panel` columns that do not cross the block
+ *    boundaries of A's columns or B's rows, so each panel has one owner column of A
+ *    and one owner row of B
+ * 2. For every panel, the owner column broadcasts its A panel (local rows x width)
+ *    along each grid row, and the owner row its B panel (width x local columns)
+ *    along each grid column
+ * 3. Every process adds A panel x B panel to its C block with the Lab3 packed engine
+ *    (tiled_gemm on `pool`, accumulating)
+ *
+ * Pipelining (pipelined = true): panels are double-buffered. The MPI_Ibcast of panel
+ * p + 1 is posted before the local GEMM of panel p, and the GEMM runs in
+ * SUMMA_PROGRESS_CHUNKS row chunks with MPI_Testall in between. MPI libraries without
+ * an asynchronous progress thread only move a non-blocking collective forward inside
+ * MPI calls, so without the tests the broadcast would still happen at the wait. With
+ * pipelined = false every panel uses blocking MPI_Bcast, and communication and
+ * compute alternate.
+ *
+ * @param g          Process grid
+ * @param pool       Workers for the local GEMM
+ * @param m, n, k    Global dimensions
+ * @param A, B       Local blocks of A and B
+ * @param C          Local block of C (overwritten)
+ * @param panel      Panel width
+ * @param pipelined  Overlap broadcasts with compute
+ * @return           Times on this process
+ */
+static constexpr int SUMMA_PROGRESS_CHUNKS = 8;
+
+static SummaStats summa_gemm(const ProcessGrid& g, ThreadPool& pool, int m, int n, int k,
+                             const LocalBlock& A, const LocalBlock& B, LocalBlock& C,
+                             int panel, bool pipelined) {
+    SummaStats stats;
+    const double start = MPI_Wtime();
+    const GemmKernel<double, double>& kern = select_gemm_kernel<double, double>();
+    const GemmBlocking blk{};
+    (void)m;
+    (void)n;
+
+    // Panels: [k0, k0 + width) within one column block of A and one row block of B
+    struct Panel {
+        int k0;
+        int width;
+        int owner_col;
+        int owner_row;
+    };
+    std::vector<Panel> panels;
+    for (int k0 = 0; k0 < k;) {
+        const int owner_col = block_owner(k, g.cols, k0);
+        const int owner_row = block_owner(k, g.rows, k0);
+        const int end = std::min({k0 + panel, block_start(k, g.cols, owner_col + 1),
+                                  block_start(k, g.rows, owner_row + 1)});
+        panels.push_back({k0, end - k0, owner_col, owner_row});
+        k0 = end;
+    }
+
+    std::vector<double> a_buf[2], b_buf[2];
+    for (int i = 0; i < 2; ++i) {
+        a_buf[i].resize(static_cast<size_t>(A.nrows) * panel);
+        b_buf[i].resize(static_cast<size_t>(panel) * B.ncols);
+    }
+    MPI_Request requests[2][2] = {{MPI_REQUEST_NULL, MPI_REQUEST_NULL}, {MPI_REQUEST_NULL, MPI_REQUEST_NULL}};
+
+    // Owner packs its panel, then broadcasts along the row (A) and column (B)
+    auto post = [&](int p) {
+        const Panel& pn = panels[p];
+        double* a_panel = a_buf[p % 2].data();
+        double* b_panel = b_buf[p % 2].data();
+        if (g.my_col == pn.owner_col) {
+            const int col = pn.k0 - A.col0;
+            for (int i = 0; i < A.nrows; ++i) {
+                std::copy_n(A.data.data() + static_cast<size_t>(i) * A.ncols + col, pn.width,
+                            a_panel + static_cast<size_t>(i) * pn.width);
+            }
+        }
+        if (g.my_row == pn.owner_row) {
+            std::copy_n(B.data.data() + static_cast<size_t>(pn.k0 - B.row0) * B.ncols,
+                        static_cast<size_t>(pn.width) * B.ncols, b_panel);
+        }
+
+        const int a_count = A.nrows * pn.width;
+        const int b_count = pn.width * B.ncols;
+        if (pipelined) {
+            MPI_Ibcast(a_panel, a_count, MPI_DOUBLE, pn.owner_col, g.row, &requests[p % 2][0]);
+            MPI_Ibcast(b_panel, b_count, MPI_DOUBLE, pn.owner_row, g.col, &requests[p % 2][1]);
+        } else {
+            MPI_Bcast(a_panel, a_count, MPI_DOUBLE, pn.owner_col, g.row);
+            MPI_Bcast(b_panel, b_count, MPI_DOUBLE, pn.owner_row, g.col);
+        }
+    };
+
+    // C += A panel x B panel, in row chunks with progress calls on the next panel's broadcasts
+    auto compute = [&](int p, MPI_Request* next) {
+        const Panel& pn = panels[p];
+        const double* a_panel = a_buf[p % 2].data();
+        const double* b_panel = b_buf[p % 2].data();
+        const int chunks = next != nullptr ? SUMMA_PROGRESS_CHUNKS : 1;
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            const int r0 = block_start(C.nrows, chunks, chunk);
+            const int r1 = block_start(C.nrows, chunks, chunk + 1);
+            tiled_gemm(pool, kern, blk, r1 - r0, C.ncols, pn.width,
+                       a_panel + static_cast<size_t>(r0) * pn.width, pn.width, b_panel, C.ncols,
+                       C.data.data() + static_cast<size_t>(r0) * C.ncols, C.ncols, p > 0);
+            if (next != nullptr) {
+                int done;
+                MPI_Testall(2, next, &done, MPI_STATUSES_IGNORE);
+            }
+        }
+    };
+
+    if (k == 0) std::fill(C.data.begin(), C.data.end(), 0.0);
+    if (!panels.empty() && pipelined) post(0);
+
+    for (int p = 0; p < static_cast<int>(panels.size()); ++p) {
+        double wait_start = MPI_Wtime();
+        if (pipelined) {
+            MPI_Waitall(2, requests[p % 2], MPI_STATUSES_IGNORE);
+        } else {
+            post(p);
+        }
+        stats.wait_s += MPI_Wtime() - wait_start;
+
+        MPI_Request* next = nullptr;
+        if (pipelined && p + 1 < static_cast<int>(panels.size())) {
+            post(p + 1);
+            next = requests[(p + 1) % 2];
+        }
+
+        double compute_start = MPI_Wtime();
+        compute(p, next);
+        stats.compute_s += MPI_Wtime() - compute_start;
+    }
+
+    stats.total_s = MPI_Wtime() - start;
+    return stats;
+}
+
+
+///////////////////////////
+///  BENCHMARK SECTION  ///
+///////////////////////////
+
+/**
+ * One measured SUMMA run on `comm`.
+ */
+struct SummaRun {
+    int grid_rows = 0;
+    int grid_cols = 0;
+    double blocking_s = 0.0;   // Slowest process, blocking broadcasts
+    double pipelined_s = 0.0;  // Slowest process, pipelined broadcasts
+    double wait_share = 0.0;   // Pipelined: mean share of time waiting for panels
+    bool ok = true;
+};
+
+/**
+ * Runs SUMMA for an n x n x n product on the processes of `comm`: one warm-up, then
+ * one blocking and one pipelined run. Times are the slowest process's (MPI_MAX); the
+ * result is checked on sampled elements of every C block, each recomputed from the
+ * generators.
+ */
+static SummaRun run_summa(MPI_Comm comm, int n, int panel, int threads) {
+    SummaRun run;
+    ProcessGrid g = make_process_grid(comm);
+    ThreadPool pool(threads);
+    run.grid_rows = g.rows;
+    run.grid_cols = g.cols;
+
+    LocalBlock A = make_local_block(g, n, n, value_a);
+    LocalBlock B = make_local_block(g, n, n, value_b);
+    LocalBlock C = make_local_block(g, n, n, [](int, int) { return 0.0; });
+
+    summa_gemm(g, pool, n, n, n, A, B, C, panel, true);
+
+    MPI_Barrier(g.grid);
+    SummaStats blocking = summa_gemm(g, pool, n, n, n, A, B, C, panel, false);
+    MPI_Barrier(g.grid);
+    SummaStats pipelined = summa_gemm(g, pool, n, n, n, A, B, C, panel, true);
+
+    // Sampled check of the local C block
+    int ok = 1;
+    std::mt19937 gen(g.my_row * 131 + g.my_col);
+    for (int sample = 0; sample < 8 && C.nrows > 0 && C.ncols > 0; ++sample) {
+        const int i = static_cast<int>(gen() % C.nrows);
+        const int j = static_cast<int>(gen() % C.ncols);
+        double expected = 0.0;
+        for (int kk = 0; kk < n; ++kk) expected += value_a(C.row0 + i, kk) * value_b(kk, C.col0 + j);
+        if (C.data[static_cast<size_t>(i) * C.ncols + j] != expected) ok = 0;
+    }
+
+    int size;
+    MPI_Comm_size(g.grid, &size);
+    double share = pipelined.total_s > 0.0 ? pipelined.wait_s / pipelined.total_s : 0.0;
+    int all_ok;
+    MPI_Reduce(&blocking.total_s, &run.blocking_s, 1, MPI_DOUBLE, MPI_MAX, 0, g.grid);
+    MPI_Reduce(&pipelined.total_s, &run.pipelined_s, 1, MPI_DOUBLE, MPI_MAX, 0, g.grid);
+    MPI_Reduce(&share, &run.wait_share, 1, MPI_DOUBLE, MPI_SUM, 0, g.grid);
+    MPI_Reduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, 0, g.grid);
+    run.wait_share /= size;
+    run.ok = all_ok != 0;
+
+    free_process_grid(g);
+    return run;
+}
+
+
+/**
+ * Process counts for the scaling runs: 1, 2, 4, ... up to the world size, and the
+ * world size itself.
+ */
+static std::vector<int> scaling_counts(int world) {
+    std::vector<int> counts;
+    for (int p = 1; p < world; p *= 2) counts.push_back(p);
+    counts.push_back(world);
+    return counts;
+}
+
+
+/**
+ * Strong and weak scaling: every run uses the first p ranks of MPI_COMM_WORLD
+ * (MPI_Comm_split), so one mpirun covers all process counts.
+ *
+ * - Strong: fixed n; speedup and efficiency against 1 process
+ * - Weak:   n = n0 x sqrt(p) (rounded to 64), so every process holds the same
+ *           n0^2 elements of each matrix; the work per process still grows as sqrt(p),
+ *           so efficiency is GFLOP/s per process against 1 process
+ */
+static void run_scaling_experiments(int strong_n, int weak_n0, int panel, int threads) {
+    int rank, world;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+    const std::vector<int> counts = scaling_counts(world);
+
+    if (rank == 0) {
+        std::cout << "\n############################################\n";
+        std::cout << "#  SUMMA STRONG SCALING                    #\n";
+        std::cout << "############################################\n";
+        std::cout << "\nn = " << strong_n << ", panel " << panel << ", " << threads << " thread(s) per process\n";
+        std::cout << std::setw(7) << "Procs" << std::setw(7) << "Grid" << std::setw(13) << "Blocking s"
+                  << std::setw(14) << "Pipelined s" << std::setw(10) << "GFLOP/s" << std::setw(10) << "Speedup"
+                  << std::setw(12) << "Efficiency" << std::setw(8) << "Wait" << std::setw(8) << "Check" << "\n";
+    }
+
+    double base_s = 0.0;
+    for (int p : counts) {
+        MPI_Comm sub;
+        MPI_Comm_split(MPI_COMM_WORLD, rank < p ? 0 : MPI_UNDEFINED, rank, &sub);
+        if (sub != MPI_COMM_NULL) {
+            SummaRun run = run_summa(sub, strong_n, panel, threads);
+            if (rank == 0) {
+                if (p == 1) base_s = run.pipelined_s;
+                const double speedup = base_s / run.pipelined_s;
+                std::string grid = std::to_string(run.grid_rows) + "x" + std::to_string(run.grid_cols);
+                std::cout << std::setw(7) << p << std::setw(7) << grid << std::fixed << std::setprecision(3)
+                          << std::setw(13) << run.blocking_s << std::setw(14) << run.pipelined_s
+                          << std::setprecision(2) << std::setw(10) << 2.0 * strong_n * strong_n * strong_n / (run.pipelined_s * 1e9)
+                          << std::setw(9) << speedup << "x" << std::setw(11) << 100.0 * speedup / p << "%"
+                          << std::setw(7) << 100.0 * run.wait_share << "%"
+                          << std::setw(8) << (run.ok ? "OK" : "FAIL") << "\n";
+            }
+            MPI_Comm_free(&sub);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (rank == 0) {
+        std::cout << "\n############################################\n";
+        std::cout << "#  SUMMA WEAK SCALING                      #\n";
+        std::cout << "############################################\n";
+        std::cout << "\nn = " << weak_n0 << " x sqrt(p), panel " << panel << "\n";
+        std::cout << std::setw(7) << "Procs" << std::setw(7) << "Grid" << std::setw(8) << "n"
+                  << std::setw(14) << "Pipelined s" << std::setw(10) << "GFLOP/s" << std::setw(14) << "GFLOP/s/proc"
+                  << std::setw(12) << "Efficiency" << std::setw(8) << "Wait" << std::setw(8) << "Check" << "\n";
+    }
+
+    double base_rate = 0.0;
+    for (int p : counts) {
+        const int n = std::max(64, static_cast<int>(std::lround(weak_n0 * std::sqrt(p) / 64.0)) * 64);
+        MPI_Comm sub;
+        MPI_Comm_split(MPI_COMM_WORLD, rank < p ? 0 : MPI_UNDEFINED, rank, &sub);
+        if (sub != MPI_COMM_NULL) {
+            SummaRun run = run_summa(sub, n, panel, threads);
+            if (rank == 0) {
+                const double gflops = 2.0 * n * n * n / (run.pipelined_s * 1e9);
+                if (p == 1) base_rate = gflops;
+                std::string grid = std::to_string(run.grid_rows) + "x" + std::to_string(run.grid_cols);
+                std::cout << std::setw(7) << p << std::setw(7) << grid << std::setw(8) << n << std::fixed
+                          << std::setprecision(3) << std::setw(14) << run.pipelined_s << std::setprecision(2)
+                          << std::setw(10) << gflops << std::setw(14) << gflops / p
+                          << std::setw(11) << 100.0 * (gflops / p) / base_rate << "%"
+                          << std::setw(7) << 100.0 * run.wait_share << "%"
+                          << std::setw(8) << (run.ok ? "OK" : "FAIL") << "\n";
+            }
+            MPI_Comm_free(&sub);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+}
+
+
+///////////////////////////
+///    MAIN SECTION     ///
+///////////////////////////
+
+/**
+ * Main entry point: SUMMA strong and weak scaling over the ranks of one mpirun.
+ *
+ * Build and run (Open MPI / MPICH):
+ *   mpicxx -O3 -std=c++17 -pthread summa_mpi.cpp -o summa_mpi
+ *   mpirun -np 16 ./summa_mpi [--n 4096] [--weak 1024] [--panel 256] [--threads 1]
+ *
+ * Options:
+ * - --n N:       Strong scaling size (default 2048)
+ * - --weak N0:   Weak scaling size on one process (default 1024)
+ * - --panel B:   SUMMA panel width (default 256, the packed engine's KC)
+ * - --threads T: Pool workers per process for the local GEMM (default 1: one rank per core)
+ */
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    int strong_n = 2048;
+    int weak_n0 = 1024;
+    int panel = 256;
+    int threads = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--n") strong_n = value;
+        else if (arg == "--weak") weak_n0 = value;
+        else if (arg == "--panel") panel = value;
+        else if (arg == "--threads") threads = value;
+    }
+    panel = std::max(1, panel);
+    threads = std::max(1, threads);
+
+    int rank, world;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+    if (rank == 0) {
+        std::cout << "############################################\n";
+        std::cout << "#  SUMMA MATRIX MULTIPLICATION (MPI)     #\n";
+        std::cout << "############################################\n\n";
+        std::cout << "Processes: " << world << "\n";
+        std::cout << "Local kernel: " << select_gemm_kernel<double, double>().name << "\n";
+    }
+
+    run_scaling_experiments(strong_n, weak_n0, panel, threads);
+
+    if (rank == 0) {
+        std::cout << "\n############################################\n";
+        std::cout << "#  ALL TESTS COMPLETED                    #\n";
+        std::cout << "############################################\n";
+    }
+
+    MPI_Finalize();
+    return 0;
+}
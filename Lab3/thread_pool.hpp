@@ -0,0 +1,169 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Persistent worker pool with dynamically scheduled index tasks.
+ *
+ * - The workers are created once and live as long as the pool, so a parallel call costs
+ *   one wake-up instead of a thread create/join per worker.
+ * - `parallel_for(tasks, fn)` runs fn(task, worker) for every task in [0, tasks). The
+ *   calling thread takes part as worker 0, the pool threads are workers 1..size()-1.
+ * - Tasks are claimed one at a time from a shared atomic counter, so faster workers
+ *   take more tasks and uneven tasks or shapes leave no worker idle until the end.
+ * - After a job, workers poll for the next one for POOL_SPIN_ITERATIONS before they
+ *   sleep on the condition variable, so back-to-back small jobs do not pay a futex
+ *   wake-up each.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Polls for a new job before an idle worker blocks (every 64th poll yields, so spinning
+// workers do not starve the caller when the pool is larger than the machine)
+constexpr int POOL_SPIN_ITERATIONS = 1 << 12;
+
+/////////////////////
+///     POOL      ///
+/////////////////////
+class ThreadPool {
+public:
+    /**
+     * @param workers  Total workers including the calling thread (at least 1)
+     */
+    explicit ThreadPool(int workers) : size_(workers < 1 ? 1 : workers) {
+        for (int w = 1; w < size_; ++w) {
+            threads_.emplace_back([this, w] { worker_loop(w); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        cv_job_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Number of workers, including the calling thread. */
+    int size() const { return size_; }
+
+    /**
+     * Runs fn(task, worker) for task = 0..tasks-1 and returns when all have finished.
+     * Not reentrant: one parallel_for at a time per pool.
+     */
+    void parallel_for(int tasks, const std::function<void(int task, int worker)>& fn) {
+        if (tasks <= 0) return;
+        if (size_ == 1 || tasks == 1) {
+            for (int t = 0; t < tasks; ++t) fn(t, 0);
+            return;
+        }
+
+        job_ = &fn;
+        job_tasks_ = tasks;
+        next_task_.store(0, std::memory_order_relaxed);
+        active_.store(size_ - 1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        cv_job_.notify_all();
+
+        run_tasks(0);
+
+        // Wait for the pool threads to leave the job (they may still be running a task)
+        for (int spin = 0; active_.load(std::memory_order_acquire) != 0; ++spin) {
+            if (spin < POOL_SPIN_ITERATIONS) {
+                pool_cpu_relax(spin);
+            } else {
+                std::unique_lock<std::mutex> lock(mtx_);
+                cv_done_.wait(lock, [&] { return active_.load(std::memory_order_acquire) == 0; });
+            }
+        }
+        job_ = nullptr;
+    }
+
+private:
+    static inline void pool_cpu_relax(int spin) {
+#if defined(__x86_64__) || defined(__i386__)
+        if ((spin & 63) != 63) {
+            _mm_pause();
+            return;
+        }
+#endif
+        (void)spin;
+        std::this_thread::yield();
+    }
+
+    /** Claims and runs tasks until the counter passes the end. */
+    void run_tasks(int worker) {
+        const std::function<void(int, int)>& fn = *job_;
+        for (int t = next_task_.fetch_add(1, std::memory_order_relaxed); t < job_tasks_;
+             t = next_task_.fetch_add(1, std::memory_order_relaxed)) {
+            fn(t, worker);
+        }
+    }
+
+    void worker_loop(int worker) {
+        uint64_t seen = 0;
+        while (true) {
+            // Poll, then sleep until the generation changes
+            uint64_t gen = generation_.load(std::memory_order_acquire);
+            for (int spin = 0; gen == seen && spin < POOL_SPIN_ITERATIONS; ++spin) {
+                pool_cpu_relax(spin);
+                gen = generation_.load(std::memory_order_acquire);
+            }
+            if (gen == seen) {
+                std::unique_lock<std::mutex> lock(mtx_);
+                cv_job_.wait(lock, [&] { return generation_.load(std::memory_order_acquire) != seen; });
+                gen = generation_.load(std::memory_order_acquire);
+            }
+            seen = gen;
+            if (stop_) return;
+
+            run_tasks(worker);
+
+            if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                cv_done_.notify_one();
+            }
+        }
+    }
+
+    const int size_;
+    std::vector<std::thread> threads_;
+
+    // Current job (written by the caller before the generation is published)
+    const std::function<void(int, int)>* job_ = nullptr;
+    int job_tasks_ = 0;
+
+    alignas(64) std::atomic<int> next_task_{0};
+    alignas(64) std::atomic<int> active_{0};
+    alignas(64) std::atomic<uint64_t> generation_{0};
+
+    std::mutex mtx_;
+    std::condition_variable cv_job_;
+    std::condition_variable cv_done_;
+    bool stop_ = false;
+};
@@ -0,0 +1,478 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Work-stealing fork-join runtime.
+ *
+ * - ForkJoinPool(workers) starts a fixed number of worker threads. Each owns a
+ *   Chase-Lev deque of task pointers: the owner pushes and pops at the bottom (LIFO,
+ *   the most recent and cache-warm task, no atomic read-modify-write unless it races
+ *   a thief for the last task), thieves take from the top (FIFO, the oldest and
+ *   therefore largest subproblem) with one CAS.
+ * - Help-first spawning: fork_join(f, g, h) pushes g and h as stealable tasks and
+ *   runs f on the spawning worker, which keeps going while idle workers steal the
+ *   children.
+ * - Helping joins: a join pops its child back and runs it inline if nobody stole it;
+ *   if it was stolen, the joiner steals and runs other tasks until the child is done
+ *   instead of blocking. Workers never sleep on a join, and the thread count stays
+ *   fixed however deep the recursion forks.
+ * - Tasks live in the forking frame (fork_join) or in one vector (fork_join_range),
+ *   so a fork allocates nothing beyond occasional deque growth.
+ * - Idle workers yield briefly, then sleep on a condition variable; a spawn wakes one
+ *   sleeper if there is any.
+ * - fork_join / fork_join_range outside a pool worker run their functions one after
+ *   another, so recursive code written against them also runs without a pool.
+ * - An exception thrown by a task is rethrown at its join (after all siblings of the
+ *   fork have been joined, so no task outlives the frame it lives in).
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Initial deque capacity (tasks); the ring doubles when full
+constexpr int64_t FORK_JOIN_DEQUE_CAPACITY = 256;
+
+// Failed searches for work before an idle worker goes to sleep
+constexpr int FORK_JOIN_SPINS = 64;
+
+// Upper bound of one sleep (safety net; spawns wake sleepers explicitly)
+constexpr auto FORK_JOIN_SLEEP = std::chrono::milliseconds(1);
+
+/////////////////////
+///     TASKS     ///
+/////////////////////
+/**
+ * ForkJoinTask: type-erased unit of work, referenced (not owned) by the deques.
+ */
+struct ForkJoinTask {
+    void (*run)(ForkJoinTask*) = nullptr;
+    std::atomic<bool> done{false};
+    bool external = false;  // Submitted by a non-worker thread through invoke()
+    std::exception_ptr error;
+};
+
+/** Task that calls a function object living in the forking frame. */
+template <typename Fn>
+struct ForkJoinFnTask : ForkJoinTask {
+    Fn* fn;
+
+    explicit ForkJoinFnTask(Fn& f) : fn(&f) {
+        run = [](ForkJoinTask* task) { (*static_cast<ForkJoinFnTask*>(task)->fn)(); };
+    }
+};
+
+/////////////////////
+///     DEQUE     ///
+/////////////////////
+/**
+ * ChaseLevDeque: single-owner, multi-thief work-stealing deque (Chase & Lev 2005, with
+ * the C11 memory orderings of Le et al. 2013; push publishes with a release store of
+ * bottom instead of a standalone fence, same code on x86 and visible to ThreadSanitizer).
+ *
+ * push / pop are called by the owning worker only, steal by any thread. Retired rings
+ * are kept until destruction, because a thief may still read a slot of the old ring.
+ */
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(int64_t capacity = FORK_JOIN_DEQUE_CAPACITY) {
+        rings_.push_back(std::make_unique<Ring>(capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    /** Owner: pushes a task at the bottom. */
+    void push(ForkJoinTask* task) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (b - t > ring->capacity - 1) ring = grow(ring, t, b);
+        ring->put(b, task);
+        bottom_.store(b + 1, std::memory_order_release);  // Publishes the task to thieves
+    }
+
+    /** Owner: pops the most recently pushed task, nullptr if empty. */
+    ForkJoinTask* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {  // Empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        ForkJoinTask* task = ring->get(b);
+        if (t == b) {  // Last task: race the thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    /** Any thread: takes the oldest task, nullptr if empty or lost a race. */
+    ForkJoinTask* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        ForkJoinTask* task = ring_.load(std::memory_order_acquire)->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return task;
+    }
+
+    /** Approximate emptiness check (used before going to sleep). */
+    bool empty() const {
+        return bottom_.load(std::memory_order_seq_cst) <= top_.load(std::memory_order_seq_cst);
+    }
+
+private:
+    struct Ring {
+        explicit Ring(int64_t cap) : capacity(cap), slots(new std::atomic<ForkJoinTask*>[cap]) {}
+
+        ForkJoinTask* get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, ForkJoinTask* task) { slots[i & (capacity - 1)].store(task, std::memory_order_relaxed); }
+
+        int64_t capacity;  // Power of two
+        std::unique_ptr<std::atomic<ForkJoinTask*>[]> slots;
+    };
+
+    Ring* grow(Ring* old, int64_t t, int64_t b) {
+        rings_.push_back(std::make_unique<Ring>(old->capacity * 2));
+        Ring* ring = rings_.back().get();
+        for (int64_t i = t; i < b; ++i) ring->put(i, old->get(i));
+        ring_.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_;  // Owner only
+};
+
+/////////////////////
+///     POOL      ///
+/////////////////////
+class ForkJoinPool;
+
+/** Per-thread state of a pool worker. */
+struct ForkJoinWorker {
+    ForkJoinPool* pool = nullptr;
+    size_t index = 0;
+    uint64_t seed = 0;  // xorshift state for victim selection
+    ChaseLevDeque deque;
+    std::atomic<uint64_t> steals{0};
+    std::thread thread;
+};
+
+/** Worker running on the calling thread (nullptr outside a pool). */
+static ForkJoinWorker*& fork_join_current() {
+    thread_local ForkJoinWorker* worker = nullptr;
+    return worker;
+}
+
+/**
+ * ForkJoinPool: fixed set of work-stealing workers.
+ *
+ * invoke(fn) runs fn as the root task on a worker and blocks the caller until the
+ * whole computation forked from it has finished. The pool must outlive the call.
+ */
+class ForkJoinPool {
+public:
+    /**
+     * @param workers  Number of worker threads (0: hardware concurrency)
+     */
+    explicit ForkJoinPool(size_t workers = 0) {
+        if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.push_back(std::make_unique<ForkJoinWorker>());
+            workers_.back()->pool = this;
+            workers_.back()->index = i;
+            workers_.back()->seed = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (auto& worker : workers_) worker->thread = std::thread([this, w = worker.get()] { worker_loop(w); });
+    }
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_.store(true, std::memory_order_release);
+        }
+        sleep_cv_.notify_all();
+        for (auto& worker : workers_) worker->thread.join();
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    /** Successful steals since construction (all workers). */
+    uint64_t steals() const {
+        uint64_t total = 0;
+        for (auto& worker : workers_) total += worker->steals.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     * Runs fn() on the pool and waits for it. Called from one of this pool's workers,
+     * fn simply runs inline.
+     */
+    template <typename Fn>
+    void invoke(Fn&& fn) {
+        ForkJoinWorker* current = fork_join_current();
+        if (current && current->pool == this) {
+            fn();
+            return;
+        }
+
+        ForkJoinFnTask<std::remove_reference_t<Fn>> task(fn);
+        task.external = true;
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            injected_.push_back(&task);
+            injected_count_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        wake_one();
+
+        std::unique_lock<std::mutex> lock(done_mutex_);
+        done_cv_.wait(lock, [&] { return task.done.load(std::memory_order_acquire); });
+        if (task.error) std::rethrow_exception(task.error);
+    }
+
+    /** Worker only: makes task available to thieves (help-first). */
+    void spawn(ForkJoinWorker* self, ForkJoinTask* task) {
+        self->deque.push(task);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_one();
+    }
+
+    /**
+     * Worker only: waits for a spawned task, running it inline if it was not stolen and
+     * other tasks while it runs elsewhere. Does not rethrow (see fork_join_rethrow).
+     */
+    void join(ForkJoinWorker* self, ForkJoinTask* task) {
+        while (!task->done.load(std::memory_order_acquire)) {
+            if (ForkJoinTask* next = self->deque.pop()) {
+                execute(next);
+                continue;
+            }
+            if (ForkJoinTask* stolen = steal_from_others(self)) {
+                execute(stolen);
+                continue;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void execute(ForkJoinTask* task) {
+        try {
+            task->run(task);
+        } catch (...) {
+            task->error = std::current_exception();
+        }
+        if (!task->external) {
+            task->done.store(true, std::memory_order_release);
+            return;
+        }
+        // The invoking thread sleeps on done_cv_; the task lives in its frame
+        {
+            std::lock_guard<std::mutex> lock(done_mutex_);
+            task->done.store(true, std::memory_order_release);
+        }
+        done_cv_.notify_all();
+    }
+
+    ForkJoinTask* steal_from_others(ForkJoinWorker* self) {
+        const size_t count = workers_.size();
+        if (count < 2) return nullptr;
+        self->seed ^= self->seed << 13;
+        self->seed ^= self->seed >> 7;
+        self->seed ^= self->seed << 17;
+        size_t start = self->seed % count;
+        for (size_t k = 0; k < count; ++k) {
+            ForkJoinWorker* victim = workers_[(start + k) % count].get();
+            if (victim == self) continue;
+            if (ForkJoinTask* task = victim->deque.steal()) {
+                self->steals.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    ForkJoinTask* take_injected() {
+        if (injected_count_.load(std::memory_order_acquire) == 0) return nullptr;
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        if (injected_.empty()) return nullptr;
+        ForkJoinTask* task = injected_.front();
+        injected_.pop_front();
+        injected_count_.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    ForkJoinTask* find_task(ForkJoinWorker* self) {
+        if (ForkJoinTask* task = self->deque.pop()) return task;
+        if (ForkJoinTask* task = steal_from_others(self)) return task;
+        return take_injected();
+    }
+
+    bool has_work() const {
+        if (injected_count_.load(std::memory_order_seq_cst) > 0) return true;
+        for (auto& worker : workers_)
+            if (!worker->deque.empty()) return true;
+        return false;
+    }
+
+    void wake_one() {
+        if (sleeping_.load(std::memory_order_seq_cst) == 0) return;
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.notify_one();
+    }
+
+    void worker_loop(ForkJoinWorker* self) {
+        fork_join_current() = self;
+        int idle = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (ForkJoinTask* task = find_task(self)) {
+                execute(task);
+                idle = 0;
+                continue;
+            }
+            if (++idle < FORK_JOIN_SPINS) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Announce the sleep before the last look for work: a spawner either sees
+            // sleeping_ > 0 and notifies, or its task is seen by has_work()
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!stop_.load(std::memory_order_acquire) && !has_work()) sleep_cv_.wait_for(lock, FORK_JOIN_SLEEP);
+            sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+            idle = 0;
+        }
+        fork_join_current() = nullptr;
+    }
+
+    std::vector<std::unique_ptr<ForkJoinWorker>> workers_;
+
+    std::mutex inject_mutex_;
+    std::deque<ForkJoinTask*> injected_;
+    std::atomic<size_t> injected_count_{0};
+
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<int> sleeping_{0};
+    std::atomic<bool> stop_{false};
+};
+
+/////////////////////
+///   FORK-JOIN   ///
+/////////////////////
+/** Rethrows the first error among joined tasks. */
+static void fork_join_rethrow(ForkJoinTask* const* tasks, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        if (tasks[i]->error) std::rethrow_exception(tasks[i]->error);
+}
+
+/**
+ * Runs all functions, potentially in parallel, and returns when all have finished.
+ *
+ * The first function runs on the calling worker, the others are spawned as stealable
+ * tasks and joined in reverse order (the order the deque hands them back). Outside a
+ * pool worker everything runs sequentially.
+ */
+template <typename First, typename... Rest>
+static void fork_join(First&& first, Rest&&... rest) {
+    ForkJoinWorker* self = fork_join_current();
+    if (!self || sizeof...(Rest) == 0) {
+        first();
+        (rest(), ...);
+        return;
+    }
+
+    std::tuple<ForkJoinFnTask<std::remove_reference_t<Rest>>...> tasks(rest...);
+    std::apply([&](auto&... task) {
+        ForkJoinTask* spawned[] = {&task...};
+        for (ForkJoinTask* t : spawned) self->pool->spawn(self, t);
+
+        std::exception_ptr error;
+        try {
+            first();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (size_t i = sizeof...(Rest); i-- > 0;) self->pool->join(self, spawned[i]);
+        if (error) std::rethrow_exception(error);
+        fork_join_rethrow(spawned, sizeof...(Rest));
+    }, tasks);
+}
+
+/**
+ * Runs fn(0) .. fn(count - 1), potentially in parallel, and returns when all have
+ * finished. Same scheduling as fork_join, for a count known only at run time.
+ */
+template <typename Fn>
+static void fork_join_range(size_t count, Fn&& fn) {
+    using Body = std::remove_reference_t<Fn>;
+    ForkJoinWorker* self = fork_join_current();
+    if (!self || count < 2) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    struct IndexTask : ForkJoinTask {
+        Body* body = nullptr;
+        size_t index = 0;
+    };
+    std::vector<IndexTask> tasks(count - 1);
+    std::vector<ForkJoinTask*> spawned(count - 1);
+    for (size_t i = 1; i < count; ++i) {
+        IndexTask& task = tasks[i - 1];
+        task.body = &fn;
+        task.index = i;
+        task.run = [](ForkJoinTask* t) {
+            auto* self_task = static_cast<IndexTask*>(t);
+            (*self_task->body)(self_task->index);
+        };
+        spawned[i - 1] = &task;
+        self->pool->spawn(self, &task);
+    }
+
+    std::exception_ptr error;
+    try {
+        fn(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (size_t i = count - 1; i-- > 0;) self->pool->join(self, spawned[i]);
+    if (error) std::rethrow_exception(error);
+    fork_join_rethrow(spawned.data(), spawned.size());
+}
@@ -2,13 +2,23 @@
 ///   IMPORTS SECTION   ///
 ///////////////////////////
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <future>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
 #include <thread>
 #include <vector>
 
+#include "fork_join.hpp"
+#include "ntt.hpp"
+
 
 ///////////////////////////
 ///   TYPEDEFS SECTION  ///
@@ -16,6 +26,38 @@
 using Coeff = long long;
 using Poly = std::vector<Coeff>;
 
+// Operand size from which a parallel Karatsuba node forks its sub-products as tasks
+constexpr size_t KARATSUBA_TASK_CUTOFF = 1024;
+
+// Output-partitioned naive multiplication: coefficients x terms per cache tile
+constexpr size_t NAIVE_TILE_OUTPUTS = 512;
+constexpr size_t NAIVE_TILE_INPUTS = 2048;
+
+
+///////////////////////////
+///  ALLOCATION COUNTER ///
+///////////////////////////
+
+/**
+ * Global heap allocation counter.
+ *
+ * Every operator new in the program goes through the replacements below, so the
+ * difference of two readings is the number of heap allocations in between (all
+ * threads). Used by the benchmarks to compare the allocation behaviour of variants.
+ */
+static std::atomic<size_t> g_allocations{0};
+
+// Kept out of line: inlined into std::vector, GCC would pair malloc / free with new /
+// delete expressions and warn about a mismatch that does not exist
+__attribute__((noinline)) void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
 
 ///////////////////////////
 ///   HELPERS SECTION   ///
@@ -92,6 +134,154 @@ static Poly multiply_naive_par(const Poly& a, const Poly& b) {
     return result;
 }
 
+/**
+ * Reversed dot products of one tile: for k in [k0, k1)
+ *   out[k] += Σ a[i] * rb[i + m - 1 - k],  i in [i0, i1) ∩ [i_min(k), i_max(k)]
+ * with rb = b reversed, so that b[k - i] = rb[i + m - 1 - k] runs forwards with i and
+ * the sum is a plain dot product of two contiguous ranges. i_min(k) = max(0, k - m + 1)
+ * and i_max(k) = min(k, n - 1) are the index bounds of the Bonus1 GPU kernel.
+ *
+ * Outputs are computed four at a time: the four dot products share every load of a
+ * (the rb ranges are shifted by one), and their common i-range is the vectorised
+ * part; the few indices where the bounds of the four differ are summed one by one.
+ */
+__attribute__((always_inline)) static inline void naive_tile_body(const Coeff* a, size_t n, const Coeff* rb, size_t m,
+                                                                    Coeff* out, size_t k0, size_t k1, size_t i0,
+                                                                    size_t i1) {
+    auto lo_of = [&](size_t k) { return std::max(i0, k >= m ? k - m + 1 : 0); };
+    auto hi_of = [&](size_t k) { return std::min(i1, std::min(k, n - 1) + 1); };
+    auto dot = [&](size_t k, size_t lo, size_t hi) {
+        const Coeff* r = rb + (m - 1 - k);
+        Coeff sum = 0;
+        for (size_t i = lo; i < hi; ++i) sum += a[i] * r[i];
+        return sum;
+    };
+
+    size_t k = k0;
+    for (; k + 4 <= k1; k += 4) {
+        // Common range of k .. k + 3 (both bounds grow with k)
+        size_t lo = lo_of(k + 3), hi = hi_of(k);
+        if (lo >= hi) {
+            for (size_t q = 0; q < 4; ++q) out[k + q] += dot(k + q, lo_of(k + q), hi_of(k + q));
+            continue;
+        }
+        const Coeff* r0 = rb + (m - 1 - k);
+        const Coeff* r1 = r0 - 1;
+        const Coeff* r2 = r0 - 2;
+        const Coeff* r3 = r0 - 3;
+        Coeff s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (size_t i = lo; i < hi; ++i) {
+            s0 += a[i] * r0[i];
+            s1 += a[i] * r1[i];
+            s2 += a[i] * r2[i];
+            s3 += a[i] * r3[i];
+        }
+        Coeff s[4] = {s0, s1, s2, s3};
+        for (size_t q = 0; q < 4; ++q)
+            out[k + q] += s[q] + dot(k + q, lo_of(k + q), lo) + dot(k + q, hi, std::max(hi, hi_of(k + q)));
+    }
+    for (; k < k1; ++k) {
+        size_t lo = lo_of(k), hi = hi_of(k);
+        if (lo < hi) out[k] += dot(k, lo, hi);
+    }
+}
+
+using NaiveTileKernel = void (*)(const Coeff*, size_t, const Coeff*, size_t, Coeff*, size_t, size_t, size_t, size_t);
+
+static void naive_tile_scalar(const Coeff* a, size_t n, const Coeff* rb, size_t m, Coeff* out, size_t k0, size_t k1,
+                              size_t i0, size_t i1) {
+    naive_tile_body(a, n, rb, m, out, k0, k1, i0, i1);
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+// Same body compiled for AVX2 (64-bit products emulated) and AVX-512DQ (vpmullq)
+__attribute__((target("avx2"))) static void naive_tile_avx2(const Coeff* a, size_t n, const Coeff* rb, size_t m,
+                                                            Coeff* out, size_t k0, size_t k1, size_t i0, size_t i1) {
+    naive_tile_body(a, n, rb, m, out, k0, k1, i0, i1);
+}
+
+__attribute__((target("avx512f,avx512dq"))) static void naive_tile_avx512(const Coeff* a, size_t n, const Coeff* rb,
+                                                                          size_t m, Coeff* out, size_t k0, size_t k1,
+                                                                          size_t i0, size_t i1) {
+    naive_tile_body(a, n, rb, m, out, k0, k1, i0, i1);
+}
+#endif
+
+/** Widest tile kernel the CPU supports (selected once). */
+static NaiveTileKernel select_naive_tile() {
+    static const NaiveTileKernel kernel = [] {
+#if defined(__GNUC__) && defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return &naive_tile_avx512;
+        if (__builtin_cpu_supports("avx2")) return &naive_tile_avx2;
+#endif
+        return &naive_tile_scalar;
+    }();
+    return kernel;
+}
+
+/**
+ * Output-partitioned parallel naive multiplication.
+ *
+ * Instead of giving every thread a full-size local result and merging them, the output
+ * range [0, n + m - 1) is split into one contiguous k-range per thread, each holding
+ * the same number of multiply-adds (the work per coefficient, i_max(k) - i_min(k) + 1,
+ * is a trapezoid in k). A thread computes its C[k] completely and writes them directly
+ * into the shared result:
+ * - tiles of NAIVE_TILE_OUTPUTS coefficients x NAIVE_TILE_INPUTS terms, so the slices of
+ *   a and of reversed b stay in L1/L2 while a tile's outputs are accumulated
+ * - each C[k] is a reversed dot product, vectorised by naive_tile_body
+ *
+ * Synchronization:
+ * - Threads write disjoint output ranges, so there is no merge step and no contention
+ * - Extra memory is the reversed copy of b: O(n + m) in total instead of O(T (n + m))
+ *
+ * @param a        First polynomial
+ * @param b        Second polynomial
+ * @param threads  Number of threads (0: hardware concurrency)
+ * @return         Product coefficients
+ */
+static Poly multiply_naive_output_par(const Poly& a, const Poly& b, unsigned threads = 0) {
+    if (a.empty() || b.empty()) return {};
+    const size_t n = a.size(), m = b.size(), total = n + m - 1;
+    Poly result(total, 0);
+    Poly rb(b.rbegin(), b.rend());
+
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 4;
+
+    // Equal-work split of the output range: boundaries where the running work count
+    // crosses t / threads of the n * m multiply-adds
+    std::vector<size_t> bounds{0};
+    const unsigned long long work = static_cast<unsigned long long>(n) * m;
+    unsigned long long done = 0;
+    for (size_t k = 0; k < total && bounds.size() < threads; ++k) {
+        done += std::min(k, n - 1) - (k >= m ? k - m + 1 : 0) + 1;
+        if (done * threads >= work * bounds.size()) bounds.push_back(k + 1);
+    }
+    bounds.push_back(total);
+
+    const NaiveTileKernel kernel = select_naive_tile();
+    auto compute = [&](size_t k_begin, size_t k_end) {
+        for (size_t kt = k_begin; kt < k_end; kt += NAIVE_TILE_OUTPUTS) {
+            size_t kt_end = std::min(kt + NAIVE_TILE_OUTPUTS, k_end);
+            // Terms that contribute to this tile: i in [i_min(kt), i_max(kt_end - 1)]
+            size_t i_begin = kt >= m ? kt - m + 1 : 0;
+            size_t i_end = std::min(kt_end - 1, n - 1) + 1;
+            for (size_t it = i_begin; it < i_end; it += NAIVE_TILE_INPUTS)
+                kernel(a.data(), n, rb.data(), m, result.data(), kt, kt_end, it,
+                       std::min(it + NAIVE_TILE_INPUTS, i_end));
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (size_t t = 1; t + 1 < bounds.size(); ++t)
+        futures.push_back(std::async(std::launch::async, compute, bounds[t], bounds[t + 1]));
+    compute(bounds[0], bounds[1]);
+    for (auto& f : futures) f.get();  // Synchronize (no merge needed)
+    return result;
+}
+
 /**
  * Sequential Karatsuba recursive multiplication.
  *
@@ -156,81 +346,478 @@ static Poly multiply_karatsuba_seq(const Poly& a, const Poly& b) {
 }
 
 /**
- * Parallel Karatsuba recursive multiplication.
+ * Scratch elements needed by multiply_karatsuba_into for operands of n and m
+ * coefficients (mirrors its recursion; 0 for the naive base case).
+ *
+ * A balanced node needs a_sum and b_sum (half each) and P3 (2 * half - 1), and its
+ * three children run one after another on the space behind that. The total is
+ * 4n + 4n/2 + ... < 4n (n = m).
+ *
+ * @param n  Coefficients of the first operand
+ * @param m  Coefficients of the second operand
+ * @return   Scratch size in coefficients
+ */
+static size_t karatsuba_scratch_size(size_t n, size_t m) {
+    if (n <= 64 || m <= 64) return 0;
+    if (n < m) std::swap(n, m);
+    size_t half = (n + 1) / 2;
+
+    // Short operand fits in the low half: two products, one of them through scratch
+    if (m <= half)
+        return (n - half + m - 1) + std::max(karatsuba_scratch_size(half, m), karatsuba_scratch_size(n - half, m));
+
+    return 4 * half - 1 + std::max(karatsuba_scratch_size(half, half), karatsuba_scratch_size(n - half, m - half));
+}
+
+/**
+ * Allocation-free Karatsuba on views: out = a * b.
+ *
+ * Same algorithm as multiply_karatsuba_seq, but the operands are (pointer, length)
+ * views and nothing is copied or allocated:
+ * - P1 = A_low * B_low is written straight into out[0, 2 * half - 1)
+ * - P2 = A_high * B_high is written straight into out[2 * half, n + m - 1), which it fills exactly
+ * - a_sum, b_sum and P3 live at the front of `scratch`; the children reuse the
+ *   space behind them
+ * - P3 - P1 - P2 is then added into out[half, ...)
+ *
+ * The split point is half = ceil(max(n, m) / 2), so both sums have half coefficients. If
+ * the shorter operand fits in the low half (unbalanced operands), the node computes
+ * A_low * B and A_high * B instead and adds the overlapping second product from scratch.
+ *
+ * @param a        First operand (n coefficients)
+ * @param n        Coefficients of a
+ * @param b        Second operand (m coefficients)
+ * @param m        Coefficients of b
+ * @param out      Result (n + m - 1 coefficients, overwritten)
+ * @param scratch  At least karatsuba_scratch_size(n, m) coefficients
+ */
+static void multiply_karatsuba_into(const Coeff* a, size_t n, const Coeff* b, size_t m, Coeff* out, Coeff* scratch) {
+    // Base case: naive product written directly into out
+    if (n <= 64 || m <= 64) {
+        std::fill(out, out + n + m - 1, 0);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < m; ++j)
+                out[i + j] += a[i] * b[j];
+        return;
+    }
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    size_t half = (n + 1) / 2;
+
+    if (m <= half) {
+        // out = A_low * B + x^half * A_high * B
+        Coeff* high = scratch;
+        size_t high_size = n - half + m - 1;
+        multiply_karatsuba_into(a, half, b, m, out, scratch + high_size);
+        std::fill(out + half + m - 1, out + n + m - 1, 0);
+        multiply_karatsuba_into(a + half, n - half, b, m, high, scratch + high_size);
+        for (size_t i = 0; i < high_size; ++i) out[half + i] += high[i];
+        return;
+    }
+
+    // P1 and P2 straight into their places in out (out[2 * half - 1] belongs to neither)
+    multiply_karatsuba_into(a, half, b, half, out, scratch);
+    out[2 * half - 1] = 0;
+    multiply_karatsuba_into(a + half, n - half, b + half, m - half, out + 2 * half, scratch);
+
+    // Sums of the halves (the high halves are at most half long)
+    Coeff* a_sum = scratch;
+    Coeff* b_sum = a_sum + half;
+    Coeff* P3 = b_sum + half;
+    std::copy(a, a + half, a_sum);
+    std::copy(b, b + half, b_sum);
+    for (size_t i = 0; i < n - half; ++i) a_sum[i] += a[half + i];
+    for (size_t i = 0; i < m - half; ++i) b_sum[i] += b[half + i];
+
+    multiply_karatsuba_into(a_sum, half, b_sum, half, P3, P3 + 2 * half - 1);
+
+    // Cross term P3 - P1 - P2, added at x^half
+    size_t p2_size = n + m - 1 - 2 * half;
+    for (size_t i = 0; i < 2 * half - 1; ++i) P3[i] -= out[i];
+    for (size_t i = 0; i < p2_size; ++i) P3[i] -= out[2 * half + i];
+    for (size_t i = 0; i < 2 * half - 1; ++i) out[half + i] += P3[i];
+}
+
+/**
+ * Allocation-free sequential Karatsuba for Poly operands: one allocation for the
+ * result and one for the scratch arena, whatever the recursion depth.
+ *
+ * @param a  First polynomial coefficients
+ * @param b  Second polynomial coefficients
+ * @return   Resulting product coefficients
+ */
+static Poly multiply_karatsuba_inplace(const Poly& a, const Poly& b) {
+    if (a.empty() || b.empty()) return {};
+    Poly result(a.size() + b.size() - 1);
+    Poly scratch(karatsuba_scratch_size(a.size(), b.size()));
+    multiply_karatsuba_into(a.data(), a.size(), b.data(), b.size(), result.data(), scratch.data());
+    return result;
+}
+
+/**
+ * Fork-join Karatsuba on views: out = a * b.
  *
- * Forks recursive computations for the three sub-products — P1, P2, P3 — as async tasks,
- * then synchronizes with .get(). The depth parameter limits spawning depth (for safety).
+ * Same splitting as multiply_karatsuba_into, but at every node whose operands are at
+ * least KARATSUBA_TASK_CUTOFF long the three sub-products P1, P2 and P3 (or the two
+ * products of an unbalanced node) run as fork-join tasks on the work-stealing pool.
+ * Smaller nodes run multiply_karatsuba_into on a per-worker scratch buffer (leaves
+ * never fork, so one buffer per thread is enough and stays cache-hot); a forking node
+ * keeps a_sum, b_sum and P3 in one uninitialised block of its own.
  *
  * Parallelization rationale:
- * - Each subproduct is logically independent.
- * - No shared mutable state — pure function calls
- * - The merge step is thread-safe due to isolated result vectors
- *
- * @param a      First polynomial
- * @param b      Second polynomial
- * @param depth  Current recursion depth (limits parallelism depth)
- * @return       Product coefficients
+ * - P1 and P2 write disjoint ranges of out, P3 its own block: no shared writes
+ * - Every level above the cutoff forks, so the parallel slack is 3^levels tasks for any
+ *   worker count, while the pool keeps the thread count fixed
+ *
+ * @param a    First operand (n coefficients)
+ * @param n    Coefficients of a
+ * @param b    Second operand (m coefficients)
+ * @param m    Coefficients of b
+ * @param out  Result (n + m - 1 coefficients, overwritten)
  */
-static Poly multiply_karatsuba_par(const Poly& a, const Poly& b, int depth = 0) {
-    size_t n = a.size();
-    size_t m = b.size();
+static void multiply_karatsuba_fork_join(const Coeff* a, size_t n, const Coeff* b, size_t m, Coeff* out) {
+    if (n < KARATSUBA_TASK_CUTOFF || m < KARATSUBA_TASK_CUTOFF) {
+        thread_local Poly scratch;
+        size_t needed = karatsuba_scratch_size(n, m);
+        if (scratch.size() < needed) scratch.resize(needed);
+        multiply_karatsuba_into(a, n, b, m, out, scratch.data());
+        return;
+    }
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    size_t half = (n + 1) / 2;
 
-    // Cutoff for base case (avoid thread overload and maximize efficiency)
-    if (n <= 64 || m <= 64)
-        return multiply_naive_seq(a, b);
+    if (m <= half) {
+        // out = A_low * B + x^half * A_high * B, both products concurrently
+        size_t high_size = n - half + m - 1;
+        std::unique_ptr<Coeff[]> high(new Coeff[high_size]);
+        std::fill(out + half + m - 1, out + n + m - 1, 0);
+        fork_join([&] { multiply_karatsuba_fork_join(a, half, b, m, out); },
+                  [&] { multiply_karatsuba_fork_join(a + half, n - half, b, m, high.get()); });
+        for (size_t i = 0; i < high_size; ++i) out[half + i] += high[i];
+        return;
+    }
 
-    size_t half = n / 2;
-    Poly a_low(a.begin(), a.begin() + half);
-    Poly a_high(a.begin() + half, a.end());
-    Poly b_low(b.begin(), b.begin() + std::min(half, m));
-    Poly b_high(b.begin() + std::min(half, m), b.end());
+    std::unique_ptr<Coeff[]> block(new Coeff[4 * half - 1]);
+    Coeff* a_sum = block.get();
+    Coeff* b_sum = a_sum + half;
+    Coeff* P3 = b_sum + half;
+
+    std::copy(a, a + half, a_sum);
+    std::copy(b, b + half, b_sum);
+    for (size_t i = 0; i < n - half; ++i) a_sum[i] += a[half + i];
+    for (size_t i = 0; i < m - half; ++i) b_sum[i] += b[half + i];
+    out[2 * half - 1] = 0;
 
-    // For safety and performance, limit parallel recursion depth (otherwise thread exhaustion occurs)
-    std::future<Poly> futP1, futP2;
-    Poly P1, P2, P3;
+    fork_join([&] { multiply_karatsuba_fork_join(a_sum, half, b_sum, half, P3); },
+              [&] { multiply_karatsuba_fork_join(a, half, b, half, out); },
+              [&] { multiply_karatsuba_fork_join(a + half, n - half, b + half, m - half, out + 2 * half); });
 
-    if (depth < 3) {
-        futP1 = std::async(std::launch::async, multiply_karatsuba_par, a_low, b_low, depth + 1);
-        futP2 = std::async(std::launch::async, multiply_karatsuba_par, a_high, b_high, depth + 1);
+    // Cross term P3 - P1 - P2, added at x^half
+    size_t p2_size = n + m - 1 - 2 * half;
+    for (size_t i = 0; i < 2 * half - 1; ++i) P3[i] -= out[i];
+    for (size_t i = 0; i < p2_size; ++i) P3[i] -= out[2 * half + i];
+    for (size_t i = 0; i < 2 * half - 1; ++i) out[half + i] += P3[i];
+}
+
+/**
+ * Default work-stealing pool of the parallel variants (one worker per hardware thread),
+ * created on first use.
+ */
+static ForkJoinPool& default_fork_join_pool() {
+    static ForkJoinPool pool;
+    return pool;
+}
+
+/**
+ * Parallel Karatsuba multiplication on the work-stealing fork-join runtime.
+ *
+ * The whole recursion runs as one root task on `pool`; every node above
+ * KARATSUBA_TASK_CUTOFF forks its sub-products (multiply_karatsuba_fork_join).
+ *
+ * @param a     First polynomial
+ * @param b     Second polynomial
+ * @param pool  Work-stealing pool to run on
+ * @return      Product coefficients
+ */
+static Poly multiply_karatsuba_par(const Poly& a, const Poly& b, ForkJoinPool& pool) {
+    if (a.empty() || b.empty()) return {};
+    Poly result(a.size() + b.size() - 1);
+    pool.invoke([&] { multiply_karatsuba_fork_join(a.data(), a.size(), b.data(), b.size(), result.data()); });
+    return result;
+}
+
+static Poly multiply_karatsuba_par(const Poly& a, const Poly& b) {
+    return multiply_karatsuba_par(a, b, default_fork_join_pool());
+}
+
+
+///////////////////////////
+///  TOOM-COOK SECTION  ///
+///////////////////////////
+
+/**
+ * Size thresholds of the algorithm selector, compared against the shorter operand.
+ *
+ * - below toom3: Karatsuba (which itself is naive up to 64 coefficients)
+ * - toom3 .. toom4: Toom-3 levels
+ * - toom4 .. ntt: Toom-4 levels
+ * - ntt and above: NTT (multiply_auto only; never used inside a Toom recursion)
+ *
+ * The defaults were measured by tune_thresholds() on the development machine (single
+ * core, AVX2 NTT butterflies); a tuning run replaces them. SIZE_MAX disables a stage.
+ */
+struct AlgorithmThresholds {
+    size_t toom3 = 448;
+    size_t toom4 = 640;
+    size_t ntt = 192;
+};
+
+static AlgorithmThresholds g_thresholds;
+
+// Transform length bound of multiply_ntt with all three primes
+constexpr size_t NTT_MAX_PRODUCT = size_t(1) << 24;
+
+static void multiply_toom_into(const Coeff* a, size_t n, const Coeff* b, size_t m, Coeff* out, int max_order,
+                               int parallel_depth);
+
+/**
+ * Toom-3 interpolation (Bodrato's sequence) for one coefficient position.
+ *
+ * r holds the point products r(0), r(1), r(-1), r(-2), r(inf) and is overwritten with
+ * the coefficients c0..c4 of the degree-4 product. Both divisions are exact.
+ */
+static inline void toom3_interpolate(Coeff* r) {
+    Coeff r0 = r[0], r1 = r[1], rm1 = r[2], rm2 = r[3], rinf = r[4];
+    Coeff c3 = (rm2 - r1) / 3;
+    Coeff c1 = (r1 - rm1) / 2;
+    Coeff c2 = rm1 - r0;
+    c3 = (c2 - c3) / 2 + 2 * rinf;
+    c2 = c2 + c1 - rinf;
+    c1 = c1 - c3;
+    r[0] = r0;
+    r[1] = c1;
+    r[2] = c2;
+    r[3] = c3;
+    r[4] = rinf;
+}
+
+/**
+ * Toom-4 interpolation for one coefficient position.
+ *
+ * r holds the point products at 0, 1, -1, 2, -2, 3 and inf and is overwritten with the
+ * coefficients c0..c6. c6 = r(inf) is removed from the finite values, the remaining
+ * degree-5 polynomial is interpolated in Newton form (divided differences of an integer
+ * polynomial at integer nodes are integers, so every division is exact) and converted
+ * to monomial form.
+ */
+static inline void toom4_interpolate(Coeff* r) {
+    static constexpr Coeff x[6] = {0, 1, -1, 2, -2, 3};
+    const Coeff rinf = r[6];
+    for (int i = 0; i < 6; ++i) r[i] -= rinf * x[i] * x[i] * x[i] * x[i] * x[i] * x[i];
+
+    // Divided differences: r[i] = f[x_0, ..., x_i]
+    for (int j = 1; j < 6; ++j)
+        for (int i = 5; i >= j; --i)
+            r[i] = (r[i] - r[i - 1]) / (x[i] - x[i - j]);
+
+    // Newton to monomial: expand the nested products (x - x_i) from the inside out
+    for (int i = 4; i >= 0; --i)
+        for (int j = i; j < 5; ++j)
+            r[j] -= x[i] * r[j + 1];
+}
+
+/**
+ * One Toom-k level (k = 3 or 4) for balanced operands: out = a * b.
+ *
+ * Both operands are split into k parts of s = ceil(max(n, m) / k) coefficients (the
+ * top parts zero-padded), evaluated at 2k - 1 points (Toom-3: 0, 1, -1, -2, inf;
+ * Toom-4: 0, 1, -1, 2, -2, 3, inf), the point values multiplied pairwise, and the
+ * product coefficients interpolated exactly and added at x^(i * s).
+ *
+ * The 2k - 1 sub-products are independent. With parallel_depth > 0 all but the last
+ * run as async tasks (the caller computes the last one), each with parallel_depth - 1.
+ * They recurse through multiply_toom_into with max_order, so deeper levels fall
+ * through to Toom-3, Karatsuba and naive as the parts shrink.
+ *
+ * Evaluation at 3 weighs the parts by up to 1 + 3 + 9 + 27 = 40, so every Toom-4 level
+ * grows intermediate values by up to 40^2 (Toom-3: 7^2); the dispatcher only takes a
+ * level while toom_fits() bounds them within long long.
+ *
+ * @param k               Split count (3 or 4)
+ * @param a               First operand (n coefficients)
+ * @param n               Coefficients of a
+ * @param b               Second operand (m coefficients)
+ * @param m               Coefficients of b
+ * @param out             Result (n + m - 1 coefficients, overwritten)
+ * @param max_order       Highest Toom order allowed for the sub-products
+ * @param parallel_depth  Levels that still spawn tasks
+ */
+static void toom_level(int k, const Coeff* a, size_t n, const Coeff* b, size_t m, Coeff* out, int max_order,
+                       int parallel_depth) {
+    static constexpr Coeff points3[4] = {0, 1, -1, -2};
+    static constexpr Coeff points4[6] = {0, 1, -1, 2, -2, 3};
+    const Coeff* points = k == 3 ? points3 : points4;
+    const int count = 2 * k - 1;  // Finite points + infinity
+    const size_t s = (std::max(n, m) + k - 1) / k;
+
+    // Evaluate the operands: p(x) = Σ part_i x^i by Horner, p(inf) = top part
+    auto evaluate = [&](const Coeff* p, size_t len) {
+        std::vector<Poly> values(count, Poly(s, 0));
+        auto part = [&](int i, size_t t) { return i * s + t < len ? p[i * s + t] : 0; };
+        for (int v = 0; v < count - 1; ++v)
+            for (size_t t = 0; t < s; ++t) {
+                Coeff acc = part(k - 1, t);
+                for (int i = k - 2; i >= 0; --i) acc = acc * points[v] + part(i, t);
+                values[v][t] = acc;
+            }
+        for (size_t t = 0; t < s; ++t) values[count - 1][t] = part(k - 1, t);
+        return values;
+    };
+    std::vector<Poly> ea = evaluate(a, n), eb = evaluate(b, m);
+
+    // Pointwise products: 5 (Toom-3) or 7 (Toom-4) independent sub-problems
+    std::vector<Poly> products(count, Poly(2 * s - 1));
+    auto sub_product = [&](int v, int depth) {
+        multiply_toom_into(ea[v].data(), s, eb[v].data(), s, products[v].data(), max_order, depth);
+    };
+    if (parallel_depth > 0) {
+        std::vector<std::future<void>> tasks;
+        for (int v = 0; v < count - 1; ++v)
+            tasks.push_back(std::async(std::launch::async, sub_product, v, parallel_depth - 1));
+        sub_product(count - 1, parallel_depth - 1);
+        for (auto& task : tasks) task.get();  // Synchronize
     } else {
-        P1 = multiply_karatsuba_seq(a_low, b_low);
-        P2 = multiply_karatsuba_seq(a_high, b_high);
+        for (int v = 0; v < count; ++v) sub_product(v, 0);
     }
 
-    Poly a_sum(std::max(a_low.size(), a_high.size()), 0);
-    Poly b_sum(std::max(b_low.size(), b_high.size()), 0);
-    for (size_t i = 0; i < a_low.size(); ++i) a_sum[i] += a_low[i];
-    for (size_t i = 0; i < a_high.size(); ++i) a_sum[i] += a_high[i];
-    for (size_t i = 0; i < b_low.size(); ++i) b_sum[i] += b_low[i];
-    for (size_t i = 0; i < b_high.size(); ++i) b_sum[i] += b_high[i];
+    // Interpolate per coefficient position and add c_i at x^(i * s)
+    const size_t total = n + m - 1;
+    std::fill(out, out + total, 0);
+    Coeff r[7];
+    for (size_t t = 0; t < 2 * s - 1; ++t) {
+        for (int v = 0; v < count; ++v) r[v] = products[v][t];
+        if (k == 3) toom3_interpolate(r);
+        else toom4_interpolate(r);
+        for (int i = 0; i < count && i * s + t < total; ++i) out[i * s + t] += r[i];
+    }
+}
 
-    if (depth < 3) {
-        P3 = multiply_karatsuba_par(a_sum, b_sum, depth + 1);
-        P1 = futP1.get(); // Synchronize
-        P2 = futP2.get();
-    } else {
-        P3 = multiply_karatsuba_seq(a_sum, b_sum);
+/**
+ * Overflow guard for one Toom-k level on balanced operands.
+ *
+ * Evaluation multiplies the operands by up to W = 1 + 2 + 4 = 7 (Toom-3) or
+ * 1 + 3 + 9 + 27 = 40 (Toom-4), so a sub-product coefficient is bounded by
+ * s * W^2 * max|a| * max|b|. The level is taken only if that bound, times 2^16 of
+ * headroom for the interpolation intermediates and the Karatsuba sums further down,
+ * stays within long long; otherwise the dispatcher falls back to a lower order.
+ */
+static bool toom_fits(int k, const Coeff* a, size_t n, const Coeff* b, size_t m) {
+    auto max_abs = [](const Coeff* p, size_t len) {
+        Coeff best = 0;
+        for (size_t i = 0; i < len; ++i) best = std::max(best, p[i] < 0 ? -p[i] : p[i]);
+        return static_cast<double>(best);
+    };
+    const double weight = k == 3 ? 7.0 : 40.0;
+    const double s = static_cast<double>((std::max(n, m) + k - 1) / k);
+    return s * weight * weight * max_abs(a, n) * max_abs(b, m) * 65536.0 < 9.2e18;
+}
+
+/**
+ * Toom-Cook dispatcher on views: out = a * b, by the size of the shorter operand.
+ *
+ * Picks Toom-4 (if max_order >= 4), Toom-3 (if max_order >= 3) or Karatsuba by
+ * g_thresholds (and toom_fits); Karatsuba falls through to naive by itself. Operands differing by more
+ * than 2x are cut into chunks of the shorter length, which are multiplied as balanced
+ * products and accumulated, so every Toom level sees near-equal operands.
+ *
+ * @param a               First operand (n coefficients)
+ * @param n               Coefficients of a
+ * @param b               Second operand (m coefficients)
+ * @param m               Coefficients of b
+ * @param out             Result (n + m - 1 coefficients, overwritten)
+ * @param max_order       Highest Toom order to use (2: Karatsuba only)
+ * @param parallel_depth  Toom levels that evaluate their sub-products as tasks
+ */
+static void multiply_toom_into(const Coeff* a, size_t n, const Coeff* b, size_t m, Coeff* out, int max_order,
+                               int parallel_depth) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
     }
 
-    // Eliminate redundant terms for proper cross-coefficient calculation
-    for (size_t i = 0; i < P1.size(); ++i) P3[i] -= P1[i];
-    for (size_t i = 0; i < P2.size(); ++i) P3[i] -= P2[i];
+    // Unbalanced: out = Σ (chunk_i * b) x^(i * m), chunks of m coefficients
+    if (m * 2 <= n) {
+        std::fill(out, out + n + m - 1, 0);
+        Poly partial(2 * m - 1);
+        for (size_t offset = 0; offset < n; offset += m) {
+            size_t len = std::min(m, n - offset);
+            multiply_toom_into(a + offset, len, b, m, partial.data(), max_order, parallel_depth);
+            for (size_t i = 0; i < len + m - 1; ++i) out[offset + i] += partial[i];
+        }
+        return;
+    }
 
-    // Merge the three computed blocks into the final result
-    Poly result(n + m - 1, 0);
-    for (size_t i = 0; i < P1.size(); ++i) result[i] += P1[i];
-    for (size_t i = 0; i < P3.size(); ++i) result[i + half] += P3[i];
-    for (size_t i = 0; i < P2.size(); ++i) result[i + 2 * half] += P2[i];
+    if (max_order >= 4 && m >= g_thresholds.toom4 && toom_fits(4, a, n, b, m))
+        toom_level(4, a, n, b, m, out, max_order, parallel_depth);
+    else if (max_order >= 3 && m >= g_thresholds.toom3 && toom_fits(3, a, n, b, m))
+        toom_level(3, a, n, b, m, out, max_order, parallel_depth);
+    else {
+        Poly scratch(karatsuba_scratch_size(n, m));
+        multiply_karatsuba_into(a, n, b, m, out, scratch.data());
+    }
+}
+
+/**
+ * Toom-Cook multiplication for Poly operands.
+ *
+ * @param a               First polynomial coefficients
+ * @param b               Second polynomial coefficients
+ * @param max_order       Highest Toom order (3 or 4)
+ * @param parallel_depth  Toom levels whose sub-products run as async tasks
+ * @return                Resulting product coefficients
+ */
+static Poly multiply_toom(const Poly& a, const Poly& b, int max_order, int parallel_depth = 0) {
+    if (a.empty() || b.empty()) return {};
+    Poly result(a.size() + b.size() - 1);
+    multiply_toom_into(a.data(), a.size(), b.data(), b.size(), result.data(), max_order, parallel_depth);
     return result;
 }
 
+static Poly multiply_toom3_seq(const Poly& a, const Poly& b) { return multiply_toom(a, b, 3); }
+static Poly multiply_toom3_par(const Poly& a, const Poly& b) { return multiply_toom(a, b, 3, 1); }
+static Poly multiply_toom4_seq(const Poly& a, const Poly& b) { return multiply_toom(a, b, 4); }
+static Poly multiply_toom4_par(const Poly& a, const Poly& b) { return multiply_toom(a, b, 4, 1); }
+
+/**
+ * Automatic algorithm selection by the size of the shorter operand (g_thresholds):
+ * NTT from the ntt threshold on (as long as the product fits the transform length),
+ * otherwise the Toom-4 / Toom-3 / Karatsuba / naive cascade. With more than one
+ * hardware thread the top Toom level runs its sub-products as tasks.
+ *
+ * @param a  First polynomial coefficients
+ * @param b  Second polynomial coefficients
+ * @return   Resulting product coefficients
+ */
+static Poly multiply_auto(const Poly& a, const Poly& b) {
+    if (a.empty() || b.empty()) return {};
+    if (std::min(a.size(), b.size()) >= g_thresholds.ntt && a.size() + b.size() - 1 <= NTT_MAX_PRODUCT)
+        return multiply_ntt(a, b);
+    return multiply_toom(a, b, 4, std::thread::hardware_concurrency() > 1 ? 1 : 0);
+}
+
 
 ///////////////////////////
 /// BENCHMARKING SECTION///
 ///////////////////////////
 
 /**
- * Times and executes a multiplication strategy, printing key results and timing.
+ * Times and executes a multiplication strategy, printing key results, timing and the
+ * number of heap allocations made during the call.
  *
  * @param name      Human-readable label for the algorithm variant
  * @param fn        Polynomial multiplication callable: std::function<Poly(const Poly&, const Poly&)>
@@ -241,13 +828,16 @@ static void benchmark(const std::string& name,
                       const std::function<Poly(const Poly&, const Poly&)>& fn,
                       const Poly& A,
                       const Poly& B) {
+    size_t allocations = g_allocations.load();
     auto start = std::chrono::high_resolution_clock::now();
     Poly result = fn(A, B);
     auto end = std::chrono::high_resolution_clock::now();
     double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    allocations = g_allocations.load() - allocations;
 
     std::cout << std::left << std::setw(25) << name << " -> "
               << "Time: " << std::setw(10) << ms << "ms"
+              << " Allocs: " << std::setw(8) << allocations
               << " Result[0..4]: ";
 
     for (size_t i = 0; i < std::min<size_t>(5, result.size()); ++i)
@@ -255,6 +845,355 @@ static void benchmark(const std::string& name,
     std::cout << std::endl;
 }
 
+/**
+ * Naive multiplication: sequential, per-thread buffers + merge, and output-partitioned
+ * (best of 3), with the extra memory of the two parallel variants: T full-size local
+ * results versus one reversed copy of b.
+ */
+static void compare_naive_output_par() {
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::pair<size_t, size_t>> shapes = {
+        {1 << 10, 1 << 10}, {1 << 12, 1 << 12}, {1 << 14, 1 << 14}, {1 << 16, 1 << 16}, {1 << 16, 1000}};
+
+    std::cout << "\nNaive: per-thread buffers vs output-partitioned (" << threads << " threads, best of 3)\n";
+    std::cout << std::right << std::setw(8) << "n" << std::setw(8) << "m" << std::setw(12) << "Seq ms"
+              << std::setw(12) << "Par ms" << std::setw(12) << "Out ms" << std::setw(10) << "vs Par" << std::setw(12)
+              << "Par MiB" << std::setw(10) << "Out MiB" << std::setw(8) << "Match" << "\n";
+
+    for (auto [n, m] : shapes) {
+        Poly A(n), B(m);
+        for (size_t i = 0; i < n; ++i) A[i] = (i * 7) % 10 + 1;
+        for (size_t i = 0; i < m; ++i) B[i] = (i * 3) % 5 + 2;
+
+        auto measure = [&](const std::function<Poly(const Poly&, const Poly&)>& fn, Poly& result) {
+            double best = 1e30;
+            for (int rep = 0; rep < 3; ++rep) {
+                auto start = std::chrono::high_resolution_clock::now();
+                result = fn(A, B);
+                auto end = std::chrono::high_resolution_clock::now();
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+            return best;
+        };
+
+        Poly seq, par, out;
+        double seq_ms = measure(multiply_naive_seq, seq);
+        double par_ms = measure(multiply_naive_par, par);
+        double out_ms = measure([](const Poly& a, const Poly& b) { return multiply_naive_output_par(a, b); }, out);
+
+        const double mib = 1.0 / (1 << 20);
+        std::cout << std::setw(8) << n << std::setw(8) << m << std::fixed << std::setprecision(3) << std::setw(12)
+                  << seq_ms << std::setw(12) << par_ms << std::setw(12) << out_ms << std::setprecision(2)
+                  << std::setw(9) << par_ms / out_ms << "x" << std::setw(12)
+                  << threads * (n + m - 1) * sizeof(Coeff) * mib << std::setw(10) << m * sizeof(Coeff) * mib
+                  << std::setw(8) << (seq == par && seq == out ? "yes" : "NO") << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Compares the allocating and the allocation-free sequential Karatsuba over a range of
+ * sizes: best-of-3 time, heap allocations per call and result equality. Includes an
+ * odd size and an unbalanced pair, which exercise the uneven splits.
+ */
+static void compare_karatsuba_inplace() {
+    std::vector<std::pair<size_t, size_t>> shapes = {
+        {1 << 10, 1 << 10}, {1 << 12, 1 << 12}, {1 << 14, 1 << 14}, {1 << 16, 1 << 16},
+        {1 << 18, 1 << 18}, {100001, 100001}, {1 << 16, 3000}};
+
+    std::cout << "\nKaratsuba: allocating vs allocation-free (best of 3)\n";
+    std::cout << std::right << std::setw(8) << "n" << std::setw(8) << "m" << std::setw(14) << "Seq ms"
+              << std::setw(12) << "Allocs" << std::setw(14) << "In-place ms" << std::setw(10) << "Allocs"
+              << std::setw(10) << "Speedup" << std::setw(8) << "Match" << "\n";
+
+    for (auto [n, m] : shapes) {
+        Poly A(n), B(m);
+        for (size_t i = 0; i < n; ++i) A[i] = (i * 7) % 10 + 1;
+        for (size_t i = 0; i < m; ++i) B[i] = (i * 3) % 5 + 2;
+
+        auto measure = [&](Poly (*fn)(const Poly&, const Poly&), Poly& result, size_t& allocations) {
+            double best = 1e30;
+            for (int rep = 0; rep < 3; ++rep) {
+                size_t before = g_allocations.load();
+                auto start = std::chrono::high_resolution_clock::now();
+                result = fn(A, B);
+                auto end = std::chrono::high_resolution_clock::now();
+                allocations = g_allocations.load() - before;
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+            return best;
+        };
+
+        Poly seq, inplace;
+        size_t seq_allocs = 0, inplace_allocs = 0;
+        double seq_ms = measure(multiply_karatsuba_seq, seq, seq_allocs);
+        double inplace_ms = measure(multiply_karatsuba_inplace, inplace, inplace_allocs);
+
+        std::cout << std::setw(8) << n << std::setw(8) << m << std::fixed << std::setprecision(3)
+                  << std::setw(14) << seq_ms << std::setw(12) << seq_allocs << std::setw(14) << inplace_ms
+                  << std::setw(10) << inplace_allocs << std::setprecision(2) << std::setw(9) << seq_ms / inplace_ms
+                  << "x" << std::setw(8) << (seq == inplace ? "yes" : "NO") << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Crossover measurements: naive, Karatsuba and NTT (1 worker and all workers) over
+ * sizes 2^5 .. 2^20, best of 3. Naive stops at 2^15 and Karatsuba at 2^19, where they
+ * take seconds. Every result is checked against the Karatsuba product (or, where
+ * Karatsuba is skipped, against the parallel NTT matching the sequential one).
+ */
+static void compare_ntt_crossover() {
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "\nNTT crossover (" << ntt_kernel_name() << " butterflies, " << threads
+              << " workers, best of 3, ms)\n";
+    std::cout << std::right << std::setw(9) << "n" << std::setw(12) << "Naive" << std::setw(12) << "Karatsuba"
+              << std::setw(12) << "NTT x1" << std::setw(12) << ("NTT x" + std::to_string(threads))
+              << std::setw(9) << "Primes" << std::setw(8) << "Match" << "\n";
+
+    for (int log = 5; log <= 20; ++log) {
+        const size_t n = size_t(1) << log;
+        Poly A(n), B(n);
+        for (size_t i = 0; i < n; ++i) {
+            A[i] = (i * 7) % 10 + 1;
+            B[i] = (i * 3) % 5 + 2;
+        }
+
+        auto measure = [&](const std::function<Poly(const Poly&, const Poly&)>& fn, Poly& result) {
+            double best = 1e30;
+            for (int rep = 0; rep < 3; ++rep) {
+                auto start = std::chrono::high_resolution_clock::now();
+                result = fn(A, B);
+                auto end = std::chrono::high_resolution_clock::now();
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+            return best;
+        };
+
+        Poly naive, karatsuba, ntt1, nttP;
+        double naive_ms = log <= 15 ? measure(multiply_naive_seq, naive) : -1;
+        double karatsuba_ms = log <= 19 ? measure(multiply_karatsuba_inplace, karatsuba) : -1;
+        double ntt1_ms = measure([](const Poly& a, const Poly& b) { return multiply_ntt(a, b, 1); }, ntt1);
+        double nttP_ms = measure([](const Poly& a, const Poly& b) { return multiply_ntt(a, b); }, nttP);
+
+        bool match = ntt1 == nttP && (karatsuba.empty() || ntt1 == karatsuba) && (naive.empty() || ntt1 == naive);
+        auto cell = [](double ms) {
+            std::ostringstream out;
+            if (ms < 0) out << "-";
+            else out << std::fixed << std::setprecision(3) << ms;
+            return out.str();
+        };
+        std::cout << std::setw(9) << n << std::setw(12) << cell(naive_ms) << std::setw(12) << cell(karatsuba_ms)
+                  << std::setw(12) << cell(ntt1_ms) << std::setw(12) << cell(nttP_ms) << std::setw(9)
+                  << ntt_prime_count(A, B) << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+
+    // Larger coefficients need more primes (and CRT work): n = 2^16, |coefficients| <= R
+    std::cout << "\nNTT x1 by coefficient range (n = 65536, signed coefficients)\n";
+    std::cout << std::setw(14) << "Range" << std::setw(9) << "Primes" << std::setw(12) << "NTT ms" << std::setw(8)
+              << "Match" << "\n";
+    for (long long range : {10LL, 1000000LL, 1000000000LL}) {
+        const size_t n = 1 << 16;
+        Poly A(n), B(n);
+        for (size_t i = 0; i < n; ++i) {
+            A[i] = static_cast<long long>((i * 2654435761u) % (2 * range + 1)) - range;
+            B[i] = static_cast<long long>((i * 40503u + 17) % (2 * range + 1)) - range;
+        }
+        Poly ntt;
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto start = std::chrono::high_resolution_clock::now();
+            ntt = multiply_ntt(A, B, 1);
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        std::cout << std::setw(14) << range << std::setw(9) << ntt_prime_count(A, B) << std::setw(12) << std::fixed
+                  << std::setprecision(3) << best << std::setw(8)
+                  << (ntt == multiply_karatsuba_inplace(A, B) ? "yes" : "NO") << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Strong scaling of the fork-join Karatsuba: n = 2^17, pools of 1 .. 64 workers, best of
+ * 3. Prints time, speedup and efficiency against the 1-worker pool, speedup against the
+ * sequential in-place Karatsuba, and the steals per product (load balancing traffic).
+ */
+static void measure_karatsuba_scaling() {
+    const size_t n = 1 << 17;
+    Poly A(n), B(n);
+    for (size_t i = 0; i < n; ++i) {
+        A[i] = (i * 7) % 10 + 1;
+        B[i] = (i * 3) % 5 + 2;
+    }
+
+    auto best_of_3 = [](auto&& fn) {
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    };
+
+    Poly reference;
+    double seq_ms = best_of_3([&] { reference = multiply_karatsuba_inplace(A, B); });
+
+    std::cout << "\nFork-join Karatsuba scaling (n = " << n << ", cutoff " << KARATSUBA_TASK_CUTOFF
+              << ", hardware threads " << std::thread::hardware_concurrency() << ", best of 3)\n";
+    std::cout << "Sequential in-place: " << std::fixed << std::setprecision(3) << seq_ms << " ms\n";
+    std::cout << std::right << std::setw(8) << "Workers" << std::setw(12) << "Time ms" << std::setw(10) << "Speedup"
+              << std::setw(12) << "Efficiency" << std::setw(10) << "vs Seq" << std::setw(10) << "Steals"
+              << std::setw(8) << "Match" << "\n";
+
+    double one_worker_ms = 0;
+    for (size_t workers : {1, 2, 4, 8, 16, 32, 64}) {
+        ForkJoinPool pool(workers);
+        Poly result;
+        uint64_t steals = pool.steals();
+        double ms = best_of_3([&] { result = multiply_karatsuba_par(A, B, pool); });
+        steals = (pool.steals() - steals) / 3;
+        if (workers == 1) one_worker_ms = ms;
+
+        std::cout << std::setw(8) << workers << std::setw(12) << ms << std::setprecision(2) << std::setw(9)
+                  << one_worker_ms / ms << "x" << std::setw(11) << 100.0 * one_worker_ms / ms / workers << "%"
+                  << std::setw(9) << seq_ms / ms << "x" << std::setw(10) << steals << std::setw(8)
+                  << (result == reference ? "yes" : "NO") << std::setprecision(3) << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Best time per call of fn() in milliseconds: calls are repeated until at least 2 ms
+ * have passed (so microsecond-sized products are measured over many calls), best of 3.
+ */
+template <typename Fn>
+static double time_per_call(Fn&& fn) {
+    double best = 1e30;
+    for (int rep = 0; rep < 3; ++rep) {
+        size_t calls = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        double elapsed = 0;
+        do {
+            fn();
+            ++calls;
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start)
+                          .count();
+        } while (elapsed < 2.0);
+        best = std::min(best, elapsed / calls);
+    }
+    return best;
+}
+
+/**
+ * Tuning run for the algorithm selector; stores the measured thresholds in
+ * g_thresholds and returns them.
+ *
+ * Each stage compares, over sizes (1, 1.25, 1.5, 1.75) * 2^k, the current best
+ * cascade against one level of the next algorithm on top of it (single-threaded):
+ * - toom3: Karatsuba vs one Toom-3 level over Karatsuba
+ * - toom4: cascade up to Toom-3 vs one Toom-4 level over that cascade
+ * - ntt:   cascade up to Toom-4 vs the NTT with one worker
+ * The threshold is the first size from which the candidate wins at two consecutive
+ * sizes (one win can be noise); SIZE_MAX if it never does.
+ */
+static AlgorithmThresholds tune_thresholds() {
+    std::vector<size_t> sizes;
+    for (size_t base = 32; base <= (1 << 14); base *= 2)
+        for (size_t step : {4, 5, 6, 7}) sizes.push_back(base * step / 4);
+
+    auto crossover = [&](size_t from, auto&& baseline, auto&& candidate, const char* label) {
+        std::cout << "  " << std::left << std::setw(30) << label << std::right;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (sizes[i] < from) continue;
+            bool wins = true;
+            double base_ms = 0, cand_ms = 0;
+            for (size_t j = i; j < std::min(i + 2, sizes.size()) && wins; ++j) {
+                Poly A(sizes[j]), B(sizes[j]);
+                for (size_t t = 0; t < sizes[j]; ++t) {
+                    A[t] = (t * 7) % 10 + 1;
+                    B[t] = (t * 3) % 5 + 2;
+                }
+                double b_ms = time_per_call([&] { return baseline(A, B); });
+                double c_ms = time_per_call([&] { return candidate(A, B); });
+                if (j == i) base_ms = b_ms, cand_ms = c_ms;
+                wins = c_ms < b_ms;
+            }
+            if (wins) {
+                std::cout << " from n = " << std::setw(6) << sizes[i] << std::fixed << std::setprecision(4) << "  ("
+                          << base_ms << " vs " << cand_ms << " ms)\n";
+                std::cout.unsetf(std::ios::floatfield);
+                return sizes[i];
+            }
+        }
+        std::cout << " never (up to n = " << sizes.back() << ")\n";
+        return SIZE_MAX;
+    };
+    auto level = [](int k, int max_order) {
+        return [k, max_order](const Poly& a, const Poly& b) {
+            Poly result(a.size() + b.size() - 1);
+            toom_level(k, a.data(), a.size(), b.data(), b.size(), result.data(), max_order, 0);
+            return result;
+        };
+    };
+    auto cascade = [](int max_order) {
+        return [max_order](const Poly& a, const Poly& b) { return multiply_toom(a, b, max_order); };
+    };
+
+    std::cout << "\nTuning the algorithm selector (1 worker, time per call)\n";
+    AlgorithmThresholds tuned;
+    tuned.toom3 = crossover(96, cascade(2), level(3, 2), "Toom-3 beats Karatsuba");
+    g_thresholds.toom3 = tuned.toom3;
+    tuned.toom4 = crossover(std::min<size_t>(tuned.toom3, 1 << 14), cascade(3), level(4, 3),
+                            "Toom-4 beats Toom-3 cascade");
+    g_thresholds.toom4 = tuned.toom4;
+    tuned.ntt = crossover(32, cascade(4), [](const Poly& a, const Poly& b) { return multiply_ntt(a, b, 1); },
+                          "NTT beats Toom cascade");
+    g_thresholds = tuned;
+    return tuned;
+}
+
+/**
+ * Karatsuba, the Toom-3 and Toom-4 cascades (current thresholds), NTT and the
+ * automatic selector side by side over sizes 2^8 .. 2^18 (single-threaded except Auto,
+ * time per call), all checked against Karatsuba.
+ */
+static void compare_toom_cook() {
+    std::cout << "\nToom-Cook vs Karatsuba and NTT (thresholds: Toom-3 " << g_thresholds.toom3 << ", Toom-4 "
+              << g_thresholds.toom4 << ", NTT " << g_thresholds.ntt << ")\n";
+    std::cout << std::right << std::setw(9) << "n" << std::setw(12) << "Karatsuba" << std::setw(12) << "Toom-3"
+              << std::setw(12) << "Toom-4" << std::setw(12) << "NTT" << std::setw(12) << "Auto" << std::setw(8)
+              << "Match" << "\n";
+
+    for (int log = 8; log <= 18; ++log) {
+        const size_t n = size_t(1) << log;
+        Poly A(n), B(n);
+        for (size_t i = 0; i < n; ++i) {
+            A[i] = (i * 7) % 10 + 1;
+            B[i] = (i * 3) % 5 + 2;
+        }
+
+        Poly karatsuba, toom3, toom4, ntt, automatic;
+        auto measure = [&](auto&& fn, Poly& result) {
+            return time_per_call([&] { result = fn(A, B); });
+        };
+        double karatsuba_ms = measure(multiply_karatsuba_inplace, karatsuba);
+        double toom3_ms = measure(multiply_toom3_seq, toom3);
+        double toom4_ms = measure(multiply_toom4_seq, toom4);
+        double ntt_ms = measure([](const Poly& a, const Poly& b) { return multiply_ntt(a, b, 1); }, ntt);
+        double auto_ms = measure(multiply_auto, automatic);
+
+        bool match = toom3 == karatsuba && toom4 == karatsuba && ntt == karatsuba && automatic == karatsuba;
+        std::cout << std::setw(9) << n << std::fixed << std::setprecision(3) << std::setw(12) << karatsuba_ms
+                  << std::setw(12) << toom3_ms << std::setw(12) << toom4_ms << std::setw(12) << ntt_ms
+                  << std::setw(12) << auto_ms << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
 ///////////////////////////
 ///   MAIN SECTION      ///
 ///////////////////////////
@@ -262,15 +1201,22 @@ static void benchmark(const std::string& name,
 /**
  * Main entry point for polynomial multiplication benchmark.
  *
- * Generates two random polynomials and multiplies them using all four strategies,
- * then prints out performance and result diagnostics.
+ * Tunes the algorithm selector's thresholds (tune_thresholds), generates two
+ * polynomials and multiplies them with every variant, then runs the comparison
+ * experiments.
  *
  * Configurable parameters:
  * - n : degree of polynomial (number of coefficients)
  *
  * Results:
- * - Benchmarks sequential and parallel versions, both naive and Karatsuba
- * - Verifies output correctness by printing partial result and total sums
+ * - Benchmarks 13 variants: naive (sequential, per-thread buffers, output-partitioned),
+ *   Karatsuba (sequential, in-place, fork-join), NTT (one and all workers), Toom-3 and
+ *   Toom-4 (sequential and parallel) and the automatic selector
+ * - Prints time, heap allocations and the first coefficients of each product (the
+ *   comparison experiments check their results)
+ * - Comparisons: naive parallel variants, allocating vs in-place Karatsuba, fork-join
+ *   Karatsuba strong scaling, naive / Karatsuba / NTT crossover, Toom-Cook vs NTT vs
+ *   the selector
  */
 int main() {
     const size_t n = 1 << 16;
@@ -285,10 +1231,29 @@ int main() {
     std::cout << "POLYNOMIAL MULTIPLICATION BENCHMARK\n";
     std::cout << "========================================\n";
 
+    tune_thresholds();
+    std::cout << "\n";
+
     benchmark("Naive Sequential", multiply_naive_seq, A, B);
     benchmark("Naive Parallel", multiply_naive_par, A, B);
+    benchmark("Naive Output-Partitioned", [](const Poly& a, const Poly& b) { return multiply_naive_output_par(a, b); },
+              A, B);
     benchmark("Karatsuba Sequential", multiply_karatsuba_seq, A, B);
-    benchmark("Karatsuba Parallel",[](const Poly& a, const Poly& b) { return multiply_karatsuba_par(a, b, 0); },A, B);
+    benchmark("Karatsuba In-Place", multiply_karatsuba_inplace, A, B);
+    benchmark("Karatsuba Parallel", [](const Poly& a, const Poly& b) { return multiply_karatsuba_par(a, b); }, A, B);
+    benchmark("NTT Sequential", [](const Poly& a, const Poly& b) { return multiply_ntt(a, b, 1); }, A, B);
+    benchmark("NTT Parallel", [](const Poly& a, const Poly& b) { return multiply_ntt(a, b); }, A, B);
+    benchmark("Toom-3 Sequential", multiply_toom3_seq, A, B);
+    benchmark("Toom-3 Parallel", multiply_toom3_par, A, B);
+    benchmark("Toom-4 Sequential", multiply_toom4_seq, A, B);
+    benchmark("Toom-4 Parallel", multiply_toom4_par, A, B);
+    benchmark("Auto (selector)", multiply_auto, A, B);
+
+    compare_naive_output_par();
+    compare_karatsuba_inplace();
+    measure_karatsuba_scaling();
+    compare_ntt_crossover();
+    compare_toom_cook();
 
     std::cout << "========================================\n";
     std::cout << "All tests completed\n";
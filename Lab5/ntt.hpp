@@ -0,0 +1,517 @@
+#pragma once
+
+/////////////////////
+///    IMPORTS    ///
+/////////////////////
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NTT_X86 1
+#endif
+
+/////////////////////
+/// DOCUMENTATION ///
+/////////////////////
+/**
+ * Number-theoretic transform (NTT) polynomial multiplication, O(n log n).
+ *
+ * A product of length L = n + m - 1 is a cyclic convolution of length N = 2^k >= L.
+ * Modulo a prime p with 2^k | p - 1 it is computed exactly as
+ *   C = INTT(NTT(A) . NTT(B))
+ * with the FFT structure over Z_p instead of the complex numbers (no rounding).
+ *
+ * - Primes: 2013265921 = 15 * 2^27 + 1, 469762049 = 7 * 2^26 + 1 and
+ *   754974721 = 45 * 2^24 + 1 (all < 2^31). The driver uses as few as the coefficient
+ *   bound allows (max|a| * max|b| * min(n, m) < P / 2 for the product P of the primes
+ *   used) and reconstructs every coefficient with Garner's CRT, centred into
+ *   (-P/2, P/2) in 64-bit arithmetic (the sign is decided on the mixed-radix digits, so
+ *   no compiler-specific 128-bit type is needed). With all three primes P ~ 7.1e26, so any product whose coefficients
+ *   fit in long long is recovered exactly. Transform length is limited to 2^24 by the
+ *   third prime (2^27 while one prime suffices).
+ * - Arithmetic: 32-bit Montgomery multiplication (R = 2^32). Data stays in normal form,
+ *   twiddles are stored in Montgomery form, so mont_mul(x, w) = x * w directly; the
+ *   pointwise product and the 1/N scaling are folded into one Montgomery factor.
+ * - Transforms: forward is decimation-in-frequency (natural order in, bit-reversed
+ *   out), inverse is decimation-in-time (bit-reversed in, natural out), so no
+ *   bit-reversal permutation is ever done. Radix-2 butterflies; a transform recurses
+ *   on its two halves after (DIF) or before (DIT) its own stage, so sub-transforms of
+ *   NTT_SERIAL_BLOCK fit in cache and run all their stages iteratively there.
+ * - Twiddles: for each prime and size a table roots[len + j] = w_{2len}^j (len =
+ *   1, 2, 4, ..., N/2), plus the inverse roots, built once and cached.
+ * - SIMD: AVX2 butterflies on 8 lanes (Montgomery via _mm256_mul_epu32 on even / odd
+ *   lanes) for stages with len >= 8, selected at run time; scalar otherwise.
+ * - Parallelism: the prime transforms are independent tasks; inside a transform the
+ *   butterflies of a large stage are split across workers and the two halves recurse
+ *   as parallel tasks, down to NTT_PARALLEL_MIN. CRT reconstruction is split by
+ *   coefficient range.
+ */
+
+/////////////////////
+///   CONSTANTS   ///
+/////////////////////
+// Sub-transforms up to this size run all their stages iteratively (fits in L2)
+constexpr size_t NTT_SERIAL_BLOCK = size_t(1) << 12;
+
+// Smallest sub-transform that is still split across workers
+constexpr size_t NTT_PARALLEL_MIN = size_t(1) << 15;
+
+/////////////////////
+///  MONTGOMERY   ///
+/////////////////////
+/**
+ * Montgomery arithmetic modulo an odd prime p < 2^31 with R = 2^32.
+ */
+struct Montgomery {
+    uint32_t p;
+    uint32_t n_prime;  // -p^-1 mod 2^32
+    uint32_t r2;       // R^2 mod p
+
+    explicit Montgomery(uint32_t mod) : p(mod) {
+        uint32_t inv = p;  // Newton iteration: inv = p^-1 mod 2^32
+        for (int i = 0; i < 5; ++i) inv *= 2 - p * inv;
+        n_prime = ~inv + 1;
+        const uint64_t r = (uint64_t(1) << 32) % p;  // R mod p; R^2 mod p without 128-bit integers
+        r2 = static_cast<uint32_t>(r * r % p);
+    }
+
+    /** t * R^-1 mod p for t < p * 2^32. */
+    uint32_t reduce(uint64_t t) const {
+        uint32_t m = static_cast<uint32_t>(t) * n_prime;
+        uint32_t r = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * p) >> 32);
+        return r >= p ? r - p : r;
+    }
+
+    uint32_t mul(uint32_t a, uint32_t b) const { return reduce(static_cast<uint64_t>(a) * b); }
+    uint32_t to_mont(uint32_t a) const { return mul(a, r2); }
+    uint32_t add(uint32_t a, uint32_t b) const { uint32_t t = a + b; return t >= p ? t - p : t; }
+    uint32_t sub(uint32_t a, uint32_t b) const { return a >= b ? a - b : a + p - b; }
+
+    /** base^e mod p (normal form in and out). */
+    uint32_t pow(uint32_t base, uint64_t e) const {
+        uint32_t result = to_mont(1), b = to_mont(base);
+        for (; e > 0; e >>= 1, b = mul(b, b)) {
+            if (e & 1) result = mul(result, b);
+        }
+        return reduce(result);
+    }
+};
+
+/**
+ * NttPrime: one NTT prime with its twiddle tables, cached per transform size.
+ */
+class NttPrime {
+public:
+    NttPrime(uint32_t p, uint32_t generator, int max_log) : mont(p), generator_(generator), max_log_(max_log) {}
+
+    const Montgomery mont;
+
+    int max_log() const { return max_log_; }
+
+    /**
+     * Twiddle tables for transforms of size 2^log (built on first use; immutable
+     * afterwards, so the pointers stay valid and may be shared by threads).
+     * roots[len + j] = w_{2len}^j and inverse[len + j] = w_{2len}^-j in Montgomery form.
+     */
+    std::pair<const uint32_t*, const uint32_t*> tables(int log) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (tables_.size() <= static_cast<size_t>(log)) tables_.resize(log + 1);
+        if (!tables_[log]) {
+            auto table = std::make_unique<Tables>();
+            const size_t n = size_t(1) << log;
+            table->roots.assign(std::max<size_t>(n, 2), 0);
+            table->inverse.assign(std::max<size_t>(n, 2), 0);
+            for (size_t len = 1; len < n; len <<= 1) {
+                // Primitive 2len-th root of unity and its inverse
+                uint32_t w = mont.pow(generator_, (mont.p - 1) / (2 * len));
+                uint32_t wi = mont.pow(w, mont.p - 2);
+                uint32_t wm = mont.to_mont(w), wim = mont.to_mont(wi);
+                uint32_t cur = mont.to_mont(1), cur_i = cur;
+                for (size_t j = 0; j < len; ++j) {
+                    table->roots[len + j] = cur;
+                    table->inverse[len + j] = cur_i;
+                    cur = mont.mul(cur, wm);
+                    cur_i = mont.mul(cur_i, wim);
+                }
+            }
+            tables_[log] = std::move(table);
+        }
+        return {tables_[log]->roots.data(), tables_[log]->inverse.data()};
+    }
+
+private:
+    struct Tables {
+        std::vector<uint32_t> roots;
+        std::vector<uint32_t> inverse;
+    };
+
+    uint32_t generator_;
+    int max_log_;
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<Tables>> tables_;
+};
+
+/** The three NTT primes, largest 2-adic order first. */
+static NttPrime* ntt_primes() {
+    static NttPrime primes[3] = {{2013265921u, 31, 27}, {469762049u, 3, 26}, {754974721u, 11, 24}};
+    return primes;
+}
+
+/////////////////////
+///    KERNELS    ///
+/////////////////////
+/**
+ * NttKernels: butterfly routines of one instruction set.
+ * - dif_range / dit_range: butterflies j in [j0, j1) of one block of 2 * len
+ * - dif_block / dit_block: every stage of a whole transform of size n, iteratively
+ * - pointwise: x[i] = x[i] * y[i] * s (Montgomery, s = scale in Montgomery form)
+ */
+struct NttKernels {
+    void (*dif_range)(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1);
+    void (*dit_range)(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1);
+    void (*dif_block)(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* roots);
+    void (*dit_block)(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* inverse);
+    void (*pointwise)(const Montgomery& m, uint32_t* x, const uint32_t* y, size_t n, uint32_t s);
+};
+
+static void ntt_dif_range_scalar(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1) {
+    for (size_t j = j0; j < j1; ++j) {
+        uint32_t u = x[j], v = x[j + len];
+        x[j] = m.add(u, v);
+        x[j + len] = m.mul(m.sub(u, v), w[j]);
+    }
+}
+
+static void ntt_dit_range_scalar(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1) {
+    for (size_t j = j0; j < j1; ++j) {
+        uint32_t u = x[j], v = m.mul(x[j + len], w[j]);
+        x[j] = m.add(u, v);
+        x[j + len] = m.sub(u, v);
+    }
+}
+
+static void ntt_dif_block_scalar(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* roots) {
+    for (size_t len = n / 2; len >= 1; len >>= 1) {
+        for (size_t b = 0; b < n; b += 2 * len) ntt_dif_range_scalar(m, x + b, len, roots + len, 0, len);
+    }
+}
+
+static void ntt_dit_block_scalar(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* inverse) {
+    for (size_t len = 1; len < n; len <<= 1) {
+        for (size_t b = 0; b < n; b += 2 * len) ntt_dit_range_scalar(m, x + b, len, inverse + len, 0, len);
+    }
+}
+
+static void ntt_pointwise_scalar(const Montgomery& m, uint32_t* x, const uint32_t* y, size_t n, uint32_t s) {
+    for (size_t i = 0; i < n; ++i) x[i] = m.mul(m.mul(x[i], y[i]), s);
+}
+
+#if NTT_X86
+#define NTT_AVX2_TARGET "avx2"
+#define NTT_AVX2_OP __attribute__((target(NTT_AVX2_TARGET), always_inline)) static inline
+
+/**
+ * Eight-lane modular operations (p < 2^31, operands in [0, p)).
+ * mul: Montgomery product of the even lanes and of the odd lanes (shifted down) with
+ * _mm256_mul_epu32; the odd results already sit in the high halves, so one blend
+ * joins them.
+ */
+struct NttAvx2 {
+    NTT_AVX2_OP __m256i add(__m256i a, __m256i b, __m256i p) {
+        __m256i t = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(t, _mm256_sub_epi32(t, p));
+    }
+
+    NTT_AVX2_OP __m256i sub(__m256i a, __m256i b, __m256i p) {
+        __m256i t = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(t, _mm256_add_epi32(t, p));
+    }
+
+    NTT_AVX2_OP __m256i mul(__m256i a, __m256i b, __m256i p, __m256i n_prime) {
+        __m256i prod_even = _mm256_mul_epu32(a, b);
+        __m256i prod_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i m_even = _mm256_mul_epu32(prod_even, n_prime);
+        __m256i m_odd = _mm256_mul_epu32(prod_odd, n_prime);
+        __m256i t_even = _mm256_srli_epi64(_mm256_add_epi64(prod_even, _mm256_mul_epu32(m_even, p)), 32);
+        __m256i t_odd = _mm256_add_epi64(prod_odd, _mm256_mul_epu32(m_odd, p));
+        __m256i t = _mm256_blend_epi32(t_even, t_odd, 0xAA);
+        return _mm256_min_epu32(t, _mm256_sub_epi32(t, p));
+    }
+};
+
+__attribute__((target(NTT_AVX2_TARGET)))
+static void ntt_dif_range_avx2(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1) {
+    if (len < 8) return ntt_dif_range_scalar(m, x, len, w, j0, j1);
+    const __m256i p = _mm256_set1_epi32(static_cast<int>(m.p));
+    const __m256i np = _mm256_set1_epi32(static_cast<int>(m.n_prime));
+    for (size_t j = j0; j < j1; j += 8) {
+        __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j + len));
+        __m256i wj = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), NttAvx2::add(u, v, p));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + len), NttAvx2::mul(NttAvx2::sub(u, v, p), wj, p, np));
+    }
+}
+
+__attribute__((target(NTT_AVX2_TARGET)))
+static void ntt_dit_range_avx2(const Montgomery& m, uint32_t* x, size_t len, const uint32_t* w, size_t j0, size_t j1) {
+    if (len < 8) return ntt_dit_range_scalar(m, x, len, w, j0, j1);
+    const __m256i p = _mm256_set1_epi32(static_cast<int>(m.p));
+    const __m256i np = _mm256_set1_epi32(static_cast<int>(m.n_prime));
+    for (size_t j = j0; j < j1; j += 8) {
+        __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j));
+        __m256i wj = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j));
+        __m256i v = NttAvx2::mul(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + j + len)), wj, p, np);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j), NttAvx2::add(u, v, p));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + j + len), NttAvx2::sub(u, v, p));
+    }
+}
+
+__attribute__((target(NTT_AVX2_TARGET)))
+static void ntt_dif_block_avx2(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* roots) {
+    for (size_t len = n / 2; len >= 1; len >>= 1) {
+        for (size_t b = 0; b < n; b += 2 * len) ntt_dif_range_avx2(m, x + b, len, roots + len, 0, len);
+    }
+}
+
+__attribute__((target(NTT_AVX2_TARGET)))
+static void ntt_dit_block_avx2(const Montgomery& m, uint32_t* x, size_t n, const uint32_t* inverse) {
+    for (size_t len = 1; len < n; len <<= 1) {
+        for (size_t b = 0; b < n; b += 2 * len) ntt_dit_range_avx2(m, x + b, len, inverse + len, 0, len);
+    }
+}
+
+__attribute__((target(NTT_AVX2_TARGET)))
+static void ntt_pointwise_avx2(const Montgomery& m, uint32_t* x, const uint32_t* y, size_t n, uint32_t s) {
+    const __m256i p = _mm256_set1_epi32(static_cast<int>(m.p));
+    const __m256i np = _mm256_set1_epi32(static_cast<int>(m.n_prime));
+    const __m256i sv = _mm256_set1_epi32(static_cast<int>(s));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i), NttAvx2::mul(NttAvx2::mul(a, b, p, np), sv, p, np));
+    }
+    ntt_pointwise_scalar(m, x + i, y + i, n - i, s);
+}
+
+#undef NTT_AVX2_OP
+#endif
+
+/**
+ * Butterfly routines for this CPU: AVX2 if available, else scalar. Detected once.
+ */
+static const NttKernels& select_ntt_kernels() {
+    static const NttKernels kernels = []() -> NttKernels {
+#if NTT_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return {ntt_dif_range_avx2, ntt_dit_range_avx2, ntt_dif_block_avx2, ntt_dit_block_avx2,
+                    ntt_pointwise_avx2};
+        }
+#endif
+        return {ntt_dif_range_scalar, ntt_dit_range_scalar, ntt_dif_block_scalar, ntt_dit_block_scalar,
+                ntt_pointwise_scalar};
+    }();
+    return kernels;
+}
+
+/**
+ * Instruction set of select_ntt_kernels() (for reports).
+ */
+static const char* ntt_kernel_name() {
+    return select_ntt_kernels().pointwise == ntt_pointwise_scalar ? "scalar" : "AVX2";
+}
+
+/////////////////////
+///  TRANSFORMS   ///
+/////////////////////
+/**
+ * Runs fn(begin, end) on `threads` contiguous parts of [0, count) (the caller takes
+ * the last part).
+ */
+template <typename Fn>
+static void ntt_parallel_ranges(size_t count, int threads, Fn&& fn) {
+    std::vector<std::future<void>> parts;
+    for (int t = 0; t + 1 < threads; ++t) {
+        size_t begin = count * t / threads, end = count * (t + 1) / threads;
+        parts.push_back(std::async(std::launch::async, [&fn, begin, end] { fn(begin, end); }));
+    }
+    fn(count * (threads - 1) / threads, count);
+    for (auto& part : parts) part.get();
+}
+
+/**
+ * Forward transform (DIF) of x[0, n), natural order in, bit-reversed order out.
+ *
+ * @param threads  Workers for this sub-transform (1: sequential)
+ */
+static void ntt_forward(const NttKernels& k, const Montgomery& m, uint32_t* x, size_t n, const uint32_t* roots,
+                        int threads) {
+    if (n <= NTT_SERIAL_BLOCK) return k.dif_block(m, x, n, roots);
+
+    const size_t len = n / 2;
+    if (threads > 1 && n >= NTT_PARALLEL_MIN) {
+        ntt_parallel_ranges(len / 8, threads, [&](size_t b, size_t e) { k.dif_range(m, x, len, roots + len, b * 8, e * 8); });
+        auto left = std::async(std::launch::async, [&] { ntt_forward(k, m, x, len, roots, threads / 2); });
+        ntt_forward(k, m, x + len, len, roots, threads - threads / 2);
+        left.get();
+    } else {
+        k.dif_range(m, x, len, roots + len, 0, len);
+        ntt_forward(k, m, x, len, roots, 1);
+        ntt_forward(k, m, x + len, len, roots, 1);
+    }
+}
+
+/**
+ * Inverse transform (DIT, without the 1/n scaling) of x[0, n), bit-reversed order in,
+ * natural order out.
+ */
+static void ntt_inverse(const NttKernels& k, const Montgomery& m, uint32_t* x, size_t n, const uint32_t* inverse,
+                        int threads) {
+    if (n <= NTT_SERIAL_BLOCK) return k.dit_block(m, x, n, inverse);
+
+    const size_t len = n / 2;
+    if (threads > 1 && n >= NTT_PARALLEL_MIN) {
+        auto left = std::async(std::launch::async, [&] { ntt_inverse(k, m, x, len, inverse, threads / 2); });
+        ntt_inverse(k, m, x + len, len, inverse, threads - threads / 2);
+        left.get();
+        ntt_parallel_ranges(len / 8, threads, [&](size_t b, size_t e) { k.dit_range(m, x, len, inverse + len, b * 8, e * 8); });
+    } else {
+        ntt_inverse(k, m, x, len, inverse, 1);
+        ntt_inverse(k, m, x + len, len, inverse, 1);
+        k.dit_range(m, x, len, inverse + len, 0, len);
+    }
+}
+
+/////////////////////
+///    DRIVER     ///
+/////////////////////
+/**
+ * Number of NTT primes needed for an exact product: the smallest count whose prime
+ * product P satisfies max|a| * max|b| * min(n, m) < P / 2 (3 at most).
+ */
+static int ntt_prime_count(const std::vector<long long>& a, const std::vector<long long>& b) {
+    auto max_abs = [](const std::vector<long long>& v) {
+        long double mx = 0;
+        for (long long c : v) mx = std::max(mx, std::fabs(static_cast<long double>(c)));
+        return mx;
+    };
+    const long double bound = max_abs(a) * max_abs(b) * static_cast<long double>(std::min(a.size(), b.size()));
+    long double product = 1;
+    for (int count = 1; count <= 3; ++count) {
+        product *= ntt_primes()[count - 1].mont.p;
+        if (2 * bound < product) return count;
+    }
+    return 3;
+}
+
+/**
+ * NTT polynomial product: exact C = A x B for long long coefficients.
+ *
+ * @param a        First polynomial coefficients
+ * @param b        Second polynomial coefficients
+ * @param threads  Workers (0: hardware concurrency; 1: sequential)
+ * @return         Product coefficients (n + m - 1)
+ * @throws std::length_error if the transform would exceed the primes' 2^k limit
+ */
+static std::vector<long long> multiply_ntt(const std::vector<long long>& a, const std::vector<long long>& b,
+                                           int threads = 0) {
+    if (a.empty() || b.empty()) return {};
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t length = a.size() + b.size() - 1;
+    int log = 0;
+    while ((size_t(1) << log) < length) ++log;
+    const size_t n = size_t(1) << log;
+
+    const int count = ntt_prime_count(a, b);
+    NttPrime* primes = ntt_primes();
+    for (int i = 0; i < count; ++i) {
+        if (log > primes[i].max_log()) throw std::length_error("multiply_ntt: product too long for the NTT primes");
+    }
+
+    const NttKernels& k = select_ntt_kernels();
+    std::vector<std::vector<uint32_t>> residues(count);
+
+    // One task per prime; the workers are shared out among the primes
+    auto transform = [&](int i, int workers) {
+        NttPrime& prime = primes[i];
+        const Montgomery& m = prime.mont;
+        auto [roots, inverse] = prime.tables(log);
+
+        std::vector<uint32_t> fa(n, 0), fb(n, 0);
+        auto reduce = [&](const std::vector<long long>& src, std::vector<uint32_t>& dst) {
+            for (size_t j = 0; j < src.size(); ++j) {
+                long long r = src[j] % static_cast<long long>(m.p);
+                dst[j] = static_cast<uint32_t>(r < 0 ? r + m.p : r);
+            }
+        };
+        reduce(a, fa);
+        reduce(b, fb);
+
+        if (workers > 1) {
+            auto fwd = std::async(std::launch::async, [&] { ntt_forward(k, m, fa.data(), n, roots, workers / 2); });
+            ntt_forward(k, m, fb.data(), n, roots, workers - workers / 2);
+            fwd.get();
+        } else {
+            ntt_forward(k, m, fa.data(), n, roots, 1);
+            ntt_forward(k, m, fb.data(), n, roots, 1);
+        }
+
+        // (a * b) R^-1 * s R^-1 = a * b / n  for s = n^-1 R^2
+        uint32_t n_inv = m.pow(static_cast<uint32_t>(n % m.p), m.p - 2);
+        uint32_t scale = m.mul(m.mul(n_inv, m.r2), m.r2);
+        k.pointwise(m, fa.data(), fb.data(), n, scale);
+        ntt_inverse(k, m, fa.data(), n, inverse, workers);
+
+        fa.resize(length);
+        residues[i] = std::move(fa);
+    };
+
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i + 1 < count; ++i) {
+        const int workers = std::max(1, threads / count);
+        tasks.push_back(std::async(std::launch::async, transform, i, workers));
+    }
+    transform(count - 1, std::max(1, threads - (count - 1) * (threads / count)));
+    for (auto& task : tasks) task.get();
+
+    // Garner CRT, centred: x = r1 + p1 * t2 + p1 * p2 * t3
+    std::vector<long long> result(length);
+    const uint64_t p1 = primes[0].mont.p, p2 = primes[1].mont.p, p3 = primes[2].mont.p;
+    const uint64_t inv_p1_p2 = primes[1].mont.pow(static_cast<uint32_t>(p1 % p2), p2 - 2);
+    const uint64_t p1p2 = p1 * p2;
+    const uint64_t inv_p1p2_p3 = primes[2].mont.pow(static_cast<uint32_t>(p1p2 % p3), p3 - 2);
+    const uint64_t p123 = p1p2 * p3;  // P mod 2^64 (the centred result fits in 64 bits)
+
+    ntt_parallel_ranges(length, std::min<int>(threads, static_cast<int>(length / 4096) + 1), [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            uint64_t r1 = residues[0][j];
+            if (count == 1) {
+                result[j] = r1 > p1 / 2 ? static_cast<long long>(r1) - static_cast<long long>(p1) : static_cast<long long>(r1);
+                continue;
+            }
+            uint64_t t2 = (residues[1][j] + p2 - r1 % p2) % p2 * inv_p1_p2 % p2;
+            uint64_t x12 = r1 + p1 * t2;
+            if (count == 2) {
+                result[j] = x12 > p1p2 / 2 ? static_cast<long long>(x12 - p1p2) : static_cast<long long>(x12);
+                continue;
+            }
+            uint64_t t3 = (residues[2][j] + p3 - x12 % p3) % p3 * inv_p1p2_p3 % p3;
+            // x = x12 + p1p2 * t3 and P exceed 64 bits: compare x > P / 2 on the mixed-radix
+            // digits (p3 odd), then compute x or x - P modulo 2^64
+            const bool upper = 2 * t3 + 1 > p3 || (2 * t3 + 1 == p3 && 2 * x12 > p1p2);
+            result[j] = static_cast<long long>(x12 + p1p2 * t3 - (upper ? p123 : 0));
+        }
+    });
+    return result;
+}
@@ -10,6 +10,8 @@
 #include <thread>
 #include <vector>
 
+#include "../Lab5/fork_join.hpp"
+
 
 ///////////////////////////
 ///   TYPEDEFS SECTION  ///
@@ -135,6 +137,100 @@ public:
     }
 };
 
+/**
+ * Hamiltonian cycle search on the work-stealing fork-join runtime (Lab5/fork_join.hpp).
+ *
+ * Instead of dividing a fixed thread budget between the branches, every branch in the
+ * top splitDepth levels of the search tree becomes a fork-join task; deeper levels
+ * backtrack sequentially in place. The pool's workers balance the irregular subtrees
+ * by stealing, so a branch that dies early frees its worker for the rest of the tree.
+ */
+class HamiltonianForkJoinSolver
+{
+public:
+    const Graph graph;             // Input directed graph
+    const int N;                   // Number of vertices in the graph
+    std::atomic<bool> found;       // Indicates if a solution has been found
+    std::mutex solution_mtx;       // Guards access to the solution path
+    Path solution;                 // Stores the solution cycle if found
+
+    /**
+     * Construct the solver with the input graph.
+     * @param g Graph represented as adjacency list.
+     */
+    explicit HamiltonianForkJoinSolver(Graph g): graph(std::move(g)), N(graph.size()), found(false){}
+
+    /** Entry point: runs the search as one root task on the pool.
+     * @param pool        Work-stealing pool to run on
+     * @param startVertex Which vertex to start the cycle from (typically 0)
+     * @param splitDepth  Search tree levels whose branches are forked as tasks
+     */
+    void solve(ForkJoinPool& pool, int startVertex = 0, int splitDepth = 8)
+    {
+        Path visited;  visited.push_back(startVertex);
+        std::vector<bool> used(N, false);
+        used[startVertex] = true;
+        pool.invoke([&] { search(visited, used, startVertex, splitDepth); });
+    }
+
+    /**
+     * Recursive fork-join backtracking search.
+     *
+     * While splitDepth > 0 each unused neighbor is explored by its own task on a copy
+     * of the path; afterwards the search continues sequentially on the caller's copy.
+     *
+     * @param path       Current path being explored
+     * @param used       Boolean vector marking used nodes
+     * @param current    Current node being visited
+     * @param splitDepth Remaining levels that fork
+     */
+    void search(Path& path, std::vector<bool>& used, int current, int splitDepth)
+    {
+        if (found) return;
+
+        // Check if all nodes are visited and can close a cycle
+        if (path.size() == static_cast<size_t>(N)) {
+            for (int neighbor : graph[current]) {
+                if (neighbor == path.front() && !found.exchange(true)) {
+                    std::lock_guard<std::mutex> lk(solution_mtx);
+                    solution = path;
+                    solution.push_back(path.front());
+                    return;
+                }
+            }
+            return;
+        }
+
+        // Get all unused neighbors
+        std::vector<int> nexts;
+        for (int neighbor : graph[current]) {
+            if (!used[neighbor]) nexts.push_back(neighbor);
+        }
+
+        if (splitDepth > 0 && nexts.size() > 1) {
+            // One task per branch, each on its own copy of the search state
+            fork_join_range(nexts.size(), [&](size_t i) {
+                if (found) return;
+                Path pathCopy = path;
+                pathCopy.push_back(nexts[i]);
+                std::vector<bool> usedCopy = used;
+                usedCopy[nexts[i]] = true;
+                search(pathCopy, usedCopy, nexts[i], splitDepth - 1);
+            });
+        } else {
+            // Sequential backtracking in place
+            for (int neighbor : nexts) {
+                if (found) return;
+                path.push_back(neighbor);
+                used[neighbor] = true;
+                search(path, used, neighbor, splitDepth - 1);
+                used[neighbor] = false;
+                path.pop_back();
+            }
+        }
+    }
+};
+
 ///////////////////////////
 ///   MAIN SECTION      ///
 ///////////////////////////
@@ -209,23 +305,43 @@ int main()
             }
     };
 
+    auto report = [](const char* label, bool found, const Path& solution, double ms) {
+        std::cout << "[" << label << "] ";
+        if (found) {
+            std::cout << "Hamiltonian cycle found: ";
+            for (int v : solution) std::cout << v << " ";
+            std::cout << "\n";
+        } else {
+            std::cout << "No Hamiltonian cycle found.\n";
+        }
+        std::cout << "[" << label << "] Execution time: " << ms << " ms\n";
+    };
+
     for (const auto& test : tests) {
         std::cout << "\n===== Test: " << test.name << " =====\n";
         auto start = std::chrono::high_resolution_clock::now();
         HamiltonianSolver solver(test.graph);
         solver.solve(numThreads, 0);
         auto end = std::chrono::high_resolution_clock::now();
-        double ms = std::chrono::duration<double, std::milli>(end - start).count();
-
-        if (solver.found) {
+        {
             std::lock_guard<std::mutex> lk(solver.solution_mtx);
-            std::cout << "Hamiltonian cycle found: ";
-            for (int v : solver.solution) std::cout << v << " ";
-            std::cout << "\n";
-        } else {
-            std::cout << "No Hamiltonian cycle found.\n";
+            report("Thread split", solver.found, solver.solution,
+                   std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        // The pool exists only around the fork-join run, so its idle workers never
+        // compete with the thread-split solver above
+        {
+            ForkJoinPool pool(numThreads);
+            start = std::chrono::high_resolution_clock::now();
+            HamiltonianForkJoinSolver forkJoinSolver(test.graph);
+            forkJoinSolver.solve(pool, 0);
+            end = std::chrono::high_resolution_clock::now();
+
+            std::lock_guard<std::mutex> lk(forkJoinSolver.solution_mtx);
+            report("Work stealing", forkJoinSolver.found, forkJoinSolver.solution,
+                   std::chrono::duration<double, std::milli>(end - start).count());
         }
-        std::cout << "Execution time: " << ms << " ms\n";
     }
     return 0;
 }